@@ -5,54 +5,349 @@
  Platform: GNU/Linux (Arch/WSL) on x86_64
  ===============================================================================
  Features:
- - Dynamic storage of matrices (Starts at 2, Grows to Max 10)
- - Matrix creation with ID (A-Z)
+ - Dynamic storage of matrices (Starts at 2, grows without limit)
+ - Contiguous, 64-byte aligned row-major storage with padded row stride
+ - Named matrices, entered by hand or filled with random values
+ - Binary save/load (header + contiguous rows); loaded files are
+   memory-mapped copy-on-write instead of being read into the heap
  - Matrix Addition, Multiplication, Transposition
- - Determinant calculation (Recursive)
+ - Cache-blocked GEMM with packed panels and an AVX2/FMA micro-kernel
+   (scalar fallback selected at runtime)
+ - GFLOP/s benchmark against the naive triple loop
+ - Tiled transpose (out-of-place and in-place for square matrices) with an
+   AVX 4x4 tile kernel, plus a GB/s benchmark
+ - Sparse matrices: COO for building, CSR for compute, with SpMV,
+   sparse x dense, sparse x sparse, transpose and dense conversion
+ - Lazy element-wise expressions ("X = 2*A + B - C"): add/subtract/scale
+   chains are fused into one pass, accumulating in place when X is an
+   operand
+ - Persistent pthread worker pool for multiply, add and transpose, with a
+   thread-count setting and a scaling benchmark
+ - Blocked LU decomposition with partial pivoting: determinant, inverse and
+   linear system solve in O(n^3)
  - Dimension validation and error handling
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
 
 #define TRUE 1
 #define FALSE 0
+#define MATRIX_ALIGNMENT 64
+#define STRIDE_MULTIPLE (MATRIX_ALIGNMENT / (int)sizeof(double))
 #define INITIAL_CAPACITY 2
-#define MAX_CAPACITY 10
+#define MAX_NAME_LEN 32
+#define MAX_PATH_LEN 256
+#define PRINT_LIMIT 12
+#define MATRIX_MAGIC "DENSEMAT"
+#define MATRIX_VERSION 1
+#define IO_BUFFER_SIZE (1 << 20)
+#define MAX_FILE_ELEMENTS (1LL << 36)
+#define MAX_EXPR_LEN 256
+#define MAX_EXPR_NODES 64
+#define MAX_EXPR_TERMS 16
+#define EXPR_BLOCK 512
+#define DEFAULT_EXPR_SIZE 4096
+#define EXPR_BENCH_OPERANDS 4
+#define EXPR_TOLERANCE 1e-12
 #define MIN_OPTION 1
-#define MAX_OPTION 7
+#define MAX_OPTION 22
+#define MAX_THREADS 64
+#define ROW_GRAIN 16
+// A sparse row is a few multiply-adds, so SpMV tasks take many rows
+#define SPMV_GRAIN 256
+#define SPGEMM_CHECK_ROWS 16
+#define DEFAULT_SCALING_SIZE 2048
+#define LU_BLOCK 64
+// 64 right-hand-side columns are 512 bytes of each row: whole cache
+// lines, so solve tasks never write to the same line
+#define LU_SOLVE_GRAIN 64
+#define TRANSPOSE_TILE 32
+#define DEFAULT_TRANSPOSE_MAX_SIZE 4096
+#define INITIAL_COO_CAPACITY 64
+#define SPARSE_PRINT_LIMIT 40
+#define DEFAULT_SPARSE_SIZE 4096
+#define SPARSE_BENCH_RHS 64
+#define DEFAULT_LU_MAX_SIZE 2000
+
+// GEMM blocking: MR x NR register tile, KC x NR panels of B stay in L1,
+// MC x KC blocks of A in L2 and KC x NC panels of B in L3.
+#define GEMM_MR 6
+#define GEMM_NR 8
+#define GEMM_MC 120
+#define GEMM_KC 256
+#define GEMM_NC 4096
+#define BENCH_MIN_SIZE 64
+#define DEFAULT_BENCH_MAX_SIZE 4096
+#define NAIVE_BENCH_LIMIT 1024
 
 typedef enum {
   SUCCESS,
   ERR_INVALID_INPUT,
   ERR_INVALID_OPTION,
   ERR_MEMORY_ALLOCATION,
-  ERR_SYSTEM_FULL,
   ERR_MATRIX_NOT_FOUND,
   ERR_DUPLICATE_ID,
   ERR_INCOMPATIBLE_DIM,
-  ERR_NOT_SQUARE
+  ERR_NOT_SQUARE,
+  ERR_THREAD_CREATION,
+  ERR_SINGULAR,
+  ERR_FILE_NOT_FOUND,
+  ERR_FILE_IO,
+  ERR_INVALID_FORMAT
 } Status;
 
+/*
+ * One aligned block per matrix: element (i, j) lives at
+ * data[i * stride + j]. The stride is cols rounded up to a full cache
+ * line, so every row starts on an aligned boundary. Matrices loaded
+ * from a file point into `mapping` instead of owning a heap block.
+ */
 typedef struct {
-  char id;
+  char name[MAX_NAME_LEN];
   int rows;
   int cols;
-  double **data;
+  int stride;
+  double *data;
+  void *mapping;
+  size_t mapping_size;
 } Matrix;
 
+#define MAT_AT(m, i, j) ((m)->data[(size_t)(i) * (m)->stride + (j)])
+#define MAT_ROW(m, i) ((m)->data + (size_t)(i) * (m)->stride)
+
 typedef struct {
   Matrix *list;
   int count;
   int capacity;
 } MatrixSystem;
 
+/*
+ * On-disk layout: this 64-byte header, then rows * stride doubles
+ * starting at data_offset. The padding keeps row 0 cache-line aligned
+ * when the file is mapped, so a mapping is usable as-is.
+ */
+typedef struct {
+  char magic[8];
+  unsigned int version;
+  unsigned int flags;
+  long long rows;
+  long long cols;
+  long long stride;
+  long long data_offset;
+  char reserved[16];
+} MatrixFileHeader;
+
 typedef struct {
   Status status;
   double value;
 } Result;
 
+/*
+ * C[MR x NR] += A_panel * B_panel over kc steps, where the A panel is
+ * packed as kc columns of MR values and the B panel as kc rows of NR.
+ */
+typedef void (*MicroKernel)(int kc, const double *a, const double *b,
+                            double *c, int ldc);
+
+// 4x4 transpose of a block: dst[j][i] = src[i][j]
+typedef void (*TransposeKernel)(const double *src, int lds, double *dst,
+                                int ldd);
+
+// Swaps block a with the transpose of block b (a == b is allowed)
+typedef void (*SwapKernel)(double *a, double *b, int ld);
+
+// Processes task indices [begin, end) on behalf of worker `worker`
+typedef void (*TaskFn)(void *ctx, int worker, int begin, int end);
+
+/*
+ * Helpers sleep on `start` between jobs. parallel_for publishes a job,
+ * bumps `generation`, then works on it from the calling thread (worker
+ * 0) while helpers claim grain-sized chunks through the atomic `next`.
+ */
+typedef struct WorkerPool WorkerPool;
+
+typedef struct {
+  WorkerPool *pool;
+  int id;
+} PoolWorker;
+
+struct WorkerPool {
+  pthread_t threads[MAX_THREADS];
+  PoolWorker workers[MAX_THREADS];
+  int num_threads;
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long generation;
+  int busy;
+  int shutdown;
+
+  TaskFn fn;
+  void *ctx;
+  int total;
+  int grain;
+  int next;
+};
+
+typedef struct {
+  const Matrix *a;
+  const Matrix *b;
+  Matrix *c;
+  double *packed_a;
+  double *packed_b;
+  int jc, nc;
+  int pc, kc;
+} GemmJob;
+
+typedef struct {
+  const Matrix *a;
+  const Matrix *b;
+  Matrix *c;
+} AddJob;
+
+typedef struct {
+  const Matrix *src;
+  Matrix *dest;
+} TransposeJob;
+
+typedef struct {
+  Matrix *m;
+} InPlaceJob;
+
+/*
+ * PA = LU packed into one matrix: the strict lower triangle holds L
+ * (unit diagonal implied) and the upper triangle holds U. Row i was
+ * swapped with pivots[i] at step i.
+ */
+typedef struct {
+  Matrix lu;
+  int *pivots;
+  int sign;
+  int singular;
+} LuFactor;
+
+typedef struct {
+  const LuFactor *f;
+  Matrix *x;
+} LuSolveJob;
+
+typedef struct {
+  int row;
+  int col;
+  double value;
+} Triplet;
+
+// Coordinate list: unordered, duplicates allowed (they are summed)
+typedef struct {
+  int rows;
+  int cols;
+  long long nnz;
+  long long capacity;
+  Triplet *entries;
+} CooMatrix;
+
+/*
+ * Compressed sparse rows: the entries of row i are
+ * col_idx/values[row_ptr[i] .. row_ptr[i + 1]), sorted by column.
+ */
+typedef struct {
+  int rows;
+  int cols;
+  long long nnz;
+  long long *row_ptr;
+  int *col_idx;
+  double *values;
+} CsrMatrix;
+
+typedef struct {
+  const CsrMatrix *a;
+  const double *x;
+  double *y;
+} SpmvJob;
+
+typedef struct {
+  const CsrMatrix *a;
+  const Matrix *b;
+  Matrix *c;
+} SpmmDenseJob;
+
+// Gustavson row-by-row product with a dense accumulator per worker
+typedef struct {
+  const CsrMatrix *a;
+  const CsrMatrix *b;
+  CsrMatrix *c;
+  int *marker;
+  double *acc;
+} SpgemmJob;
+
+typedef enum {
+  EXPR_MATRIX,
+  EXPR_CONST,
+  EXPR_ADD,
+  EXPR_SUB,
+  EXPR_SCALE
+} ExprKind;
+
+/*
+ * Expression tree stored in a fixed arena; children are node indices.
+ * Building it does no arithmetic: evaluation first flattens the tree
+ * into a linear combination sum(coef_k * M_k), then makes one pass.
+ */
+typedef struct {
+  ExprKind kind;
+  const Matrix *mat;
+  double value;
+  int left;
+  int right;
+} ExprNode;
+
+typedef struct {
+  ExprNode nodes[MAX_EXPR_NODES];
+  int count;
+} Expr;
+
+typedef struct {
+  const Matrix *mat;
+  double coef;
+} ExprTerm;
+
+typedef struct {
+  ExprTerm terms[MAX_EXPR_TERMS];
+  int count;
+  int rows;
+  int cols;
+} LinearCombination;
+
+typedef struct {
+  const LinearCombination *lc;
+  Matrix *dest;
+} ExprEvalJob;
+
+typedef struct {
+  const char *text;
+  int pos;
+  Expr *expr;
+  const MatrixSystem *sys;
+  Status status;
+} ExprParser;
+
 void show_menu(void);
 void handle_error(Status status);
 void print_matrix(const Matrix *mat);
@@ -64,24 +359,148 @@ void run_multiply_matrices(MatrixSystem *sys);
 void run_transpose_matrix(MatrixSystem *sys);
 void run_determinant(MatrixSystem *sys);
 void run_show_matrix(MatrixSystem *sys);
+void run_gemm_benchmark(void);
+void run_set_threads(void);
+void run_scaling_benchmark(void);
+void run_inverse(MatrixSystem *sys);
+void run_solve(MatrixSystem *sys);
+void run_lu_benchmark(void);
+void run_transpose_in_place(MatrixSystem *sys);
+void run_transpose_benchmark(void);
+void run_show_sparse(MatrixSystem *sys);
+void run_sparse_benchmark(void);
+void run_create_random_matrix(MatrixSystem *sys);
+void run_save_matrix(MatrixSystem *sys);
+void run_load_matrix(MatrixSystem *sys);
+void run_evaluate_expression(MatrixSystem *sys);
+void run_expression_benchmark(void);
+int read_max_threads(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_double(double *value);
-Status read_char(char *value);
+Status read_string(char *buffer, int max_len);
+Status read_name(char *name);
+void read_path(const char *prompt, const char *fallback, char *path);
 
 Status init_system(MatrixSystem *sys);
 Status resize_system(MatrixSystem *sys);
 void free_system(MatrixSystem *sys);
-Status create_matrix(MatrixSystem *sys, char id, int rows, int cols);
+Status create_matrix(MatrixSystem *sys, const char *name, int rows,
+                     int cols);
+Status register_matrix(MatrixSystem *sys, const char *name, Matrix *mat);
+Status alloc_matrix(Matrix *mat, int rows, int cols);
 void free_matrix_data(Matrix *mat);
-int find_matrix_index(const MatrixSystem *sys, char id);
-Status get_matrix_by_id(const MatrixSystem *sys, char id, Matrix **mat);
+int find_matrix_index(const MatrixSystem *sys, const char *name);
+Status get_matrix_by_name(const MatrixSystem *sys, const char *name,
+                          Matrix **mat);
+Status save_matrix_file(const Matrix *mat, const char *path);
+Status map_matrix_file(Matrix *mat, const char *path);
 Status add_matrices(const Matrix *a, const Matrix *b, Matrix *result);
 Status multiply_matrices(const Matrix *a, const Matrix *b, Matrix *result);
 Status transpose_matrix(const Matrix *src, Matrix *dest);
-Result calculate_determinant(double **data, int n);
-void get_cofactor(double **data, double **temp, int p, int q, int n);
+Result calculate_determinant(const Matrix *mat);
+Status invert_matrix(const Matrix *a, Matrix *inverse);
+Status solve_linear_system(const Matrix *a, const Matrix *b, Matrix *x);
+
+Status lu_decompose(const Matrix *a, LuFactor *f);
+void lu_free(LuFactor *f);
+void lu_factor_panel(LuFactor *f, int k, int nb);
+Status lu_solve(const LuFactor *f, const Matrix *b, Matrix *x);
+void lu_solve_task(void *ctx, int worker, int begin, int end);
+void swap_rows(Matrix *m, int r1, int r2);
+Matrix submatrix_view(const Matrix *m, int row, int col, int rows, int cols);
+
+Status coo_init(CooMatrix *coo, int rows, int cols);
+Status coo_push(CooMatrix *coo, int row, int col, double value);
+void coo_free(CooMatrix *coo);
+Status csr_alloc(CsrMatrix *csr, int rows, int cols, long long nnz);
+void csr_free(CsrMatrix *csr);
+Status csr_from_coo(const CooMatrix *coo, CsrMatrix *csr);
+Status csr_from_dense(const Matrix *mat, CsrMatrix *csr);
+Status csr_to_dense(const CsrMatrix *csr, Matrix *mat);
+Status csr_transpose(const CsrMatrix *a, CsrMatrix *t);
+Status csr_spmv(const CsrMatrix *a, const double *x, double *y);
+Status csr_multiply_dense(const CsrMatrix *a, const Matrix *b, Matrix *c);
+Status csr_multiply_csr(const CsrMatrix *a, const CsrMatrix *b,
+                        CsrMatrix *c);
+size_t csr_bytes(const CsrMatrix *csr);
+Status csr_multiply_transpose(const CsrMatrix *a, CsrMatrix *c);
+void dense_gemv(const Matrix *m, const double *x, double *y);
+double spgemm_sample_diff(const CsrMatrix *product, const Matrix *dense);
+void spmv_task(void *ctx, int worker, int begin, int end);
+void spmm_dense_task(void *ctx, int worker, int begin, int end);
+void spgemm_count_task(void *ctx, int worker, int begin, int end);
+void spgemm_fill_task(void *ctx, int worker, int begin, int end);
+int compare_ints(const void *a, const void *b);
+Status generate_random_sparse(CsrMatrix *csr, int rows, int cols,
+                              double density, unsigned int *seed);
+
+int matrices_close(const Matrix *a, const Matrix *b, double tolerance);
+void expr_init(Expr *e);
+int expr_leaf(Expr *e, const Matrix *mat);
+int expr_const(Expr *e, double value);
+int expr_add(Expr *e, int left, int right);
+int expr_sub(Expr *e, int left, int right);
+int expr_scale(Expr *e, int child, double factor);
+Status expr_flatten(const Expr *e, int node, double coef,
+                    LinearCombination *lc);
+Status expr_evaluate(const Expr *e, int root, Matrix *result);
+Status expr_evaluate_into(const Expr *e, int root, Matrix *dest);
+void expr_eval_task(void *ctx, int worker, int begin, int end);
+int parse_expression(ExprParser *p);
+int parse_term(ExprParser *p);
+int parse_factor(ExprParser *p);
+void skip_spaces(ExprParser *p);
+
+Status multiply_matrices_naive(const Matrix *a, const Matrix *b,
+                               Matrix *result);
+Status gemm_blocked(const Matrix *a, const Matrix *b, Matrix *c);
+void gemm_pack_b_task(void *ctx, int worker, int begin, int end);
+void gemm_block_task(void *ctx, int worker, int begin, int end);
+void add_rows_task(void *ctx, int worker, int begin, int end);
+void transpose_tiles_task(void *ctx, int worker, int begin, int end);
+void transpose_in_place_task(void *ctx, int worker, int begin, int end);
+Status transpose_in_place(Matrix *m);
+void transpose_into(const Matrix *src, Matrix *dest);
+void transpose_naive(const Matrix *src, Matrix *dest);
+void transpose_tile(const double *src, int lds, double *dst, int ldd,
+                    int rows, int cols);
+void swap_transpose_tile(double *a, double *b, int ld, int rows, int cols,
+                         int diagonal);
+void transpose_4x4_scalar(const double *src, int lds, double *dst, int ldd);
+void swap_transpose_4x4_scalar(double *a, double *b, int ld);
+void pack_panel_a(const Matrix *a, int row0, int col0, int mc, int kc,
+                  double *packed);
+void pack_panel_b(const Matrix *b, int row0, int col0, int kc, int nc,
+                  double *packed);
+void micro_kernel_scalar(int kc, const double *a, const double *b, double *c,
+                         int ldc);
+#ifdef HAVE_X86_SIMD
+void micro_kernel_avx2(int kc, const double *a, const double *b, double *c,
+                       int ldc);
+void transpose_4x4_avx(const double *src, int lds, double *dst, int ldd);
+void swap_transpose_4x4_avx(double *a, double *b, int ld);
+#endif
+void select_simd_kernels(void);
+void fill_random_matrix(Matrix *mat, unsigned int *seed);
+unsigned int next_seed(unsigned int *seed);
+double get_time_seconds(void);
+
+Status pool_init(WorkerPool *pool, int num_threads);
+void pool_destroy(WorkerPool *pool);
+void *pool_worker_main(void *arg);
+void pool_run_tasks(WorkerPool *pool, int worker);
+void parallel_for(WorkerPool *pool, int total, int grain, TaskFn fn,
+                  void *ctx);
+int default_thread_count(void);
+
+MicroKernel gemm_kernel = micro_kernel_scalar;
+const char *gemm_kernel_name = "scalar";
+TransposeKernel transpose_kernel = transpose_4x4_scalar;
+SwapKernel swap_kernel = swap_transpose_4x4_scalar;
+const char *transpose_kernel_name = "scalar";
+WorkerPool worker_pool;
 
 int main(void) {
   int option = 0;
@@ -92,6 +511,12 @@ int main(void) {
     return 1;
   }
 
+  select_simd_kernels();
+  if (pool_init(&worker_pool, default_thread_count()) != SUCCESS) {
+    handle_error(ERR_THREAD_CREATION);
+    pool_init(&worker_pool, 1);
+  }
+
   while (TRUE) {
     show_menu();
 
@@ -103,6 +528,7 @@ int main(void) {
     if (option == MAX_OPTION) {
       printf("\nExiting calculator. Freeing memory...\n");
       free_system(&sys);
+      pool_destroy(&worker_pool);
       break;
     }
 
@@ -130,6 +556,51 @@ int main(void) {
     case 6:
       run_show_matrix(&sys);
       break;
+    case 7:
+      run_gemm_benchmark();
+      break;
+    case 8:
+      run_set_threads();
+      break;
+    case 9:
+      run_scaling_benchmark();
+      break;
+    case 10:
+      run_inverse(&sys);
+      break;
+    case 11:
+      run_solve(&sys);
+      break;
+    case 12:
+      run_lu_benchmark();
+      break;
+    case 13:
+      run_transpose_in_place(&sys);
+      break;
+    case 14:
+      run_transpose_benchmark();
+      break;
+    case 15:
+      run_show_sparse(&sys);
+      break;
+    case 16:
+      run_sparse_benchmark();
+      break;
+    case 17:
+      run_create_random_matrix(&sys);
+      break;
+    case 18:
+      run_save_matrix(&sys);
+      break;
+    case 19:
+      run_load_matrix(&sys);
+      break;
+    case 20:
+      run_evaluate_expression(&sys);
+      break;
+    case 21:
+      run_expression_benchmark();
+      break;
     }
   }
 
@@ -140,7 +611,15 @@ void show_menu(void) {
   printf("=== Matrix Calculator ===\n\n");
   printf("1. Create matrix\n2. Add matrices\n3. Multiply matrices\n"
          "4. Transpose matrix\n5. Calculate determinant\n6. Show matrix\n"
-         "7. Exit\n");
+         "7. GEMM benchmark\n8. Set worker threads (current: %d)\n"
+         "9. Thread scaling benchmark\n10. Invert matrix\n"
+         "11. Solve linear system (A * X = B)\n12. LU benchmark\n"
+         "13. Transpose in place (square)\n14. Transpose benchmark\n"
+         "15. Show sparse (CSR) form\n16. Sparse benchmark\n"
+         "17. Create random matrix\n18. Save matrix to file\n"
+         "19. Load matrix file (mmap)\n20. Evaluate expression\n"
+         "21. Expression benchmark\n22. Exit\n",
+         worker_pool.num_threads);
   printf("Option: ");
 }
 
@@ -155,33 +634,52 @@ void handle_error(Status status) {
   case ERR_MEMORY_ALLOCATION:
     printf("Error: Memory allocation failed.\n\n");
     break;
-  case ERR_SYSTEM_FULL:
-    printf("Error: Matrix storage full (Max %d).\n\n", MAX_CAPACITY);
-    break;
   case ERR_MATRIX_NOT_FOUND:
-    printf("Error: Matrix ID not found.\n\n");
+    printf("Error: Matrix name not found.\n\n");
     break;
   case ERR_DUPLICATE_ID:
-    printf("Error: Matrix ID already exists.\n\n");
+    printf("Error: Matrix name already exists.\n\n");
     break;
   case ERR_INCOMPATIBLE_DIM:
     printf("Error: Incompatible dimensions for operation.\n\n");
     break;
   case ERR_NOT_SQUARE:
-    printf("Error: Matrix must be square for determinant.\n\n");
+    printf("Error: Matrix must be square for this operation.\n\n");
+    break;
+  case ERR_THREAD_CREATION:
+    printf("Error: Could not create worker threads.\n\n");
+    break;
+  case ERR_SINGULAR:
+    printf("Error: Matrix is singular.\n\n");
+    break;
+  case ERR_FILE_NOT_FOUND:
+    printf("Error: File not found.\n\n");
+    break;
+  case ERR_FILE_IO:
+    printf("Error: File read/write failed.\n\n");
+    break;
+  case ERR_INVALID_FORMAT:
+    printf("Error: Not a valid matrix file.\n\n");
     break;
   case SUCCESS:
     break;
   }
 }
 
+// Large matrices are cut to the top-left PRINT_LIMIT x PRINT_LIMIT corner
 void print_matrix(const Matrix *mat) {
-  for (int i = 0; i < mat->rows; i++) {
+  int rows = mat->rows < PRINT_LIMIT ? mat->rows : PRINT_LIMIT;
+  int cols = mat->cols < PRINT_LIMIT ? mat->cols : PRINT_LIMIT;
+
+  for (int i = 0; i < rows; i++) {
     printf("[ ");
-    for (int j = 0; j < mat->cols; j++) {
-      printf("%6.2f ", mat->data[i][j]);
+    for (int j = 0; j < cols; j++) {
+      printf("%6.2f ", MAT_AT(mat, i, j));
     }
-    printf("]\n");
+    printf(cols < mat->cols ? "... ]\n" : "]\n");
+  }
+  if (rows < mat->rows) {
+    printf("  ... (%d more rows)\n", mat->rows - rows);
   }
 }
 
@@ -193,26 +691,22 @@ void list_available_matrices(const MatrixSystem *sys) {
 
   printf("\nAvailable Matrices:\n");
   for (int i = 0; i < sys->count; i++) {
-    printf("  - ID: %c [%dx%d]\n", sys->list[i].id, sys->list[i].rows,
-           sys->list[i].cols);
+    printf("  - %s [%dx%d]%s\n", sys->list[i].name, sys->list[i].rows,
+           sys->list[i].cols, sys->list[i].mapping ? " (mapped)" : "");
   }
 }
 
 void run_create_matrix(MatrixSystem *sys) {
-  char id;
+  char name[MAX_NAME_LEN];
   int rows, cols;
 
-  if (sys->count >= sys->capacity) {
-    if (resize_system(sys) != SUCCESS) {
-      handle_error(ERR_SYSTEM_FULL);
-      return;
-    }
+  printf("\nMatrix name: ");
+  if (read_name(name) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
   }
 
-  printf("\nMatrix ID (A-Z): ");
-  read_char(&id);
-
-  if (find_matrix_index(sys, id) != -1) {
+  if (find_matrix_index(sys, name) != -1) {
     handle_error(ERR_DUPLICATE_ID);
     return;
   }
@@ -233,7 +727,7 @@ void run_create_matrix(MatrixSystem *sys) {
     return;
   }
 
-  Status status = create_matrix(sys, id, rows, cols);
+  Status status = create_matrix(sys, name, rows, cols);
   if (status != SUCCESS) {
     handle_error(status);
     return;
@@ -244,106 +738,106 @@ void run_create_matrix(MatrixSystem *sys) {
   for (int i = 0; i < rows; i++) {
     for (int j = 0; j < cols; j++) {
       printf("[%d][%d]: ", i, j);
-      read_double(&mat->data[i][j]);
+      read_double(&MAT_AT(mat, i, j));
     }
   }
 
-  printf("\nMatrix %c created (%dx%d)\n\n", id, rows, cols);
+  printf("\nMatrix %s created (%dx%d)\n\n", name, rows, cols);
 }
 
 void run_add_matrices(MatrixSystem *sys) {
-  char id1, id2;
+  char name1[MAX_NAME_LEN], name2[MAX_NAME_LEN];
   Matrix *m1, *m2;
   Matrix result;
 
   list_available_matrices(sys);
 
-  printf("\nMatrix 1 ID: ");
-  read_char(&id1);
-  printf("Matrix 2 ID: ");
-  read_char(&id2);
+  printf("\nMatrix 1 name: ");
+  read_name(name1);
+  printf("Matrix 2 name: ");
+  read_name(name2);
 
-  if (get_matrix_by_id(sys, id1, &m1) != SUCCESS ||
-      get_matrix_by_id(sys, id2, &m2) != SUCCESS) {
+  if (get_matrix_by_name(sys, name1, &m1) != SUCCESS ||
+      get_matrix_by_name(sys, name2, &m2) != SUCCESS) {
     handle_error(ERR_MATRIX_NOT_FOUND);
     return;
   }
 
   Status status = add_matrices(m1, m2, &result);
   if (status == SUCCESS) {
-    printf("\nResult (%c + %c):\n\n", id1, id2);
+    printf("\nResult (%s + %s):\n\n", name1, name2);
     print_matrix(&result);
     free_matrix_data(&result);
   } else {
     printf("\nError: Incompatible dimensions\n\n");
-    printf("%c(%dx%d) + %c(%dx%d) \u274c\n\n", id1, m1->rows, m1->cols, id2,
+    printf("%s(%dx%d) + %s(%dx%d) \u274c\n\n", name1, m1->rows, m1->cols, name2,
            m2->rows, m2->cols);
   }
 }
 
 void run_multiply_matrices(MatrixSystem *sys) {
-  char id1, id2;
+  char name1[MAX_NAME_LEN], name2[MAX_NAME_LEN];
   Matrix *m1, *m2;
   Matrix result;
 
   list_available_matrices(sys);
 
-  printf("\nMatrix 1 ID: ");
-  read_char(&id1);
-  printf("Matrix 2 ID: ");
-  read_char(&id2);
+  printf("\nMatrix 1 name: ");
+  read_name(name1);
+  printf("Matrix 2 name: ");
+  read_name(name2);
 
-  if (get_matrix_by_id(sys, id1, &m1) != SUCCESS ||
-      get_matrix_by_id(sys, id2, &m2) != SUCCESS) {
+  if (get_matrix_by_name(sys, name1, &m1) != SUCCESS ||
+      get_matrix_by_name(sys, name2, &m2) != SUCCESS) {
     handle_error(ERR_MATRIX_NOT_FOUND);
     return;
   }
 
   Status status = multiply_matrices(m1, m2, &result);
   if (status == SUCCESS) {
-    printf("\nResult (%c * %c):\n\n", id1, id2);
+    printf("\nResult (%s * %s):\n\n", name1, name2);
     print_matrix(&result);
     free_matrix_data(&result);
   } else {
     printf("\nError: Incompatible dimensions for multiplication\n\n");
-    printf("%c(%dx%d) x %c(%dx%d) \u274c\n\n", id1, m1->rows, m1->cols, id2,
+    printf("%s(%dx%d) x %s(%dx%d) \u274c\n\n", name1, m1->rows, m1->cols, name2,
            m2->rows, m2->cols);
-    printf("Required: Cols of %c must equal Rows of %c\n\n", id1, id2);
+    printf("Required: Cols of %s must equal Rows of %s\n\n", name1, name2);
   }
 }
 
 void run_transpose_matrix(MatrixSystem *sys) {
-  char id;
+  char name[MAX_NAME_LEN];
   Matrix *src;
   Matrix dest;
 
   list_available_matrices(sys);
 
-  printf("\nTranspose matrix ID: ");
-  read_char(&id);
+  printf("\nTranspose matrix: ");
+  read_name(name);
 
-  if (get_matrix_by_id(sys, id, &src) != SUCCESS) {
+  if (get_matrix_by_name(sys, name, &src) != SUCCESS) {
     handle_error(ERR_MATRIX_NOT_FOUND);
     return;
   }
 
   if (transpose_matrix(src, &dest) == SUCCESS) {
-    printf("\nMatrix %c^T (%dx%d):\n\n", id, dest.rows, dest.cols);
+    printf("\nMatrix %s^T (%dx%d):\n\n", name, dest.rows, dest.cols);
     print_matrix(&dest);
     free_matrix_data(&dest);
   }
 }
 
 void run_determinant(MatrixSystem *sys) {
-  char id;
+  char name[MAX_NAME_LEN];
   Matrix *m;
 
   list_available_matrices(sys);
 
-  printf("\nCalculate determinant for matrix ID: ");
-  read_char(&id);
+  printf("\nCalculate determinant for matrix: ");
+  read_name(name);
 
-  if (get_matrix_by_id(sys, id, &m) != SUCCESS) {
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
     handle_error(ERR_MATRIX_NOT_FOUND);
     return;
   }
@@ -353,29 +847,29 @@ void run_determinant(MatrixSystem *sys) {
     return;
   }
 
-  Result res = calculate_determinant(m->data, m->rows);
+  Result res = calculate_determinant(m);
   if (res.status == SUCCESS) {
-    printf("\nDeterminant |%c| = %.2f\n\n", id, res.value);
+    printf("\nDeterminant |%s| = %.2f\n\n", name, res.value);
   } else {
     handle_error(res.status);
   }
 }
 
 void run_show_matrix(MatrixSystem *sys) {
-  char id;
+  char name[MAX_NAME_LEN];
   Matrix *m;
 
   list_available_matrices(sys);
 
-  printf("\nShow matrix ID: ");
-  read_char(&id);
+  printf("\nShow matrix: ");
+  read_name(name);
 
-  if (get_matrix_by_id(sys, id, &m) != SUCCESS) {
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
     handle_error(ERR_MATRIX_NOT_FOUND);
     return;
   }
 
-  printf("\nMatrix %c (%dx%d):\n\n", m->id, m->rows, m->cols);
+  printf("\nMatrix %s (%dx%d):\n\n", m->name, m->rows, m->cols);
   print_matrix(m);
 }
 
@@ -404,15 +898,40 @@ Status read_double(double *value) {
   return SUCCESS;
 }
 
-Status read_char(char *value) {
-  if (scanf(" %c", value) != 1) {
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  } else if (len == (size_t)(max_len - 1)) {
     clear_input_buffer();
+  }
+  return SUCCESS;
+}
+
+// Names are single words; surrounding blanks are dropped
+Status read_name(char *name) {
+  char line[MAX_NAME_LEN];
+  if (read_string(line, MAX_NAME_LEN) != SUCCESS) {
+    name[0] = '\0';
+    return ERR_INVALID_INPUT;
+  }
+  if (sscanf(line, "%31s", name) != 1) {
+    name[0] = '\0';
     return ERR_INVALID_INPUT;
   }
-  clear_input_buffer();
   return SUCCESS;
 }
 
+void read_path(const char *prompt, const char *fallback, char *path) {
+  printf("%s (default %s): ", prompt, fallback);
+  if (read_string(path, MAX_PATH_LEN) != SUCCESS || path[0] == '\0') {
+    strcpy(path, fallback);
+  }
+}
+
 Status init_system(MatrixSystem *sys) {
   sys->list = (Matrix *)malloc(INITIAL_CAPACITY * sizeof(Matrix));
   if (sys->list == NULL) {
@@ -426,14 +945,7 @@ Status init_system(MatrixSystem *sys) {
 }
 
 Status resize_system(MatrixSystem *sys) {
-  if (sys->capacity >= MAX_CAPACITY) {
-    return ERR_SYSTEM_FULL;
-  }
-
   int new_cap = sys->capacity * 2;
-  if (new_cap > MAX_CAPACITY) {
-    new_cap = MAX_CAPACITY;
-  }
 
   Matrix *new_list = (Matrix *)realloc(sys->list, new_cap * sizeof(Matrix));
   if (new_list == NULL) {
@@ -457,53 +969,85 @@ void free_system(MatrixSystem *sys) {
   sys->capacity = 0;
 }
 
-Status create_matrix(MatrixSystem *sys, char id, int rows, int cols) {
-  Matrix *m = &sys->list[sys->count];
-  m->id = id;
-  m->rows = rows;
-  m->cols = cols;
+Status create_matrix(MatrixSystem *sys, const char *name, int rows,
+                     int cols) {
+  Matrix mat;
+
+  Status status = alloc_matrix(&mat, rows, cols);
+  if (status != SUCCESS) {
+    return status;
+  }
+
+  status = register_matrix(sys, name, &mat);
+  if (status != SUCCESS) {
+    free_matrix_data(&mat);
+  }
+
+  return status;
+}
 
-  m->data = (double **)malloc(rows * sizeof(double *));
-  if (m->data == NULL) {
+// Takes ownership of mat's storage on success
+Status register_matrix(MatrixSystem *sys, const char *name, Matrix *mat) {
+  if (find_matrix_index(sys, name) != -1) {
+    return ERR_DUPLICATE_ID;
+  }
+  if (sys->count >= sys->capacity && resize_system(sys) != SUCCESS) {
     return ERR_MEMORY_ALLOCATION;
   }
 
-  for (int i = 0; i < rows; i++) {
-    m->data[i] = (double *)malloc(cols * sizeof(double));
-    if (m->data[i] == NULL) {
-      for (int k = 0; k < i; k++)
-        free(m->data[k]);
-      free(m->data);
-      return ERR_MEMORY_ALLOCATION;
-    }
+  snprintf(mat->name, MAX_NAME_LEN, "%s", name);
+  sys->list[sys->count++] = *mat;
+
+  return SUCCESS;
+}
+
+Status alloc_matrix(Matrix *mat, int rows, int cols) {
+  int stride = (cols + STRIDE_MULTIPLE - 1) / STRIDE_MULTIPLE * STRIDE_MULTIPLE;
+  size_t bytes = (size_t)rows * stride * sizeof(double);
+  void *block = NULL;
+
+  mat->name[0] = '\0';
+  mat->mapping = NULL;
+  mat->mapping_size = 0;
+  mat->rows = rows;
+  mat->cols = cols;
+  mat->stride = stride;
+  mat->data = NULL;
+
+  if (posix_memalign(&block, MATRIX_ALIGNMENT, bytes) != 0) {
+    return ERR_MEMORY_ALLOCATION;
   }
 
-  sys->count++;
+  // Zero the padding too, so whole-row kernels never read garbage
+  memset(block, 0, bytes);
+  mat->data = (double *)block;
 
   return SUCCESS;
 }
 
 void free_matrix_data(Matrix *mat) {
-  if (mat->data) {
-    for (int i = 0; i < mat->rows; i++) {
-      free(mat->data[i]);
-    }
+  if (mat->mapping != NULL) {
+    munmap(mat->mapping, mat->mapping_size);
+    mat->mapping = NULL;
+    mat->mapping_size = 0;
+  } else {
     free(mat->data);
-    mat->data = NULL;
   }
+  mat->data = NULL;
 }
 
-int find_matrix_index(const MatrixSystem *sys, char id) {
+int find_matrix_index(const MatrixSystem *sys, const char *name) {
   for (int i = 0; i < sys->count; i++) {
-    if (sys->list[i].id == id)
+    if (strcmp(sys->list[i].name, name) == 0)
       return i;
   }
 
   return -1;
 }
 
-Status get_matrix_by_id(const MatrixSystem *sys, char id, Matrix **mat) {
-  int idx = find_matrix_index(sys, id);
+Status get_matrix_by_name(const MatrixSystem *sys, const char *name,
+                          Matrix **mat) {
+  int idx = find_matrix_index(sys, name);
   if (idx == -1) {
     return ERR_MATRIX_NOT_FOUND;
   }
@@ -513,33 +1057,126 @@ Status get_matrix_by_id(const MatrixSystem *sys, char id, Matrix **mat) {
   return SUCCESS;
 }
 
+/*
+ * Writes to "<path>.tmp" and renames it over path, so a matrix that is
+ * currently mapped from path keeps its pages until it is unmapped.
+ */
+Status save_matrix_file(const Matrix *mat, const char *path) {
+  char tmp_path[MAX_PATH_LEN + 8];
+  MatrixFileHeader header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MATRIX_MAGIC, sizeof(header.magic));
+  header.version = MATRIX_VERSION;
+  header.rows = mat->rows;
+  header.cols = mat->cols;
+  header.stride = mat->stride;
+  header.data_offset = sizeof(MatrixFileHeader);
+
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (file == NULL) {
+    return ERR_FILE_IO;
+  }
+  setvbuf(file, NULL, _IOFBF, IO_BUFFER_SIZE);
+
+  size_t count = (size_t)mat->rows * mat->stride;
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(mat->data, sizeof(double), count, file) == count;
+
+  if (fclose(file) != 0 || !ok || rename(tmp_path, path) != 0) {
+    remove(tmp_path);
+    return ERR_FILE_IO;
+  }
+  return SUCCESS;
+}
+
+/*
+ * Private writable mapping: reads page in straight from the file and
+ * in-place operations only copy the pages they touch; the file itself
+ * is never modified.
+ */
+Status map_matrix_file(Matrix *mat, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 ||
+      (size_t)st.st_size < sizeof(MatrixFileHeader)) {
+    close(fd);
+    return ERR_INVALID_FORMAT;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps its own reference to the file
+  if (map == MAP_FAILED) {
+    return ERR_FILE_IO;
+  }
+
+  const MatrixFileHeader *header = (const MatrixFileHeader *)map;
+  int valid =
+      memcmp(header->magic, MATRIX_MAGIC, sizeof(header->magic)) == 0 &&
+      header->version == MATRIX_VERSION && header->rows >= 1 &&
+      header->rows <= 0x7fffffffLL && header->cols >= 1 &&
+      header->stride >= header->cols && header->stride <= 0x7fffffffLL &&
+      header->data_offset >= (long long)sizeof(MatrixFileHeader) &&
+      header->data_offset % MATRIX_ALIGNMENT == 0 &&
+      (size_t)header->data_offset <= size;
+  // Both counts fit in 31 bits, so the product cannot overflow; dividing
+  // the payload instead of multiplying the header keeps the size check
+  // from wrapping
+  if (valid) {
+    size_t payload = (size - (size_t)header->data_offset) / sizeof(double);
+    valid = header->rows * header->stride <= MAX_FILE_ELEMENTS &&
+            payload / (size_t)header->stride >= (size_t)header->rows;
+  }
+  if (!valid) {
+    munmap(map, size);
+    return ERR_INVALID_FORMAT;
+  }
+
+  mat->name[0] = '\0';
+  mat->rows = (int)header->rows;
+  mat->cols = (int)header->cols;
+  mat->stride = (int)header->stride;
+  mat->data = (double *)((char *)map + header->data_offset);
+  mat->mapping = map;
+  mat->mapping_size = size;
+
+  posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+  return SUCCESS;
+}
+
 Status add_matrices(const Matrix *a, const Matrix *b, Matrix *result) {
   if (a->rows != b->rows || a->cols != b->cols) {
     return ERR_INCOMPATIBLE_DIM;
   }
 
-  result->rows = a->rows;
-  result->cols = a->cols;
-  result->data = (double **)malloc(result->rows * sizeof(double *));
-  if (result->data == NULL) {
+  if (alloc_matrix(result, a->rows, a->cols) != SUCCESS) {
     return ERR_MEMORY_ALLOCATION;
   }
 
-  for (int i = 0; i < result->rows; i++) {
-    result->data[i] = (double *)malloc(result->cols * sizeof(double));
-    if (result->data[i] == NULL) {
-      for (int k = 0; k < i; k++)
-        free(result->data[k]);
-      free(result->data);
-      return ERR_MEMORY_ALLOCATION;
-    }
+  AddJob job = {a, b, result};
+  parallel_for(&worker_pool, result->rows, ROW_GRAIN, add_rows_task, &job);
 
-    for (int j = 0; j < result->cols; j++) {
-      result->data[i][j] = a->data[i][j] + b->data[i][j];
+  return SUCCESS;
+}
+
+void add_rows_task(void *ctx, int worker, int begin, int end) {
+  AddJob *job = (AddJob *)ctx;
+  (void)worker;
+
+  for (int i = begin; i < end; i++) {
+    const double *ra = MAT_ROW(job->a, i);
+    const double *rb = MAT_ROW(job->b, i);
+    double *rc = MAT_ROW(job->c, i);
+    for (int j = 0; j < job->c->cols; j++) {
+      rc[j] = ra[j] + rb[j];
     }
   }
-
-  return SUCCESS;
 }
 
 Status multiply_matrices(const Matrix *a, const Matrix *b, Matrix *result) {
@@ -547,120 +1184,2571 @@ Status multiply_matrices(const Matrix *a, const Matrix *b, Matrix *result) {
     return ERR_INCOMPATIBLE_DIM;
   }
 
-  result->rows = a->rows;
-  result->cols = b->cols;
-  result->data = (double **)malloc(result->rows * sizeof(double *));
-  if (result->data == NULL) {
+  if (alloc_matrix(result, a->rows, b->cols) != SUCCESS) {
     return ERR_MEMORY_ALLOCATION;
   }
 
-  for (int i = 0; i < result->rows; i++) {
-    result->data[i] = (double *)malloc(result->cols * sizeof(double));
-    if (result->data[i] == NULL) {
-      for (int k = 0; k < i; k++)
-        free(result->data[k]);
-      free(result->data);
-      return ERR_MEMORY_ALLOCATION;
-    }
-    for (int j = 0; j < result->cols; j++) {
-      result->data[i][j] = 0;
-      for (int k = 0; k < a->cols; k++) {
-        result->data[i][j] += a->data[i][k] * b->data[k][j];
-      }
-    }
+  if (gemm_blocked(a, b, result) != SUCCESS) {
+    free_matrix_data(result);
+    return ERR_MEMORY_ALLOCATION;
   }
   return SUCCESS;
 }
 
 Status transpose_matrix(const Matrix *src, Matrix *dest) {
-  dest->rows = src->cols;
-  dest->cols = src->rows;
-  dest->data = (double **)malloc(dest->rows * sizeof(double *));
-  if (dest->data == NULL) {
+  if (alloc_matrix(dest, src->cols, src->rows) != SUCCESS) {
     return ERR_MEMORY_ALLOCATION;
   }
 
-  for (int i = 0; i < dest->rows; i++) {
-    dest->data[i] = (double *)malloc(dest->cols * sizeof(double));
-    if (dest->data[i] == NULL) {
-      for (int k = 0; k < i; k++)
-        free(dest->data[k]);
-      free(dest->data);
-      return ERR_MEMORY_ALLOCATION;
+  transpose_into(src, dest);
+
+  return SUCCESS;
+}
+
+// dest must already be allocated as src->cols x src->rows
+void transpose_into(const Matrix *src, Matrix *dest) {
+  TransposeJob job = {src, dest};
+  int tile_rows = (dest->rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  parallel_for(&worker_pool, tile_rows, 1, transpose_tiles_task, &job);
+}
+
+// Each task owns one band of TRANSPOSE_TILE destination rows
+void transpose_tiles_task(void *ctx, int worker, int begin, int end) {
+  TransposeJob *job = (TransposeJob *)ctx;
+  const Matrix *src = job->src;
+  Matrix *dest = job->dest;
+  (void)worker;
+
+  for (int band = begin; band < end; band++) {
+    int i0 = band * TRANSPOSE_TILE;
+    int rows = dest->rows - i0 < TRANSPOSE_TILE ? dest->rows - i0
+                                                : TRANSPOSE_TILE;
+    for (int j0 = 0; j0 < dest->cols; j0 += TRANSPOSE_TILE) {
+      int cols = dest->cols - j0 < TRANSPOSE_TILE ? dest->cols - j0
+                                                  : TRANSPOSE_TILE;
+      transpose_tile(&MAT_AT(src, j0, i0), src->stride, &MAT_AT(dest, i0, j0),
+                     dest->stride, cols, rows);
+    }
+  }
+}
+
+Status transpose_in_place(Matrix *m) {
+  if (m->rows != m->cols) {
+    return ERR_NOT_SQUARE;
+  }
+
+  InPlaceJob job = {m};
+  int bands = (m->rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  parallel_for(&worker_pool, bands, 1, transpose_in_place_task, &job);
+
+  return SUCCESS;
+}
+
+/*
+ * Band b swaps every tile (b, t) right of the diagonal with tile (t, b)
+ * and transposes the diagonal tile itself, so no two tasks ever touch
+ * the same element.
+ */
+void transpose_in_place_task(void *ctx, int worker, int begin, int end) {
+  Matrix *m = ((InPlaceJob *)ctx)->m;
+  int n = m->rows;
+  (void)worker;
+
+  for (int band = begin; band < end; band++) {
+    int i0 = band * TRANSPOSE_TILE;
+    int rows = n - i0 < TRANSPOSE_TILE ? n - i0 : TRANSPOSE_TILE;
+
+    swap_transpose_tile(&MAT_AT(m, i0, i0), &MAT_AT(m, i0, i0), m->stride,
+                        rows, rows, TRUE);
+    for (int j0 = i0 + TRANSPOSE_TILE; j0 < n; j0 += TRANSPOSE_TILE) {
+      int cols = n - j0 < TRANSPOSE_TILE ? n - j0 : TRANSPOSE_TILE;
+      swap_transpose_tile(&MAT_AT(m, i0, j0), &MAT_AT(m, j0, i0), m->stride,
+                          rows, cols, FALSE);
     }
+  }
+}
+
+void transpose_naive(const Matrix *src, Matrix *dest) {
+  for (int i = 0; i < dest->rows; i++) {
+    double *row = MAT_ROW(dest, i);
     for (int j = 0; j < dest->cols; j++) {
-      dest->data[i][j] = src->data[j][i];
+      row[j] = MAT_AT(src, j, i);
     }
   }
+}
 
-  return SUCCESS;
+// Transposes a rows x cols block of src into dst, 4x4 at a time
+void transpose_tile(const double *src, int lds, double *dst, int ldd,
+                    int rows, int cols) {
+  int full_rows = rows & ~3, full_cols = cols & ~3;
+
+  for (int i = 0; i < full_rows; i += 4) {
+    for (int j = 0; j < full_cols; j += 4) {
+      transpose_kernel(src + (size_t)i * lds + j, lds,
+                       dst + (size_t)j * ldd + i, ldd);
+    }
+  }
+  for (int i = 0; i < rows; i++) {
+    int j = i < full_rows ? full_cols : 0;
+    for (; j < cols; j++) {
+      dst[(size_t)j * ldd + i] = src[(size_t)i * lds + j];
+    }
+  }
 }
 
-void get_cofactor(double **data, double **temp, int p, int q, int n) {
-  int i = 0, j = 0;
-  for (int row = 0; row < n; row++) {
-    for (int col = 0; col < n; col++) {
-      if (row != p && col != q) {
-        temp[i][j++] = data[row][col];
-        if (j == n - 1) {
-          j = 0;
-          i++;
-        }
-      }
+/*
+ * Exchanges the rows x cols block at a with the transposed block at b.
+ * For a diagonal tile (a == b, square) only the upper triangle of 4x4
+ * blocks is visited, and the diagonal 4x4 blocks transpose in place.
+ */
+void swap_transpose_tile(double *a, double *b, int ld, int rows, int cols,
+                         int diagonal) {
+  int full_rows = rows & ~3, full_cols = cols & ~3;
+
+  for (int i = 0; i < full_rows; i += 4) {
+    for (int j = diagonal ? i : 0; j < full_cols; j += 4) {
+      swap_kernel(a + (size_t)i * ld + j, b + (size_t)j * ld + i, ld);
+    }
+  }
+  for (int i = 0; i < rows; i++) {
+    int j = i < full_rows ? full_cols : 0;
+    if (diagonal && j <= i)
+      j = i + 1;
+    for (; j < cols; j++) {
+      double t = a[(size_t)i * ld + j];
+      a[(size_t)i * ld + j] = b[(size_t)j * ld + i];
+      b[(size_t)j * ld + i] = t;
+    }
+  }
+}
+
+void transpose_4x4_scalar(const double *src, int lds, double *dst, int ldd) {
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      dst[(size_t)j * ldd + i] = src[(size_t)i * lds + j];
+    }
+  }
+}
+
+void swap_transpose_4x4_scalar(double *a, double *b, int ld) {
+  double ta[4][4], tb[4][4];
+
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      ta[i][j] = a[(size_t)i * ld + j];
+      tb[i][j] = b[(size_t)i * ld + j];
+    }
+  }
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      a[(size_t)i * ld + j] = tb[j][i];
+      b[(size_t)i * ld + j] = ta[j][i];
     }
   }
 }
 
-Result calculate_determinant(double **data, int n) {
+Result calculate_determinant(const Matrix *mat) {
   Result res = {SUCCESS, 0.0};
+  LuFactor f;
 
-  if (n == 1) {
-    res.value = data[0][0];
+  res.status = lu_decompose(mat, &f);
+  if (res.status != SUCCESS) {
     return res;
   }
 
-  double **temp = (double **)malloc(n * sizeof(double *));
-  if (temp == NULL) {
-    res.status = ERR_MEMORY_ALLOCATION;
-    return res;
+  if (!f.singular) {
+    res.value = f.sign;
+    for (int i = 0; i < mat->rows; i++) {
+      res.value *= MAT_AT(&f.lu, i, i);
+    }
   }
 
-  for (int i = 0; i < n; i++) {
-    temp[i] = (double *)malloc(n * sizeof(double));
-    if (temp[i] == NULL) {
-      for (int k = 0; k < i; k++) {
-        free(temp[k]);
-      }
-      free(temp);
+  lu_free(&f);
+
+  return res;
+}
 
-      res.status = ERR_MEMORY_ALLOCATION;
+Status invert_matrix(const Matrix *a, Matrix *inverse) {
+  if (a->rows != a->cols) {
+    return ERR_NOT_SQUARE;
+  }
 
-      return res;
-    }
+  Matrix identity;
+  if (alloc_matrix(&identity, a->rows, a->rows) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < a->rows; i++) {
+    MAT_AT(&identity, i, i) = 1.0;
   }
 
-  int sign = 1;
-  for (int f = 0; f < n; f++) {
-    get_cofactor(data, temp, 0, f, n);
+  Status status = solve_linear_system(a, &identity, inverse);
+  free_matrix_data(&identity);
 
-    Result sub = calculate_determinant(temp, n - 1);
-    if (sub.status != SUCCESS) {
-      for (int i = 0; i < n; i++) {
-        free(temp[i]);
-      }
-      free(temp);
+  return status;
+}
 
-      return sub;
-    }
+Status solve_linear_system(const Matrix *a, const Matrix *b, Matrix *x) {
+  if (a->rows != a->cols) {
+    return ERR_NOT_SQUARE;
+  }
+  if (b->rows != a->rows) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
 
-    res.value += sign * data[0][f] * sub.value;
-    sign = -sign;
+  LuFactor f;
+  Status status = lu_decompose(a, &f);
+  if (status != SUCCESS) {
+    return status;
   }
 
-  for (int i = 0; i < n; i++) {
-    free(temp[i]);
+  if (f.singular) {
+    lu_free(&f);
+    return ERR_SINGULAR;
   }
-  free(temp);
 
-  return res;
+  status = lu_solve(&f, b, x);
+  lu_free(&f);
+
+  return status;
+}
+
+/*
+ * Right-looking blocked LU. Each LU_BLOCK-wide panel is factored with
+ * row pivoting, the block row of U to its right is solved against the
+ * unit lower L11, and the trailing matrix gets A22 -= L21 * U12 through
+ * the packed GEMM, which is where nearly all of the flops go.
+ */
+Status lu_decompose(const Matrix *a, LuFactor *f) {
+  int n = a->rows;
+
+  if (a->rows != a->cols) {
+    return ERR_NOT_SQUARE;
+  }
+
+  f->sign = 1;
+  f->singular = FALSE;
+  f->pivots = (int *)malloc(n * sizeof(int));
+  if (f->pivots == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  if (alloc_matrix(&f->lu, n, n) != SUCCESS) {
+    free(f->pivots);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < n; i++) {
+    memcpy(MAT_ROW(&f->lu, i), MAT_ROW(a, i), n * sizeof(double));
+  }
+
+  // GEMM accumulates C += A * B, so L21 is staged negated
+  Matrix neg_l;
+  if (alloc_matrix(&neg_l, n, LU_BLOCK) != SUCCESS) {
+    lu_free(f);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  Matrix *lu = &f->lu;
+  for (int k = 0; k < n; k += LU_BLOCK) {
+    int nb = n - k < LU_BLOCK ? n - k : LU_BLOCK;
+    int rest = n - k - nb;
+
+    lu_factor_panel(f, k, nb);
+    if (rest == 0)
+      break;
+
+    // U12 = L11^-1 * A12
+    for (int r = k + 1; r < k + nb; r++) {
+      double *row = MAT_ROW(lu, r) + k + nb;
+      for (int q = k; q < r; q++) {
+        double l = MAT_AT(lu, r, q);
+        const double *src = MAT_ROW(lu, q) + k + nb;
+        for (int c = 0; c < rest; c++) {
+          row[c] -= l * src[c];
+        }
+      }
+    }
+
+    Matrix l21 = submatrix_view(&neg_l, 0, 0, rest, nb);
+    for (int i = 0; i < rest; i++) {
+      const double *src = MAT_ROW(lu, k + nb + i) + k;
+      double *dst = MAT_ROW(&l21, i);
+      for (int p = 0; p < nb; p++) {
+        dst[p] = -src[p];
+      }
+    }
+
+    Matrix u12 = submatrix_view(lu, k, k + nb, nb, rest);
+    Matrix a22 = submatrix_view(lu, k + nb, k + nb, rest, rest);
+    if (gemm_blocked(&l21, &u12, &a22) != SUCCESS) {
+      free_matrix_data(&neg_l);
+      lu_free(f);
+      return ERR_MEMORY_ALLOCATION;
+    }
+  }
+
+  free_matrix_data(&neg_l);
+
+  return SUCCESS;
+}
+
+void lu_free(LuFactor *f) {
+  free_matrix_data(&f->lu);
+  free(f->pivots);
+  f->pivots = NULL;
+}
+
+// Unblocked elimination on columns [k, k + nb) over rows k..n-1
+void lu_factor_panel(LuFactor *f, int k, int nb) {
+  Matrix *lu = &f->lu;
+  int n = lu->rows;
+
+  for (int j = k; j < k + nb; j++) {
+    int p = j;
+    double best = MAT_AT(lu, j, j) < 0 ? -MAT_AT(lu, j, j) : MAT_AT(lu, j, j);
+    for (int i = j + 1; i < n; i++) {
+      double v = MAT_AT(lu, i, j) < 0 ? -MAT_AT(lu, i, j) : MAT_AT(lu, i, j);
+      if (v > best) {
+        best = v;
+        p = i;
+      }
+    }
+
+    f->pivots[j] = p;
+    if (p != j) {
+      swap_rows(lu, j, p);
+      f->sign = -f->sign;
+    }
+
+    if (best == 0.0) {
+      f->singular = TRUE;
+      continue;
+    }
+
+    double pivot = MAT_AT(lu, j, j);
+    const double *pivot_row = MAT_ROW(lu, j);
+    for (int i = j + 1; i < n; i++) {
+      double *row = MAT_ROW(lu, i);
+      double l = row[j] / pivot;
+      row[j] = l;
+      for (int c = j + 1; c < k + nb; c++) {
+        row[c] -= l * pivot_row[c];
+      }
+    }
+  }
+}
+
+Status lu_solve(const LuFactor *f, const Matrix *b, Matrix *x) {
+  if (alloc_matrix(x, b->rows, b->cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < b->rows; i++) {
+    memcpy(MAT_ROW(x, i), MAT_ROW(b, i), b->cols * sizeof(double));
+  }
+  for (int i = 0; i < b->rows; i++) {
+    if (f->pivots[i] != i) {
+      swap_rows(x, i, f->pivots[i]);
+    }
+  }
+
+  LuSolveJob job = {f, x};
+  parallel_for(&worker_pool, x->cols, LU_SOLVE_GRAIN, lu_solve_task, &job);
+
+  return SUCCESS;
+}
+
+// Forward then back substitution on the right-hand-side columns [begin, end)
+void lu_solve_task(void *ctx, int worker, int begin, int end) {
+  LuSolveJob *job = (LuSolveJob *)ctx;
+  const Matrix *lu = &job->f->lu;
+  Matrix *x = job->x;
+  int n = lu->rows;
+  (void)worker;
+
+  for (int i = 1; i < n; i++) {
+    double *row = MAT_ROW(x, i);
+    for (int q = 0; q < i; q++) {
+      double l = MAT_AT(lu, i, q);
+      const double *src = MAT_ROW(x, q);
+      for (int c = begin; c < end; c++) {
+        row[c] -= l * src[c];
+      }
+    }
+  }
+
+  for (int i = n - 1; i >= 0; i--) {
+    double *row = MAT_ROW(x, i);
+    for (int q = i + 1; q < n; q++) {
+      double u = MAT_AT(lu, i, q);
+      const double *src = MAT_ROW(x, q);
+      for (int c = begin; c < end; c++) {
+        row[c] -= u * src[c];
+      }
+    }
+    double inv = 1.0 / MAT_AT(lu, i, i);
+    for (int c = begin; c < end; c++) {
+      row[c] *= inv;
+    }
+  }
+}
+
+void swap_rows(Matrix *m, int r1, int r2) {
+  double *a = MAT_ROW(m, r1);
+  double *b = MAT_ROW(m, r2);
+  for (int c = 0; c < m->cols; c++) {
+    double t = a[c];
+    a[c] = b[c];
+    b[c] = t;
+  }
+}
+
+// Non-owning window into m; never pass it to free_matrix_data
+Matrix submatrix_view(const Matrix *m, int row, int col, int rows, int cols) {
+  Matrix view;
+  memcpy(view.name, m->name, MAX_NAME_LEN);
+  view.mapping = NULL;
+  view.mapping_size = 0;
+  view.rows = rows;
+  view.cols = cols;
+  view.stride = m->stride;
+  view.data = m->data + (size_t)row * m->stride + col;
+  return view;
+}
+
+Status coo_init(CooMatrix *coo, int rows, int cols) {
+  coo->rows = rows;
+  coo->cols = cols;
+  coo->nnz = 0;
+  coo->capacity = INITIAL_COO_CAPACITY;
+  coo->entries = (Triplet *)malloc(coo->capacity * sizeof(Triplet));
+  if (coo->entries == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  return SUCCESS;
+}
+
+Status coo_push(CooMatrix *coo, int row, int col, double value) {
+  if (row < 0 || row >= coo->rows || col < 0 || col >= coo->cols) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
+
+  if (coo->nnz == coo->capacity) {
+    long long new_cap = coo->capacity * 2;
+    Triplet *grown =
+        (Triplet *)realloc(coo->entries, new_cap * sizeof(Triplet));
+    if (grown == NULL) {
+      return ERR_MEMORY_ALLOCATION;
+    }
+    coo->entries = grown;
+    coo->capacity = new_cap;
+  }
+
+  coo->entries[coo->nnz].row = row;
+  coo->entries[coo->nnz].col = col;
+  coo->entries[coo->nnz].value = value;
+  coo->nnz++;
+
+  return SUCCESS;
+}
+
+void coo_free(CooMatrix *coo) {
+  free(coo->entries);
+  coo->entries = NULL;
+  coo->nnz = coo->capacity = 0;
+}
+
+Status csr_alloc(CsrMatrix *csr, int rows, int cols, long long nnz) {
+  csr->rows = rows;
+  csr->cols = cols;
+  csr->nnz = nnz;
+  csr->row_ptr = (long long *)calloc((size_t)rows + 1, sizeof(long long));
+  csr->col_idx = (int *)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+  csr->values = (double *)malloc((nnz > 0 ? nnz : 1) * sizeof(double));
+
+  if (csr->row_ptr == NULL || csr->col_idx == NULL || csr->values == NULL) {
+    csr_free(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  return SUCCESS;
+}
+
+void csr_free(CsrMatrix *csr) {
+  free(csr->row_ptr);
+  free(csr->col_idx);
+  free(csr->values);
+  csr->row_ptr = NULL;
+  csr->col_idx = NULL;
+  csr->values = NULL;
+  csr->nnz = 0;
+}
+
+/*
+ * Bucket the triplets by row, then transpose twice: each counting-sort
+ * transpose emits rows in order, so the result has sorted columns and
+ * duplicates sit next to each other, ready to be summed in one sweep.
+ */
+Status csr_from_coo(const CooMatrix *coo, CsrMatrix *csr) {
+  CsrMatrix unsorted, flipped;
+
+  if (csr_alloc(&unsorted, coo->rows, coo->cols, coo->nnz) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (long long e = 0; e < coo->nnz; e++) {
+    unsorted.row_ptr[coo->entries[e].row + 1]++;
+  }
+  for (int i = 0; i < coo->rows; i++) {
+    unsorted.row_ptr[i + 1] += unsorted.row_ptr[i];
+  }
+  for (long long e = 0; e < coo->nnz; e++) {
+    long long pos = unsorted.row_ptr[coo->entries[e].row]++;
+    unsorted.col_idx[pos] = coo->entries[e].col;
+    unsorted.values[pos] = coo->entries[e].value;
+  }
+  for (int i = coo->rows; i > 0; i--) {
+    unsorted.row_ptr[i] = unsorted.row_ptr[i - 1];
+  }
+  unsorted.row_ptr[0] = 0;
+
+  Status status = csr_transpose(&unsorted, &flipped);
+  csr_free(&unsorted);
+  if (status != SUCCESS) {
+    return status;
+  }
+  status = csr_transpose(&flipped, csr);
+  csr_free(&flipped);
+  if (status != SUCCESS) {
+    return status;
+  }
+
+  long long out = 0;
+  for (int i = 0; i < csr->rows; i++) {
+    long long begin = csr->row_ptr[i], end = csr->row_ptr[i + 1];
+    csr->row_ptr[i] = out;
+    for (long long p = begin; p < end; p++) {
+      if (out > csr->row_ptr[i] && csr->col_idx[out - 1] == csr->col_idx[p]) {
+        csr->values[out - 1] += csr->values[p];
+      } else {
+        csr->col_idx[out] = csr->col_idx[p];
+        csr->values[out] = csr->values[p];
+        out++;
+      }
+    }
+  }
+  csr->row_ptr[csr->rows] = out;
+  csr->nnz = out;
+
+  return SUCCESS;
+}
+
+Status csr_from_dense(const Matrix *mat, CsrMatrix *csr) {
+  long long nnz = 0;
+  for (int i = 0; i < mat->rows; i++) {
+    const double *row = MAT_ROW(mat, i);
+    for (int j = 0; j < mat->cols; j++) {
+      nnz += row[j] != 0.0;
+    }
+  }
+
+  if (csr_alloc(csr, mat->rows, mat->cols, nnz) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  long long pos = 0;
+  for (int i = 0; i < mat->rows; i++) {
+    const double *row = MAT_ROW(mat, i);
+    for (int j = 0; j < mat->cols; j++) {
+      if (row[j] != 0.0) {
+        csr->col_idx[pos] = j;
+        csr->values[pos] = row[j];
+        pos++;
+      }
+    }
+    csr->row_ptr[i + 1] = pos;
+  }
+
+  return SUCCESS;
+}
+
+Status csr_to_dense(const CsrMatrix *csr, Matrix *mat) {
+  if (alloc_matrix(mat, csr->rows, csr->cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < csr->rows; i++) {
+    double *row = MAT_ROW(mat, i);
+    for (long long p = csr->row_ptr[i]; p < csr->row_ptr[i + 1]; p++) {
+      row[csr->col_idx[p]] += csr->values[p];
+    }
+  }
+
+  return SUCCESS;
+}
+
+// Counting sort by column; output rows come out with sorted columns
+Status csr_transpose(const CsrMatrix *a, CsrMatrix *t) {
+  if (csr_alloc(t, a->cols, a->rows, a->nnz) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (long long p = 0; p < a->nnz; p++) {
+    t->row_ptr[a->col_idx[p] + 1]++;
+  }
+  for (int j = 0; j < a->cols; j++) {
+    t->row_ptr[j + 1] += t->row_ptr[j];
+  }
+
+  long long *next = (long long *)malloc((size_t)a->cols * sizeof(long long));
+  if (next == NULL) {
+    csr_free(t);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  memcpy(next, t->row_ptr, (size_t)a->cols * sizeof(long long));
+
+  for (int i = 0; i < a->rows; i++) {
+    for (long long p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+      long long pos = next[a->col_idx[p]]++;
+      t->col_idx[pos] = i;
+      t->values[pos] = a->values[p];
+    }
+  }
+
+  free(next);
+
+  return SUCCESS;
+}
+
+Status csr_spmv(const CsrMatrix *a, const double *x, double *y) {
+  SpmvJob job = {a, x, y};
+  parallel_for(&worker_pool, a->rows, SPMV_GRAIN, spmv_task, &job);
+  return SUCCESS;
+}
+
+void spmv_task(void *ctx, int worker, int begin, int end) {
+  SpmvJob *job = (SpmvJob *)ctx;
+  const CsrMatrix *a = job->a;
+  (void)worker;
+
+  for (int i = begin; i < end; i++) {
+    double sum = 0.0;
+    for (long long p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+      sum += a->values[p] * job->x[a->col_idx[p]];
+    }
+    job->y[i] = sum;
+  }
+}
+
+Status csr_multiply_dense(const CsrMatrix *a, const Matrix *b, Matrix *c) {
+  if (a->cols != b->rows) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
+  if (alloc_matrix(c, a->rows, b->cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  SpmmDenseJob job = {a, b, c};
+  parallel_for(&worker_pool, a->rows, ROW_GRAIN, spmm_dense_task, &job);
+
+  return SUCCESS;
+}
+
+// Row i of C is a sum of rows of B scaled by the nonzeros of row i of A
+void spmm_dense_task(void *ctx, int worker, int begin, int end) {
+  SpmmDenseJob *job = (SpmmDenseJob *)ctx;
+  const CsrMatrix *a = job->a;
+  int n = job->b->cols;
+  (void)worker;
+
+  for (int i = begin; i < end; i++) {
+    double *crow = MAT_ROW(job->c, i);
+    for (long long p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+      double v = a->values[p];
+      const double *brow = MAT_ROW(job->b, a->col_idx[p]);
+      for (int j = 0; j < n; j++) {
+        crow[j] += v * brow[j];
+      }
+    }
+  }
+}
+
+/*
+ * Two passes over the rows of A: a symbolic pass counts the distinct
+ * columns of each output row, then a numeric pass accumulates into a
+ * dense per-worker buffer and writes the sorted row out.
+ */
+Status csr_multiply_csr(const CsrMatrix *a, const CsrMatrix *b,
+                        CsrMatrix *c) {
+  if (a->cols != b->rows) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
+
+  int workers = worker_pool.num_threads;
+  size_t scratch = (size_t)workers * b->cols;
+  SpgemmJob job = {a, b, c, NULL, NULL};
+  job.marker = (int *)malloc(scratch * sizeof(int));
+  job.acc = (double *)calloc(scratch, sizeof(double));
+  if (job.marker == NULL || job.acc == NULL) {
+    free(job.marker);
+    free(job.acc);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  c->rows = a->rows;
+  c->cols = b->cols;
+  c->col_idx = NULL;
+  c->values = NULL;
+  c->row_ptr = (long long *)calloc((size_t)a->rows + 1, sizeof(long long));
+  if (c->row_ptr == NULL) {
+    free(job.marker);
+    free(job.acc);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  memset(job.marker, 0xff, scratch * sizeof(int));
+  parallel_for(&worker_pool, a->rows, ROW_GRAIN, spgemm_count_task, &job);
+
+  for (int i = 0; i < a->rows; i++) {
+    c->row_ptr[i + 1] += c->row_ptr[i];
+  }
+  c->nnz = c->row_ptr[a->rows];
+  c->col_idx = (int *)malloc((c->nnz > 0 ? c->nnz : 1) * sizeof(int));
+  c->values = (double *)malloc((c->nnz > 0 ? c->nnz : 1) * sizeof(double));
+  if (c->col_idx == NULL || c->values == NULL) {
+    csr_free(c);
+    free(job.marker);
+    free(job.acc);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  memset(job.marker, 0xff, scratch * sizeof(int));
+  parallel_for(&worker_pool, a->rows, ROW_GRAIN, spgemm_fill_task, &job);
+
+  free(job.marker);
+  free(job.acc);
+
+  return SUCCESS;
+}
+
+// Stores the row's output count at row_ptr[i + 1] for the prefix sum
+void spgemm_count_task(void *ctx, int worker, int begin, int end) {
+  SpgemmJob *job = (SpgemmJob *)ctx;
+  const CsrMatrix *a = job->a, *b = job->b;
+  int *marker = job->marker + (size_t)worker * b->cols;
+
+  for (int i = begin; i < end; i++) {
+    long long count = 0;
+    for (long long p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+      int k = a->col_idx[p];
+      for (long long q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+        if (marker[b->col_idx[q]] != i) {
+          marker[b->col_idx[q]] = i;
+          count++;
+        }
+      }
+    }
+    job->c->row_ptr[i + 1] = count;
+  }
+}
+
+void spgemm_fill_task(void *ctx, int worker, int begin, int end) {
+  SpgemmJob *job = (SpgemmJob *)ctx;
+  const CsrMatrix *a = job->a, *b = job->b;
+  CsrMatrix *c = job->c;
+  int *marker = job->marker + (size_t)worker * b->cols;
+  double *acc = job->acc + (size_t)worker * b->cols;
+
+  for (int i = begin; i < end; i++) {
+    long long start = c->row_ptr[i], out = start;
+    for (long long p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+      int k = a->col_idx[p];
+      double v = a->values[p];
+      for (long long q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+        int j = b->col_idx[q];
+        if (marker[j] != i) {
+          marker[j] = i;
+          c->col_idx[out++] = j;
+        }
+        acc[j] += v * b->values[q];
+      }
+    }
+
+    qsort(c->col_idx + start, out - start, sizeof(int), compare_ints);
+    for (long long p = start; p < out; p++) {
+      c->values[p] = acc[c->col_idx[p]];
+      acc[c->col_idx[p]] = 0.0;
+    }
+  }
+}
+
+int compare_ints(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+size_t csr_bytes(const CsrMatrix *csr) {
+  return ((size_t)csr->rows + 1) * sizeof(long long) +
+         (size_t)csr->nnz * (sizeof(int) + sizeof(double));
+}
+
+// About density * cols random columns per row, built through COO
+Status generate_random_sparse(CsrMatrix *csr, int rows, int cols,
+                              double density, unsigned int *seed) {
+  CooMatrix coo;
+  if (coo_init(&coo, rows, cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  int per_row = (int)(density * cols + 0.5);
+  if (per_row < 1)
+    per_row = 1;
+
+  for (int i = 0; i < rows; i++) {
+    for (int e = 0; e < per_row; e++) {
+      int col = (int)(((next_seed(seed) << 15) | next_seed(seed)) % cols);
+      double value = (double)(next_seed(seed) & 0x7fff) / 16384.0 - 1.0;
+      if (coo_push(&coo, i, col, value) != SUCCESS) {
+        coo_free(&coo);
+        return ERR_MEMORY_ALLOCATION;
+      }
+    }
+  }
+
+  Status status = csr_from_coo(&coo, csr);
+  coo_free(&coo);
+
+  return status;
+}
+
+void expr_init(Expr *e) { e->count = 0; }
+
+// Node constructors return -1 once the arena is full or a child is -1
+int expr_leaf(Expr *e, const Matrix *mat) {
+  if (e->count >= MAX_EXPR_NODES)
+    return -1;
+  ExprNode *node = &e->nodes[e->count];
+  node->kind = EXPR_MATRIX;
+  node->mat = mat;
+  node->value = 0.0;
+  node->left = node->right = -1;
+  return e->count++;
+}
+
+int expr_const(Expr *e, double value) {
+  if (e->count >= MAX_EXPR_NODES)
+    return -1;
+  ExprNode *node = &e->nodes[e->count];
+  node->kind = EXPR_CONST;
+  node->mat = NULL;
+  node->value = value;
+  node->left = node->right = -1;
+  return e->count++;
+}
+
+int expr_add(Expr *e, int left, int right) {
+  if (left < 0 || right < 0 || e->count >= MAX_EXPR_NODES)
+    return -1;
+  ExprNode *node = &e->nodes[e->count];
+  node->kind = EXPR_ADD;
+  node->mat = NULL;
+  node->value = 0.0;
+  node->left = left;
+  node->right = right;
+  return e->count++;
+}
+
+int expr_sub(Expr *e, int left, int right) {
+  int node = expr_add(e, left, right);
+  if (node >= 0)
+    e->nodes[node].kind = EXPR_SUB;
+  return node;
+}
+
+int expr_scale(Expr *e, int child, double factor) {
+  if (child < 0 || e->count >= MAX_EXPR_NODES)
+    return -1;
+  ExprNode *node = &e->nodes[e->count];
+  node->kind = EXPR_SCALE;
+  node->mat = NULL;
+  node->value = factor;
+  node->left = child;
+  node->right = -1;
+  return e->count++;
+}
+
+/*
+ * Pushes coef * (subtree) into lc. Repeated operands are merged, so
+ * "A + A - 3*A" ends up as a single term.
+ */
+Status expr_flatten(const Expr *e, int node, double coef,
+                    LinearCombination *lc) {
+  const ExprNode *n = &e->nodes[node];
+  Status status;
+
+  switch (n->kind) {
+  case EXPR_MATRIX:
+    if (lc->count == 0 && lc->rows == 0) {
+      lc->rows = n->mat->rows;
+      lc->cols = n->mat->cols;
+    } else if (n->mat->rows != lc->rows || n->mat->cols != lc->cols) {
+      return ERR_INCOMPATIBLE_DIM;
+    }
+    for (int k = 0; k < lc->count; k++) {
+      if (lc->terms[k].mat->data == n->mat->data) {
+        lc->terms[k].coef += coef;
+        return SUCCESS;
+      }
+    }
+    if (lc->count >= MAX_EXPR_TERMS) {
+      return ERR_INVALID_INPUT;
+    }
+    lc->terms[lc->count].mat = n->mat;
+    lc->terms[lc->count].coef = coef;
+    lc->count++;
+    return SUCCESS;
+  case EXPR_CONST:
+    // A bare scalar added to a matrix has no element-wise meaning here
+    return ERR_INVALID_INPUT;
+  case EXPR_ADD:
+  case EXPR_SUB:
+    status = expr_flatten(e, n->left, coef, lc);
+    if (status != SUCCESS)
+      return status;
+    return expr_flatten(e, n->right, n->kind == EXPR_SUB ? -coef : coef, lc);
+  case EXPR_SCALE:
+    return expr_flatten(e, n->left, coef * n->value, lc);
+  }
+  return ERR_INVALID_INPUT;
+}
+
+Status expr_evaluate(const Expr *e, int root, Matrix *result) {
+  LinearCombination lc;
+  lc.count = lc.rows = lc.cols = 0;
+
+  Status status = expr_flatten(e, root, 1.0, &lc);
+  if (status != SUCCESS) {
+    return status;
+  }
+  if (alloc_matrix(result, lc.rows, lc.cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  ExprEvalJob job = {&lc, result};
+  parallel_for(&worker_pool, lc.rows, ROW_GRAIN, expr_eval_task, &job);
+
+  return SUCCESS;
+}
+
+/*
+ * Evaluates into an existing matrix, which may itself be an operand:
+ * that term is moved to the front so it is read before it is
+ * overwritten, and with coefficient 1 it is just accumulated into.
+ */
+Status expr_evaluate_into(const Expr *e, int root, Matrix *dest) {
+  LinearCombination lc;
+  lc.count = lc.rows = lc.cols = 0;
+
+  Status status = expr_flatten(e, root, 1.0, &lc);
+  if (status != SUCCESS) {
+    return status;
+  }
+  if (lc.rows != dest->rows || lc.cols != dest->cols) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
+
+  for (int k = 1; k < lc.count; k++) {
+    if (lc.terms[k].mat->data == dest->data) {
+      ExprTerm t = lc.terms[0];
+      lc.terms[0] = lc.terms[k];
+      lc.terms[k] = t;
+      break;
+    }
+  }
+
+  ExprEvalJob job = {&lc, dest};
+  parallel_for(&worker_pool, lc.rows, ROW_GRAIN, expr_eval_task, &job);
+
+  return SUCCESS;
+}
+
+// Column blocks keep the output slice in L1 while each operand streams by
+void expr_eval_task(void *ctx, int worker, int begin, int end) {
+  ExprEvalJob *job = (ExprEvalJob *)ctx;
+  const LinearCombination *lc = job->lc;
+  int cols = lc->cols;
+  (void)worker;
+
+  for (int i = begin; i < end; i++) {
+    double *out = MAT_ROW(job->dest, i);
+
+    for (int j0 = 0; j0 < cols; j0 += EXPR_BLOCK) {
+      int j1 = cols - j0 < EXPR_BLOCK ? cols : j0 + EXPR_BLOCK;
+      const double *first = MAT_ROW(lc->terms[0].mat, i);
+      double c0 = lc->terms[0].coef;
+
+      // Accumulating into an operand skips rewriting the first term
+      if (first != out || c0 != 1.0) {
+        for (int j = j0; j < j1; j++) {
+          out[j] = c0 * first[j];
+        }
+      }
+
+      for (int k = 1; k < lc->count; k++) {
+        const double *src = MAT_ROW(lc->terms[k].mat, i);
+        double c = lc->terms[k].coef;
+        for (int j = j0; j < j1; j++) {
+          out[j] += c * src[j];
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Recursive descent over
+ *   expr   := term (('+' | '-') term)*
+ *   term   := factor ('*' factor)*
+ *   factor := number | name | '(' expr ')' | '-' factor
+ * A '*' needs a scalar on at least one side; constant subtrees fold.
+ */
+int parse_expression(ExprParser *p) {
+  int node = parse_term(p);
+
+  while (node >= 0) {
+    skip_spaces(p);
+    char op = p->text[p->pos];
+    if (op != '+' && op != '-')
+      break;
+    p->pos++;
+    int rhs = parse_term(p);
+    node = op == '+' ? expr_add(p->expr, node, rhs)
+                     : expr_sub(p->expr, node, rhs);
+  }
+
+  if (node < 0 && p->status == SUCCESS)
+    p->status = ERR_INVALID_INPUT;
+  return node;
+}
+
+int parse_term(ExprParser *p) {
+  int node = parse_factor(p);
+
+  while (node >= 0) {
+    skip_spaces(p);
+    if (p->text[p->pos] != '*')
+      break;
+    p->pos++;
+    int rhs = parse_factor(p);
+    if (rhs < 0)
+      return -1;
+
+    const ExprNode *l = &p->expr->nodes[node];
+    const ExprNode *r = &p->expr->nodes[rhs];
+    if (l->kind == EXPR_CONST && r->kind == EXPR_CONST) {
+      node = expr_const(p->expr, l->value * r->value);
+    } else if (l->kind == EXPR_CONST) {
+      node = expr_scale(p->expr, rhs, l->value);
+    } else if (r->kind == EXPR_CONST) {
+      node = expr_scale(p->expr, node, r->value);
+    } else {
+      // Matrix * matrix is not element-wise; that is option 3
+      p->status = ERR_INVALID_INPUT;
+      return -1;
+    }
+  }
+  return node;
+}
+
+int parse_factor(ExprParser *p) {
+  skip_spaces(p);
+  const char *at = p->text + p->pos;
+
+  if (*at == '(') {
+    p->pos++;
+    int node = parse_expression(p);
+    skip_spaces(p);
+    if (node < 0 || p->text[p->pos] != ')') {
+      if (p->status == SUCCESS)
+        p->status = ERR_INVALID_INPUT;
+      return -1;
+    }
+    p->pos++;
+    return node;
+  }
+
+  if (*at == '-') {
+    p->pos++;
+    int child = parse_factor(p);
+    if (child < 0)
+      return -1;
+    if (p->expr->nodes[child].kind == EXPR_CONST)
+      return expr_const(p->expr, -p->expr->nodes[child].value);
+    return expr_scale(p->expr, child, -1.0);
+  }
+
+  if (isdigit((unsigned char)*at) || *at == '.') {
+    char *end;
+    double value = strtod(at, &end);
+    p->pos += (int)(end - at);
+    return expr_const(p->expr, value);
+  }
+
+  if (isalpha((unsigned char)*at) || *at == '_') {
+    char name[MAX_NAME_LEN];
+    int len = 0;
+    while (isalnum((unsigned char)at[len]) || at[len] == '_') {
+      if (len < MAX_NAME_LEN - 1)
+        name[len] = at[len];
+      len++;
+    }
+    name[len < MAX_NAME_LEN - 1 ? len : MAX_NAME_LEN - 1] = '\0';
+    p->pos += len;
+
+    Matrix *m;
+    if (get_matrix_by_name(p->sys, name, &m) != SUCCESS) {
+      p->status = ERR_MATRIX_NOT_FOUND;
+      return -1;
+    }
+    return expr_leaf(p->expr, m);
+  }
+
+  p->status = ERR_INVALID_INPUT;
+  return -1;
+}
+
+void skip_spaces(ExprParser *p) {
+  while (isspace((unsigned char)p->text[p->pos])) {
+    p->pos++;
+  }
+}
+
+void run_gemm_benchmark(void) {
+  int max_size = 0;
+
+  printf("\n=== GEMM Benchmark (kernel: %s) ===\n", gemm_kernel_name);
+  printf("Largest size (default %d): ", DEFAULT_BENCH_MAX_SIZE);
+  if (read_integer(&max_size) != SUCCESS || max_size < BENCH_MIN_SIZE) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_MAX_SIZE);
+    max_size = DEFAULT_BENCH_MAX_SIZE;
+  }
+
+  printf("\n  %-7s %-12s %-12s %-12s %-12s %s\n", "N", "Naive (s)",
+         "Naive GF/s", "Blocked (s)", "Blocked GF/s", "Max diff");
+
+  unsigned int seed = 12345;
+  for (int n = BENCH_MIN_SIZE; n <= max_size; n *= 2) {
+    Matrix a, b, fast, slow;
+    if (alloc_matrix(&a, n, n) != SUCCESS) {
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    if (alloc_matrix(&b, n, n) != SUCCESS) {
+      free_matrix_data(&a);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    fill_random_matrix(&a, &seed);
+    fill_random_matrix(&b, &seed);
+
+    double flops = 2.0 * n * n * n;
+    double start = get_time_seconds();
+    Status st = multiply_matrices(&a, &b, &fast);
+    double blocked_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      free_matrix_data(&a);
+      free_matrix_data(&b);
+      handle_error(st);
+      return;
+    }
+
+    printf("  %-7d ", n);
+    if (n <= NAIVE_BENCH_LIMIT) {
+      start = get_time_seconds();
+      st = multiply_matrices_naive(&a, &b, &slow);
+      double naive_time = get_time_seconds() - start;
+      if (st != SUCCESS) {
+        printf("\n");
+        free_matrix_data(&a);
+        free_matrix_data(&b);
+        free_matrix_data(&fast);
+        handle_error(st);
+        return;
+      }
+
+      double max_diff = 0.0;
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          double d = MAT_AT(&fast, i, j) - MAT_AT(&slow, i, j);
+          if (d < 0)
+            d = -d;
+          if (d > max_diff)
+            max_diff = d;
+        }
+      }
+      free_matrix_data(&slow);
+
+      printf("%-12.4f %-12.2f ", naive_time, flops / naive_time / 1e9);
+      printf("%-12.4f %-12.2f %.2e\n", blocked_time,
+             flops / blocked_time / 1e9, max_diff);
+    } else {
+      printf("%-12s %-12s ", "-", "-");
+      printf("%-12.4f %-12.2f %s\n", blocked_time, flops / blocked_time / 1e9,
+             "-");
+    }
+
+    free_matrix_data(&a);
+    free_matrix_data(&b);
+    free_matrix_data(&fast);
+  }
+  printf("\n  (Naive loop skipped above %d to keep the run short)\n\n",
+         NAIVE_BENCH_LIMIT);
+}
+
+Status multiply_matrices_naive(const Matrix *a, const Matrix *b,
+                               Matrix *result) {
+  if (a->cols != b->rows) {
+    return ERR_INCOMPATIBLE_DIM;
+  }
+
+  if (alloc_matrix(result, a->rows, b->cols) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < result->rows; i++) {
+    for (int j = 0; j < result->cols; j++) {
+      double sum = 0;
+      for (int k = 0; k < a->cols; k++) {
+        sum += MAT_AT(a, i, k) * MAT_AT(b, k, j);
+      }
+      MAT_AT(result, i, j) = sum;
+    }
+  }
+  return SUCCESS;
+}
+
+/*
+ * Goto-style loop nest: C must be zeroed, the product is accumulated.
+ * For every KC x NC panel of B, the packing and then the MC-row blocks
+ * of C are spread over the worker pool; each worker packs A into its
+ * own buffer. Partial edge tiles are computed into a scratch tile and
+ * then added into C, so the micro-kernel never needs bounds checks.
+ */
+Status gemm_blocked(const Matrix *a, const Matrix *b, Matrix *c) {
+  int m = a->rows, n = b->cols, k = a->cols;
+  int workers = worker_pool.num_threads;
+  void *pa = NULL, *pb = NULL;
+
+  if (posix_memalign(&pa, MATRIX_ALIGNMENT,
+                     (size_t)workers * GEMM_MC * GEMM_KC * sizeof(double)) !=
+      0) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  int nc_max = n < GEMM_NC ? n : GEMM_NC;
+  int nc_padded = (nc_max + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+  if (posix_memalign(&pb, MATRIX_ALIGNMENT,
+                     (size_t)GEMM_KC * nc_padded * sizeof(double)) != 0) {
+    free(pa);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  GemmJob job = {a, b, c, (double *)pa, (double *)pb, 0, 0, 0, 0};
+  int row_blocks = (m + GEMM_MC - 1) / GEMM_MC;
+
+  for (job.jc = 0; job.jc < n; job.jc += GEMM_NC) {
+    job.nc = n - job.jc < GEMM_NC ? n - job.jc : GEMM_NC;
+    int slivers = (job.nc + GEMM_NR - 1) / GEMM_NR;
+
+    for (job.pc = 0; job.pc < k; job.pc += GEMM_KC) {
+      job.kc = k - job.pc < GEMM_KC ? k - job.pc : GEMM_KC;
+      parallel_for(&worker_pool, slivers, GEMM_MC / GEMM_NR,
+                   gemm_pack_b_task, &job);
+      parallel_for(&worker_pool, row_blocks, 1, gemm_block_task, &job);
+    }
+  }
+
+  free(pa);
+  free(pb);
+
+  return SUCCESS;
+}
+
+void gemm_pack_b_task(void *ctx, int worker, int begin, int end) {
+  GemmJob *job = (GemmJob *)ctx;
+  (void)worker;
+
+  int col0 = begin * GEMM_NR;
+  int cols = end * GEMM_NR < job->nc ? end * GEMM_NR - col0 : job->nc - col0;
+  pack_panel_b(job->b, job->pc, job->jc + col0, job->kc, cols,
+               job->packed_b + (size_t)col0 * job->kc);
+}
+
+void gemm_block_task(void *ctx, int worker, int begin, int end) {
+  GemmJob *job = (GemmJob *)ctx;
+  Matrix *c = job->c;
+  int m = job->a->rows, kc = job->kc, nc = job->nc;
+  double *packed_a = job->packed_a + (size_t)worker * GEMM_MC * GEMM_KC;
+  double tile[GEMM_MR * GEMM_NR] __attribute__((aligned(MATRIX_ALIGNMENT)));
+
+  for (int blk = begin; blk < end; blk++) {
+    int ic = blk * GEMM_MC;
+    int mc = m - ic < GEMM_MC ? m - ic : GEMM_MC;
+    pack_panel_a(job->a, ic, job->pc, mc, kc, packed_a);
+
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+      int nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+
+      for (int ir = 0; ir < mc; ir += GEMM_MR) {
+        int mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+        const double *ap = packed_a + (size_t)ir * kc;
+        const double *bp = job->packed_b + (size_t)jr * kc;
+        double *cp = &MAT_AT(c, ic + ir, job->jc + jr);
+
+        if (mr == GEMM_MR && nr == GEMM_NR) {
+          gemm_kernel(kc, ap, bp, cp, c->stride);
+          continue;
+        }
+
+        memset(tile, 0, sizeof(tile));
+        gemm_kernel(kc, ap, bp, tile, GEMM_NR);
+        for (int i = 0; i < mr; i++) {
+          for (int j = 0; j < nr; j++) {
+            cp[(size_t)i * c->stride + j] += tile[i * GEMM_NR + j];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Rows of A are packed into MR-tall slivers, zero-padded at the edge
+void pack_panel_a(const Matrix *a, int row0, int col0, int mc, int kc,
+                  double *packed) {
+  for (int ir = 0; ir < mc; ir += GEMM_MR) {
+    int mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < GEMM_MR; i++) {
+        *packed++ = i < mr ? MAT_AT(a, row0 + ir + i, col0 + p) : 0.0;
+      }
+    }
+  }
+}
+
+// Columns of B are packed into NR-wide slivers, zero-padded at the edge
+void pack_panel_b(const Matrix *b, int row0, int col0, int kc, int nc,
+                  double *packed) {
+  for (int jr = 0; jr < nc; jr += GEMM_NR) {
+    int nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+    for (int p = 0; p < kc; p++) {
+      const double *src = &MAT_AT(b, row0 + p, col0 + jr);
+      for (int j = 0; j < GEMM_NR; j++) {
+        *packed++ = j < nr ? src[j] : 0.0;
+      }
+    }
+  }
+}
+
+void micro_kernel_scalar(int kc, const double *a, const double *b, double *c,
+                         int ldc) {
+  double acc[GEMM_MR][GEMM_NR] = {{0}};
+
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < GEMM_MR; i++) {
+      double av = a[i];
+      for (int j = 0; j < GEMM_NR; j++) {
+        acc[i][j] += av * b[j];
+      }
+    }
+    a += GEMM_MR;
+    b += GEMM_NR;
+  }
+
+  for (int i = 0; i < GEMM_MR; i++) {
+    for (int j = 0; j < GEMM_NR; j++) {
+      c[(size_t)i * ldc + j] += acc[i][j];
+    }
+  }
+}
+
+#ifdef HAVE_X86_SIMD
+// 6x8 tile held in 12 ymm accumulators, one broadcast per row of A
+__attribute__((target("avx2,fma"))) void
+micro_kernel_avx2(int kc, const double *a, const double *b, double *c,
+                  int ldc) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_load_pd(b);
+    __m256d b1 = _mm256_load_pd(b + 4);
+    __m256d av;
+
+    av = _mm256_broadcast_sd(a + 0);
+    c00 = _mm256_fmadd_pd(av, b0, c00);
+    c01 = _mm256_fmadd_pd(av, b1, c01);
+    av = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(av, b0, c10);
+    c11 = _mm256_fmadd_pd(av, b1, c11);
+    av = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(av, b0, c20);
+    c21 = _mm256_fmadd_pd(av, b1, c21);
+    av = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(av, b0, c30);
+    c31 = _mm256_fmadd_pd(av, b1, c31);
+    av = _mm256_broadcast_sd(a + 4);
+    c40 = _mm256_fmadd_pd(av, b0, c40);
+    c41 = _mm256_fmadd_pd(av, b1, c41);
+    av = _mm256_broadcast_sd(a + 5);
+    c50 = _mm256_fmadd_pd(av, b0, c50);
+    c51 = _mm256_fmadd_pd(av, b1, c51);
+
+    a += GEMM_MR;
+    b += GEMM_NR;
+  }
+
+  __m256d acc[GEMM_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                             {c30, c31}, {c40, c41}, {c50, c51}};
+  for (int i = 0; i < GEMM_MR; i++) {
+    double *row = c + (size_t)i * ldc;
+    _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), acc[i][0]));
+    _mm256_storeu_pd(row + 4,
+                     _mm256_add_pd(_mm256_loadu_pd(row + 4), acc[i][1]));
+  }
+}
+
+// Unpack pairs within 128-bit lanes, then swap the lanes across rows
+__attribute__((target("avx"))) void transpose_4x4_avx(const double *src,
+                                                       int lds, double *dst,
+                                                       int ldd) {
+  __m256d r0 = _mm256_loadu_pd(src);
+  __m256d r1 = _mm256_loadu_pd(src + lds);
+  __m256d r2 = _mm256_loadu_pd(src + 2 * (size_t)lds);
+  __m256d r3 = _mm256_loadu_pd(src + 3 * (size_t)lds);
+
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+  _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(dst + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(dst + 2 * (size_t)ldd,
+                   _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(dst + 3 * (size_t)ldd,
+                   _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+__attribute__((target("avx"))) void swap_transpose_4x4_avx(double *a,
+                                                            double *b,
+                                                            int ld) {
+  __m256d a0 = _mm256_loadu_pd(a);
+  __m256d a1 = _mm256_loadu_pd(a + ld);
+  __m256d a2 = _mm256_loadu_pd(a + 2 * (size_t)ld);
+  __m256d a3 = _mm256_loadu_pd(a + 3 * (size_t)ld);
+  __m256d b0 = _mm256_loadu_pd(b);
+  __m256d b1 = _mm256_loadu_pd(b + ld);
+  __m256d b2 = _mm256_loadu_pd(b + 2 * (size_t)ld);
+  __m256d b3 = _mm256_loadu_pd(b + 3 * (size_t)ld);
+
+  __m256d t0 = _mm256_unpacklo_pd(a0, a1);
+  __m256d t1 = _mm256_unpackhi_pd(a0, a1);
+  __m256d t2 = _mm256_unpacklo_pd(a2, a3);
+  __m256d t3 = _mm256_unpackhi_pd(a2, a3);
+  __m256d u0 = _mm256_unpacklo_pd(b0, b1);
+  __m256d u1 = _mm256_unpackhi_pd(b0, b1);
+  __m256d u2 = _mm256_unpacklo_pd(b2, b3);
+  __m256d u3 = _mm256_unpackhi_pd(b2, b3);
+
+  _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(b + ld, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(b + 2 * (size_t)ld, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(b + 3 * (size_t)ld, _mm256_permute2f128_pd(t1, t3, 0x31));
+  _mm256_storeu_pd(a, _mm256_permute2f128_pd(u0, u2, 0x20));
+  _mm256_storeu_pd(a + ld, _mm256_permute2f128_pd(u1, u3, 0x20));
+  _mm256_storeu_pd(a + 2 * (size_t)ld, _mm256_permute2f128_pd(u0, u2, 0x31));
+  _mm256_storeu_pd(a + 3 * (size_t)ld, _mm256_permute2f128_pd(u1, u3, 0x31));
+}
+#endif
+
+void select_simd_kernels(void) {
+  gemm_kernel = micro_kernel_scalar;
+  gemm_kernel_name = "scalar";
+  transpose_kernel = transpose_4x4_scalar;
+  swap_kernel = swap_transpose_4x4_scalar;
+  transpose_kernel_name = "scalar";
+
+#ifdef HAVE_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    gemm_kernel = micro_kernel_avx2;
+    gemm_kernel_name = "AVX2/FMA";
+  }
+  if (__builtin_cpu_supports("avx")) {
+    transpose_kernel = transpose_4x4_avx;
+    swap_kernel = swap_transpose_4x4_avx;
+    transpose_kernel_name = "AVX";
+  }
+#endif
+}
+
+void fill_random_matrix(Matrix *mat, unsigned int *seed) {
+  for (int i = 0; i < mat->rows; i++) {
+    double *row = MAT_ROW(mat, i);
+    for (int j = 0; j < mat->cols; j++) {
+      row[j] = (double)(next_seed(seed) & 0x7fff) / 16384.0 - 1.0;
+    }
+  }
+}
+
+// Classic LCG, returns 15 usable bits like rand()
+unsigned int next_seed(unsigned int *seed) {
+  *seed = *seed * 1103515245u + 12345u;
+  return (*seed >> 16) & 0x7fff;
+}
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void run_set_threads(void) {
+  int threads = 0;
+
+  printf("\nWorker threads (1-%d, current %d): ", MAX_THREADS,
+         worker_pool.num_threads);
+  if (read_integer(&threads) != SUCCESS || threads < 1 ||
+      threads > MAX_THREADS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  pool_destroy(&worker_pool);
+  if (pool_init(&worker_pool, threads) != SUCCESS) {
+    handle_error(ERR_THREAD_CREATION);
+    pool_init(&worker_pool, 1);
+  }
+  printf("\nUsing %d worker thread(s)\n\n", worker_pool.num_threads);
+}
+
+void run_scaling_benchmark(void) {
+  int n = 0;
+
+  printf("\n=== Thread Scaling Benchmark ===\n");
+  printf("Matrix size N (default %d): ", DEFAULT_SCALING_SIZE);
+  if (read_integer(&n) != SUCCESS || n < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_SCALING_SIZE);
+    n = DEFAULT_SCALING_SIZE;
+  }
+  int max_threads = read_max_threads();
+  int saved_threads = worker_pool.num_threads;
+
+  Matrix a, b, reference;
+  unsigned int seed = 2024;
+  if (alloc_matrix(&a, n, n) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  if (alloc_matrix(&b, n, n) != SUCCESS) {
+    free_matrix_data(&a);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  fill_random_matrix(&a, &seed);
+  fill_random_matrix(&b, &seed);
+  reference.data = NULL;
+
+  printf("\n  %-8s %-11s %-10s %-9s %-11s %-13s %s\n", "Threads", "GEMM (s)",
+         "GFLOP/s", "Speedup", "Add (s)", "Transpose (s)", "Check");
+
+  double base_time = 0.0;
+  for (int threads = 1; threads <= max_threads;) {
+    pool_destroy(&worker_pool);
+    if (pool_init(&worker_pool, threads) != SUCCESS) {
+      handle_error(ERR_THREAD_CREATION);
+      pool_init(&worker_pool, 1);
+      break;
+    }
+
+    Matrix product, sum, trans;
+    double start = get_time_seconds();
+    Status st = multiply_matrices(&a, &b, &product);
+    double gemm_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      handle_error(st);
+      break;
+    }
+
+    start = get_time_seconds();
+    st = add_matrices(&a, &b, &sum);
+    double add_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      free_matrix_data(&product);
+      handle_error(st);
+      break;
+    }
+
+    start = get_time_seconds();
+    st = transpose_matrix(&a, &trans);
+    double transpose_time = get_time_seconds() - start;
+    free_matrix_data(&sum);
+    if (st != SUCCESS) {
+      free_matrix_data(&product);
+      handle_error(st);
+      break;
+    }
+    free_matrix_data(&trans);
+
+    int ok = TRUE;
+    if (reference.data == NULL) {
+      reference = product;
+      base_time = gemm_time;
+    } else {
+      ok = memcmp(reference.data, product.data,
+                  (size_t)n * product.stride * sizeof(double)) == 0;
+      free_matrix_data(&product);
+    }
+
+    printf("  %-8d %-11.4f %-10.2f %-9.2f %-11.4f %-13.4f %s\n", threads,
+           gemm_time, 2.0 * n * n * n / gemm_time / 1e9,
+           base_time / gemm_time, add_time, transpose_time,
+           ok ? "OK" : "MISMATCH");
+
+    if (threads == max_threads)
+      break;
+    threads = (threads * 2 > max_threads) ? max_threads : threads * 2;
+  }
+  printf("\n");
+
+  if (reference.data != NULL)
+    free_matrix_data(&reference);
+  free_matrix_data(&a);
+  free_matrix_data(&b);
+
+  pool_destroy(&worker_pool);
+  if (pool_init(&worker_pool, saved_threads) != SUCCESS) {
+    handle_error(ERR_THREAD_CREATION);
+    pool_init(&worker_pool, 1);
+  }
+}
+
+int read_max_threads(void) {
+  int max_threads = 0;
+  int online = default_thread_count();
+
+  printf("Max threads (default %d): ", online);
+  if (read_integer(&max_threads) != SUCCESS || max_threads < 1) {
+    max_threads = online;
+  }
+  if (max_threads > MAX_THREADS) {
+    max_threads = MAX_THREADS;
+  }
+  return max_threads;
+}
+
+int default_thread_count(void) {
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+  if (online < 1)
+    return 1;
+  return online > MAX_THREADS ? MAX_THREADS : (int)online;
+}
+
+Status pool_init(WorkerPool *pool, int num_threads) {
+  pool->num_threads = 1;
+  pool->generation = 0;
+  pool->busy = 0;
+  pool->shutdown = FALSE;
+  pool->fn = NULL;
+  pool->ctx = NULL;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  // Thread 0 is always the caller of parallel_for
+  for (int t = 1; t < num_threads; t++) {
+    pool->workers[t].pool = pool;
+    pool->workers[t].id = t;
+    if (pthread_create(&pool->threads[t], NULL, pool_worker_main,
+                       &pool->workers[t]) != 0) {
+      pool_destroy(pool);
+      return ERR_THREAD_CREATION;
+    }
+    pool->num_threads = t + 1;
+  }
+
+  return SUCCESS;
+}
+
+void pool_destroy(WorkerPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = TRUE;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int t = 1; t < pool->num_threads; t++) {
+    pthread_join(pool->threads[t], NULL);
+  }
+
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->start);
+  pthread_cond_destroy(&pool->done);
+  pool->num_threads = 0;
+}
+
+void *pool_worker_main(void *arg) {
+  PoolWorker *self = (PoolWorker *)arg;
+  WorkerPool *pool = self->pool;
+  unsigned long seen = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  while (TRUE) {
+    while (!pool->shutdown && pool->generation == seen) {
+      pthread_cond_wait(&pool->start, &pool->lock);
+    }
+    if (pool->shutdown)
+      break;
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_run_tasks(pool, self->id);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busy == 0) {
+      pthread_cond_signal(&pool->done);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  return NULL;
+}
+
+void pool_run_tasks(WorkerPool *pool, int worker) {
+  while (TRUE) {
+    int begin = __atomic_fetch_add(&pool->next, pool->grain, __ATOMIC_RELAXED);
+    if (begin >= pool->total)
+      break;
+    int end = begin + pool->grain < pool->total ? begin + pool->grain
+                                                : pool->total;
+    pool->fn(pool->ctx, worker, begin, end);
+  }
+}
+
+/*
+ * Runs fn over [0, total) in grain-sized chunks and returns once every
+ * chunk is done. Jobs that fit in one chunk skip the pool entirely.
+ */
+void parallel_for(WorkerPool *pool, int total, int grain, TaskFn fn,
+                  void *ctx) {
+  if (total <= 0)
+    return;
+  if (grain < 1)
+    grain = 1;
+  if (pool->num_threads <= 1 || total <= grain) {
+    fn(ctx, 0, 0, total);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  pool->fn = fn;
+  pool->ctx = ctx;
+  pool->total = total;
+  pool->grain = grain;
+  pool->next = 0;
+  pool->busy = pool->num_threads - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  pool_run_tasks(pool, 0);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->busy > 0) {
+    pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void run_inverse(MatrixSystem *sys) {
+  char name[MAX_NAME_LEN];
+  Matrix *m;
+  Matrix inverse;
+
+  list_available_matrices(sys);
+
+  printf("\nInvert matrix: ");
+  read_name(name);
+
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
+    handle_error(ERR_MATRIX_NOT_FOUND);
+    return;
+  }
+
+  Status status = invert_matrix(m, &inverse);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\nMatrix %s^-1 (%dx%d):\n\n", name, inverse.rows, inverse.cols);
+  print_matrix(&inverse);
+  printf("\n");
+  free_matrix_data(&inverse);
+}
+
+void run_solve(MatrixSystem *sys) {
+  char name1[MAX_NAME_LEN], name2[MAX_NAME_LEN];
+  Matrix *a, *b;
+  Matrix x;
+
+  list_available_matrices(sys);
+
+  printf("\nCoefficient matrix A: ");
+  read_name(name1);
+  printf("Right-hand side B: ");
+  read_name(name2);
+
+  if (get_matrix_by_name(sys, name1, &a) != SUCCESS ||
+      get_matrix_by_name(sys, name2, &b) != SUCCESS) {
+    handle_error(ERR_MATRIX_NOT_FOUND);
+    return;
+  }
+
+  Status status = solve_linear_system(a, b, &x);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\nSolution X of %s * X = %s (%dx%d):\n\n", name1, name2, x.rows,
+         x.cols);
+  print_matrix(&x);
+  printf("\n");
+  free_matrix_data(&x);
+}
+
+void run_lu_benchmark(void) {
+  int max_size = 0;
+
+  printf("\n=== LU Benchmark ===\n");
+  printf("Largest size (default %d): ", DEFAULT_LU_MAX_SIZE);
+  if (read_integer(&max_size) != SUCCESS || max_size < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_LU_MAX_SIZE);
+    max_size = DEFAULT_LU_MAX_SIZE;
+  }
+
+  printf("\n  %-7s %-11s %-9s %-11s %-13s %s\n", "N", "LU (s)", "GFLOP/s",
+         "Solve (s)", "Inverse (s)", "Residual");
+
+  unsigned int seed = 777;
+  int sizes[] = {125, 250, 500, 1000, 2000, 4000, 8000};
+  int num_sizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+  for (int s = 0; s < num_sizes && sizes[s] <= max_size; s++) {
+    int n = sizes[s];
+    Matrix a, b, x, ax, inverse;
+    LuFactor f;
+
+    if (alloc_matrix(&a, n, n) != SUCCESS) {
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    if (alloc_matrix(&b, n, 1) != SUCCESS) {
+      free_matrix_data(&a);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    fill_random_matrix(&a, &seed);
+    fill_random_matrix(&b, &seed);
+
+    double start = get_time_seconds();
+    Status st = lu_decompose(&a, &f);
+    double lu_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      free_matrix_data(&a);
+      free_matrix_data(&b);
+      handle_error(st);
+      return;
+    }
+    lu_free(&f);
+
+    start = get_time_seconds();
+    st = solve_linear_system(&a, &b, &x);
+    double solve_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      free_matrix_data(&a);
+      free_matrix_data(&b);
+      handle_error(st);
+      return;
+    }
+
+    // Scaled residual ||A*x - b|| / (||A|| * ||x||), infinity norms
+    double residual = 0.0;
+    if (multiply_matrices(&a, &x, &ax) == SUCCESS) {
+      double r_norm = 0.0, a_norm = 0.0, x_norm = 0.0;
+      for (int i = 0; i < n; i++) {
+        double r = MAT_AT(&ax, i, 0) - MAT_AT(&b, i, 0);
+        double xv = MAT_AT(&x, i, 0);
+        double row_sum = 0.0;
+        for (int j = 0; j < n; j++) {
+          double v = MAT_AT(&a, i, j);
+          row_sum += v < 0 ? -v : v;
+        }
+        r = r < 0 ? -r : r;
+        xv = xv < 0 ? -xv : xv;
+        if (r > r_norm)
+          r_norm = r;
+        if (xv > x_norm)
+          x_norm = xv;
+        if (row_sum > a_norm)
+          a_norm = row_sum;
+      }
+      residual = r_norm / (a_norm * x_norm);
+      free_matrix_data(&ax);
+    }
+    free_matrix_data(&x);
+
+    start = get_time_seconds();
+    st = invert_matrix(&a, &inverse);
+    double inverse_time = get_time_seconds() - start;
+    if (st == SUCCESS) {
+      free_matrix_data(&inverse);
+    }
+
+    printf("  %-7d %-11.4f %-9.2f %-11.4f %-13.4f %.2e\n", n, lu_time,
+           2.0 / 3.0 * n * n * n / lu_time / 1e9, solve_time, inverse_time,
+           residual);
+
+    free_matrix_data(&a);
+    free_matrix_data(&b);
+  }
+  printf("\n");
+}
+
+void run_transpose_in_place(MatrixSystem *sys) {
+  char name[MAX_NAME_LEN];
+  Matrix *m;
+
+  list_available_matrices(sys);
+
+  printf("\nTranspose in place matrix: ");
+  read_name(name);
+
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
+    handle_error(ERR_MATRIX_NOT_FOUND);
+    return;
+  }
+
+  Status status = transpose_in_place(m);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\nMatrix %s is now its transpose (%dx%d):\n\n", name, m->rows,
+         m->cols);
+  print_matrix(m);
+  printf("\n");
+}
+
+void run_transpose_benchmark(void) {
+  int max_size = 0;
+
+  printf("\n=== Transpose Benchmark (tile kernel: %s) ===\n",
+         transpose_kernel_name);
+  printf("Largest size (default %d): ", DEFAULT_TRANSPOSE_MAX_SIZE);
+  if (read_integer(&max_size) != SUCCESS || max_size < BENCH_MIN_SIZE) {
+    printf("  - Using default (%d).\n", DEFAULT_TRANSPOSE_MAX_SIZE);
+    max_size = DEFAULT_TRANSPOSE_MAX_SIZE;
+  }
+
+  // Reported bandwidth counts one read and one write per element
+  printf("\n  %-7s %-12s %-12s %-12s %-6s\n", "N", "Naive GB/s",
+         "Tiled GB/s", "In-place GB/s", "Check");
+
+  unsigned int seed = 99;
+  for (int n = BENCH_MIN_SIZE * 4; n <= max_size; n *= 2) {
+    int sizes[2] = {n, n + 3};
+
+    for (int v = 0; v < 2; v++) {
+      int size = sizes[v];
+      if (size > max_size)
+        break;
+
+      // Destinations are allocated (and page-faulted in) before timing
+      Matrix a, slow, fast;
+      if (alloc_matrix(&a, size, size) != SUCCESS) {
+        handle_error(ERR_MEMORY_ALLOCATION);
+        return;
+      }
+      if (alloc_matrix(&slow, size, size) != SUCCESS) {
+        free_matrix_data(&a);
+        handle_error(ERR_MEMORY_ALLOCATION);
+        return;
+      }
+      if (alloc_matrix(&fast, size, size) != SUCCESS) {
+        free_matrix_data(&a);
+        free_matrix_data(&slow);
+        handle_error(ERR_MEMORY_ALLOCATION);
+        return;
+      }
+      fill_random_matrix(&a, &seed);
+      double bytes = 2.0 * size * size * sizeof(double);
+
+      double start = get_time_seconds();
+      transpose_naive(&a, &slow);
+      double naive_time = get_time_seconds() - start;
+
+      start = get_time_seconds();
+      transpose_into(&a, &fast);
+      double tiled_time = get_time_seconds() - start;
+
+      start = get_time_seconds();
+      transpose_in_place(&a);
+      double in_place_time = get_time_seconds() - start;
+
+      int ok = TRUE;
+      for (int i = 0; i < size && ok; i++) {
+        ok = memcmp(MAT_ROW(&slow, i), MAT_ROW(&fast, i),
+                    size * sizeof(double)) == 0 &&
+             memcmp(MAT_ROW(&slow, i), MAT_ROW(&a, i),
+                    size * sizeof(double)) == 0;
+      }
+
+      printf("  %-7d %-12.2f %-12.2f %-12.2f %-6s\n", size,
+             bytes / naive_time / 1e9, bytes / tiled_time / 1e9,
+             bytes / in_place_time / 1e9, ok ? "OK" : "MISMATCH");
+
+      free_matrix_data(&a);
+      free_matrix_data(&slow);
+      free_matrix_data(&fast);
+    }
+  }
+  printf("\n");
+}
+
+void run_show_sparse(MatrixSystem *sys) {
+  char name[MAX_NAME_LEN];
+  Matrix *m;
+  CsrMatrix csr;
+
+  list_available_matrices(sys);
+
+  printf("\nShow sparse form of matrix: ");
+  read_name(name);
+
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
+    handle_error(ERR_MATRIX_NOT_FOUND);
+    return;
+  }
+
+  if (csr_from_dense(m, &csr) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  size_t dense_bytes = (size_t)m->rows * m->cols * sizeof(double);
+  printf("\nMatrix %s (%dx%d): %lld nonzeros (%.2f%% dense)\n", name, m->rows,
+         m->cols, csr.nnz, 100.0 * csr.nnz / ((double)m->rows * m->cols));
+  printf("Memory: dense %zu bytes, CSR %zu bytes\n\n", dense_bytes,
+         csr_bytes(&csr));
+
+  if (csr.nnz <= SPARSE_PRINT_LIMIT) {
+    for (int i = 0; i < csr.rows; i++) {
+      printf("Row %d:", i);
+      for (long long p = csr.row_ptr[i]; p < csr.row_ptr[i + 1]; p++) {
+        printf(" (%d, %.2f)", csr.col_idx[p], csr.values[p]);
+      }
+      printf("\n");
+    }
+    printf("\n");
+  }
+
+  csr_free(&csr);
+}
+
+// A * A^T: the product is structurally symmetric, so it has fill-in
+Status csr_multiply_transpose(const CsrMatrix *a, CsrMatrix *c) {
+  CsrMatrix at;
+  Status status = csr_transpose(a, &at);
+  if (status != SUCCESS) {
+    return status;
+  }
+  status = csr_multiply_csr(a, &at, c);
+  csr_free(&at);
+  return status;
+}
+
+void dense_gemv(const Matrix *m, const double *x, double *y) {
+  for (int i = 0; i < m->rows; i++) {
+    const double *row = MAT_ROW(m, i);
+    double sum = 0.0;
+    for (int j = 0; j < m->cols; j++) {
+      sum += row[j] * x[j];
+    }
+    y[i] = sum;
+  }
+}
+
+/*
+ * Checks SPGEMM_CHECK_ROWS evenly spaced rows of product = A * A^T
+ * against dot products of the dense rows of A. A full dense A * A^T
+ * would cost far more than the sparse product being timed. Returns the
+ * largest absolute difference (-1, never the maximum, if the scratch row
+ * cannot be allocated).
+ */
+double spgemm_sample_diff(const CsrMatrix *product, const Matrix *dense) {
+  double *row = (double *)calloc(dense->rows, sizeof(double));
+  if (row == NULL) {
+    return -1.0;
+  }
+
+  double max_diff = 0.0;
+  for (int r = 0; r < SPGEMM_CHECK_ROWS; r++) {
+    int i = (int)((long long)r * dense->rows / SPGEMM_CHECK_ROWS);
+    for (long long p = product->row_ptr[i]; p < product->row_ptr[i + 1];
+         p++) {
+      row[product->col_idx[p]] = product->values[p];
+    }
+
+    for (int j = 0; j < dense->rows; j++) {
+      const double *a_i = MAT_ROW(dense, i);
+      const double *a_j = MAT_ROW(dense, j);
+      double expected = 0.0;
+      for (int k = 0; k < dense->cols; k++) {
+        expected += a_i[k] * a_j[k];
+      }
+      double diff = row[j] - expected;
+      diff = diff < 0 ? -diff : diff;
+      if (diff > max_diff)
+        max_diff = diff;
+      row[j] = 0.0;
+    }
+  }
+
+  free(row);
+  return max_diff;
+}
+
+void run_sparse_benchmark(void) {
+  int n = 0;
+  double densities[] = {0.0005, 0.001, 0.01, 0.05, 0.10, 0.25};
+  int num_densities = (int)(sizeof(densities) / sizeof(densities[0]));
+
+  printf("\n=== Sparse Benchmark ===\n");
+  printf("Matrix size N (default %d): ", DEFAULT_SPARSE_SIZE);
+  if (read_integer(&n) != SUCCESS || n < 16) {
+    printf("  - Using default (%d).\n", DEFAULT_SPARSE_SIZE);
+    n = DEFAULT_SPARSE_SIZE;
+  }
+
+  double *x = (double *)malloc((size_t)n * sizeof(double));
+  double *y = (double *)malloc((size_t)n * sizeof(double));
+  double *y_dense = (double *)malloc((size_t)n * sizeof(double));
+  Matrix rhs;
+  if (x == NULL || y == NULL || y_dense == NULL ||
+      alloc_matrix(&rhs, n, SPARSE_BENCH_RHS) != SUCCESS) {
+    free(x);
+    free(y);
+    free(y_dense);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  unsigned int seed = 4242;
+  for (int i = 0; i < n; i++) {
+    x[i] = (double)(next_seed(&seed) & 0x7fff) / 16384.0 - 1.0;
+  }
+  fill_random_matrix(&rhs, &seed);
+
+  printf("\n  Dense storage: %.1f MB. SpMM multiplies by a %dx%d dense "
+         "block.\n",
+         (double)n * n * sizeof(double) / 1e6, n, SPARSE_BENCH_RHS);
+  printf("\n  %-8s %-10s %-9s %-10s %-10s %-10s %-10s %-11s %s\n",
+         "Density", "nnz", "CSR MB", "SpMV (s)", "GEMV (s)", "SpMM (s)",
+         "GEMM (s)", "A*A^T (s)", "Max diff");
+
+  for (int d = 0; d < num_densities; d++) {
+    CsrMatrix a, squared;
+    Matrix dense, c_sparse, c_dense;
+
+    if (generate_random_sparse(&a, n, n, densities[d], &seed) != SUCCESS) {
+      handle_error(ERR_MEMORY_ALLOCATION);
+      break;
+    }
+    if (csr_to_dense(&a, &dense) != SUCCESS) {
+      csr_free(&a);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      break;
+    }
+
+    // Each kernel runs once untimed first, so the timed run does not pay
+    // for first-touch page faults, cold caches or waking the pool
+    csr_spmv(&a, x, y);
+    double start = get_time_seconds();
+    csr_spmv(&a, x, y);
+    double spmv_time = get_time_seconds() - start;
+
+    dense_gemv(&dense, x, y_dense);
+    start = get_time_seconds();
+    dense_gemv(&dense, x, y_dense);
+    double gemv_time = get_time_seconds() - start;
+
+    double max_diff = 0.0;
+    for (int i = 0; i < n; i++) {
+      double diff = y[i] - y_dense[i];
+      diff = diff < 0 ? -diff : diff;
+      if (diff > max_diff)
+        max_diff = diff;
+    }
+
+    if (csr_multiply_dense(&a, &rhs, &c_sparse) == SUCCESS) {
+      free_matrix_data(&c_sparse);
+    }
+    start = get_time_seconds();
+    Status st = csr_multiply_dense(&a, &rhs, &c_sparse);
+    double spmm_time = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      csr_free(&a);
+      free_matrix_data(&dense);
+      handle_error(st);
+      break;
+    }
+
+    if (multiply_matrices(&dense, &rhs, &c_dense) == SUCCESS) {
+      free_matrix_data(&c_dense);
+    }
+    start = get_time_seconds();
+    st = multiply_matrices(&dense, &rhs, &c_dense);
+    double gemm_time = get_time_seconds() - start;
+    if (st == SUCCESS) {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < SPARSE_BENCH_RHS; j++) {
+          double diff = MAT_AT(&c_sparse, i, j) - MAT_AT(&c_dense, i, j);
+          diff = diff < 0 ? -diff : diff;
+          if (diff > max_diff)
+            max_diff = diff;
+        }
+      }
+      free_matrix_data(&c_dense);
+    }
+    free_matrix_data(&c_sparse);
+
+    // Timed together with the transpose it needs
+    double spgemm_time = -1.0;
+    if (csr_multiply_transpose(&a, &squared) == SUCCESS) {
+      csr_free(&squared);
+      start = get_time_seconds();
+      if (csr_multiply_transpose(&a, &squared) == SUCCESS) {
+        spgemm_time = get_time_seconds() - start;
+        double diff = spgemm_sample_diff(&squared, &dense);
+        if (diff > max_diff)
+          max_diff = diff;
+        csr_free(&squared);
+      }
+    }
+
+    printf("  %-8.4f %-10lld %-9.2f %-10.5f %-10.5f %-10.4f %-10.4f ",
+           densities[d], a.nnz, csr_bytes(&a) / 1e6, spmv_time, gemv_time,
+           spmm_time, gemm_time);
+    if (spgemm_time >= 0)
+      printf("%-11.4f %.2e\n", spgemm_time, max_diff);
+    else
+      printf("%-11s %.2e\n", "-", max_diff);
+
+    csr_free(&a);
+    free_matrix_data(&dense);
+  }
+  printf("\n");
+
+  free(x);
+  free(y);
+  free(y_dense);
+  free_matrix_data(&rhs);
+}
+
+void run_create_random_matrix(MatrixSystem *sys) {
+  static unsigned int seed = 31337;
+  char name[MAX_NAME_LEN];
+  int rows, cols;
+
+  printf("\nMatrix name: ");
+  if (read_name(name) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+  if (find_matrix_index(sys, name) != -1) {
+    handle_error(ERR_DUPLICATE_ID);
+    return;
+  }
+
+  printf("Rows: ");
+  if (read_integer(&rows) != SUCCESS || rows <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+  printf("Columns: ");
+  if (read_integer(&cols) != SUCCESS || cols <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  Matrix mat;
+  if (alloc_matrix(&mat, rows, cols) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  fill_random_matrix(&mat, &seed);
+
+  Status status = register_matrix(sys, name, &mat);
+  if (status != SUCCESS) {
+    free_matrix_data(&mat);
+    handle_error(status);
+    return;
+  }
+
+  printf("\nMatrix %s created (%dx%d, values in [-1, 1))\n\n", name, rows,
+         cols);
+}
+
+void run_save_matrix(MatrixSystem *sys) {
+  char name[MAX_NAME_LEN], fallback[MAX_PATH_LEN], path[MAX_PATH_LEN];
+  Matrix *m;
+
+  list_available_matrices(sys);
+
+  printf("\nSave matrix: ");
+  read_name(name);
+
+  if (get_matrix_by_name(sys, name, &m) != SUCCESS) {
+    handle_error(ERR_MATRIX_NOT_FOUND);
+    return;
+  }
+
+  snprintf(fallback, sizeof(fallback), "%s.mat", name);
+  read_path("Output file", fallback, path);
+
+  double start = get_time_seconds();
+  Status status = save_matrix_file(m, path);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  double mb = (double)sizeof(MatrixFileHeader) / 1e6 +
+              (double)m->rows * m->stride * sizeof(double) / 1e6;
+  printf("\nSaved %s to %s (%.2f MB in %.3f s)\n\n", name, path, mb,
+         get_time_seconds() - start);
+}
+
+void run_load_matrix(MatrixSystem *sys) {
+  char name[MAX_NAME_LEN], path[MAX_PATH_LEN];
+  Matrix mat;
+
+  read_path("\nMatrix file", "matrix.mat", path);
+  printf("Name for the loaded matrix: ");
+  if (read_name(name) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+  if (find_matrix_index(sys, name) != -1) {
+    handle_error(ERR_DUPLICATE_ID);
+    return;
+  }
+
+  double start = get_time_seconds();
+  Status status = map_matrix_file(&mat, path);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  status = register_matrix(sys, name, &mat);
+  if (status != SUCCESS) {
+    free_matrix_data(&mat);
+    handle_error(status);
+    return;
+  }
+
+  printf("\nMapped %s as %s (%dx%d) in %.4f s\n\n", path, name, mat.rows,
+         mat.cols, get_time_seconds() - start);
+}
+
+void run_evaluate_expression(MatrixSystem *sys) {
+  char line[MAX_EXPR_LEN], target[MAX_NAME_LEN];
+  Expr expr;
+
+  list_available_matrices(sys);
+
+  printf("\nExpression (e.g. X = 2*A + B - C, or just A + B): ");
+  if (read_string(line, MAX_EXPR_LEN) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  // Optional "name =" prefix stores the result
+  const char *rhs = line;
+  target[0] = '\0';
+  char *eq = strchr(line, '=');
+  if (eq != NULL) {
+    *eq = '\0';
+    if (sscanf(line, "%31s", target) != 1) {
+      handle_error(ERR_INVALID_INPUT);
+      return;
+    }
+    rhs = eq + 1;
+  }
+
+  ExprParser parser = {rhs, 0, &expr, sys, SUCCESS};
+  expr_init(&expr);
+  int root = parse_expression(&parser);
+  skip_spaces(&parser);
+  if (root >= 0 && rhs[parser.pos] != '\0') {
+    parser.status = ERR_INVALID_INPUT;
+  }
+  if (parser.status != SUCCESS) {
+    handle_error(parser.status);
+    return;
+  }
+
+  Matrix *dest;
+  if (target[0] != '\0' && get_matrix_by_name(sys, target, &dest) == SUCCESS) {
+    Status status = expr_evaluate_into(&expr, root, dest);
+    if (status != SUCCESS) {
+      handle_error(status);
+      return;
+    }
+    printf("\nUpdated %s in place (%dx%d):\n\n", target, dest->rows,
+           dest->cols);
+    print_matrix(dest);
+    printf("\n");
+    return;
+  }
+
+  Matrix result;
+  Status status = expr_evaluate(&expr, root, &result);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\nResult (%dx%d):\n\n", result.rows, result.cols);
+  print_matrix(&result);
+  printf("\n");
+
+  if (target[0] == '\0') {
+    free_matrix_data(&result);
+    return;
+  }
+
+  status = register_matrix(sys, target, &result);
+  if (status != SUCCESS) {
+    free_matrix_data(&result);
+    handle_error(status);
+    return;
+  }
+  printf("Stored as %s\n\n", target);
+}
+
+/*
+ * Element-wise comparison relative to the larger magnitude (at least 1,
+ * so values near zero are compared absolutely). Fused kernels may sum in
+ * a different order, so bit-exact equality is not expected.
+ */
+int matrices_close(const Matrix *a, const Matrix *b, double tolerance) {
+  for (int i = 0; i < a->rows; i++) {
+    const double *row_a = MAT_ROW(a, i);
+    const double *row_b = MAT_ROW(b, i);
+    for (int j = 0; j < a->cols; j++) {
+      double x = row_a[j] < 0 ? -row_a[j] : row_a[j];
+      double y = row_b[j] < 0 ? -row_b[j] : row_b[j];
+      double scale = x > y ? x : y;
+      double diff = row_a[j] - row_b[j];
+      diff = diff < 0 ? -diff : diff;
+      if (diff > tolerance * (scale > 1.0 ? scale : 1.0)) {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+void run_expression_benchmark(void) {
+  int n = 0;
+
+  printf("\n=== Expression Fusion Benchmark ===\n");
+  printf("Matrix size N (default %d): ", DEFAULT_EXPR_SIZE);
+  if (read_integer(&n) != SUCCESS || n < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_EXPR_SIZE);
+    n = DEFAULT_EXPR_SIZE;
+  }
+
+  Matrix ops[EXPR_BENCH_OPERANDS];
+  unsigned int seed = 8080;
+  for (int k = 0; k < EXPR_BENCH_OPERANDS; k++) {
+    if (alloc_matrix(&ops[k], n, n) != SUCCESS) {
+      for (int q = 0; q < k; q++)
+        free_matrix_data(&ops[q]);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    fill_random_matrix(&ops[k], &seed);
+  }
+
+  double mb = (double)n * ops[0].stride * sizeof(double) / 1e6;
+  printf("\n  Expression: A + B + C + D, each operand %.1f MB\n\n", mb);
+  printf("  %-26s %-10s %-14s %s\n", "Strategy", "Time (s)", "Allocated MB",
+         "Check");
+
+  // Chained add_matrices: every '+' materializes a full temporary
+  Matrix chained, next;
+  double start = get_time_seconds();
+  Status st = add_matrices(&ops[0], &ops[1], &chained);
+  for (int k = 2; k < EXPR_BENCH_OPERANDS && st == SUCCESS; k++) {
+    st = add_matrices(&chained, &ops[k], &next);
+    free_matrix_data(&chained);
+    chained = next;
+  }
+  double chained_time = get_time_seconds() - start;
+  if (st != SUCCESS) {
+    for (int k = 0; k < EXPR_BENCH_OPERANDS; k++)
+      free_matrix_data(&ops[k]);
+    handle_error(st);
+    return;
+  }
+  printf("  %-26s %-10.4f %-14.1f %s\n", "Chained add_matrices",
+         chained_time, mb * (EXPR_BENCH_OPERANDS - 1), "-");
+
+  Expr expr;
+  expr_init(&expr);
+  int root = expr_leaf(&expr, &ops[0]);
+  for (int k = 1; k < EXPR_BENCH_OPERANDS; k++) {
+    root = expr_add(&expr, root, expr_leaf(&expr, &ops[k]));
+  }
+
+  Matrix fused;
+  start = get_time_seconds();
+  st = expr_evaluate(&expr, root, &fused);
+  double fused_time = get_time_seconds() - start;
+  if (st == SUCCESS) {
+    int ok = matrices_close(&fused, &chained, EXPR_TOLERANCE);
+    printf("  %-26s %-10.4f %-14.1f %s\n", "Fused (new result)", fused_time,
+           mb, ok ? "OK" : "MISMATCH");
+    free_matrix_data(&fused);
+  }
+
+  // D = A + B + C + D accumulates into D without any allocation
+  start = get_time_seconds();
+  st = expr_evaluate_into(&expr, root, &ops[EXPR_BENCH_OPERANDS - 1]);
+  double in_place_time = get_time_seconds() - start;
+  if (st == SUCCESS) {
+    int ok = matrices_close(&ops[EXPR_BENCH_OPERANDS - 1], &chained,
+                            EXPR_TOLERANCE);
+    printf("  %-26s %-10.4f %-14.1f %s\n", "Fused in place (D = ...)",
+           in_place_time, 0.0, ok ? "OK" : "MISMATCH");
+  }
+  printf("\n");
+
+  free_matrix_data(&chained);
+  for (int k = 0; k < EXPR_BENCH_OPERANDS; k++)
+    free_matrix_data(&ops[k]);
 }
@@ -5,23 +5,44 @@
  Platform: GNU/Linux (Arch/WSL) on x86_64
  ===============================================================================
  Features:
- - Dynamic vertex management (Labels 'A'-'Z')
+ - Dynamic vertex management with case-insensitive string names
+ - Hash-indexed name lookup and hash edge-set for O(1) duplicate checks
  - Adjacency List representation (Array of Linked Lists)
  - Breadth-First Search (BFS) for Shortest Path
+ - Weighted edges with Dijkstra on an indexed d-ary heap (decrease-key)
+ - Bidirectional Dijkstra for point-to-point queries
+ - Routing benchmark on generated road-like grids
+ - Bulk construction benchmark (millions of named edges)
  - Degree calculation and connectivity checks
  - Dynamic memory management for edges
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
 
 #define TRUE 1
 #define FALSE 0
-#define MAX_VERTICES 26
+#define MAX_NAME_LEN 32
+#define INITIAL_VERTEX_CAPACITY 16
+#define INITIAL_TABLE_CAPACITY 32
+#define EMPTY_SLOT -1
+#define EMPTY_EDGE 0xFFFFFFFFFFFFFFFFULL
 #define MIN_OPTION 1
-#define MAX_OPTION 7
+#define MAX_OPTION 10
+#define INF_DISTANCE LLONG_MAX
+#define HEAP_ARITY 4
+#define ARTERIAL_SPACING 16
+#define DEFAULT_GRID_SIDE 1000
+#define DEFAULT_QUERIES 20
+#define DEFAULT_BUILD_VERTICES 1000000
+#define DEFAULT_BUILD_EDGES 4000000
 
 typedef enum {
   SUCCESS,
@@ -31,47 +52,123 @@ typedef enum {
   ERR_FULL,
   ERR_ALREADY_EXISTS,
   ERR_NOT_FOUND,
-  ERR_NO_PATH
+  ERR_NO_PATH,
+  ERR_NAME_TOO_LONG
 } Status;
 
 typedef struct AdjNode {
   int vertex_idx;
+  int weight;
   struct AdjNode *next;
 } AdjNode;
 
 typedef struct {
-  AdjNode *head[MAX_VERTICES];
-  char labels[MAX_VERTICES];
+  AdjNode **head;
+  char **names;
   int num_vertices;
+  int capacity;
   int num_edges;
+  int *name_index;
+  int index_capacity;
+  unsigned long long *edge_set;
+  int edge_capacity;
 } Graph;
 
+typedef struct {
+  int num_vertices;
+  long long num_edges;
+  long long *offsets;
+  int *targets;
+  int *weights;
+} WeightedCsr;
+
+typedef struct {
+  long long key;
+  int vertex;
+} HeapEntry;
+
+typedef struct {
+  HeapEntry *entries;
+  int *pos;
+  int size;
+  int arity;
+} IndexedHeap;
+
+typedef struct {
+  long long *dist;
+  int *parent;
+  int *touched;
+  int touched_count;
+  IndexedHeap heap;
+} SearchSpace;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_add_vertex(Graph *g);
 void run_add_edge(Graph *g);
 void run_show_graph(const Graph *g);
 void run_bfs_path(Graph *g);
+void run_dijkstra_path(Graph *g);
+void run_routing_benchmark(void);
 void run_vertex_degree(Graph *g);
 void run_clear_graph(Graph *g);
+void run_build_benchmark(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
-Status read_char(char *value);
+Status read_string(char *buffer, int max_len);
 
-void init_graph(Graph *g);
-Status add_vertex(Graph *g, char label);
-Status add_edge(Graph *g, char src, char dest);
-int get_vertex_index(const Graph *g, char label);
+Status init_graph(Graph *g);
+Status add_vertex(Graph *g, const char *name);
+Status add_edge(Graph *g, const char *src, const char *dest, int weight);
+Status add_edge_by_index(Graph *g, int u, int v, int weight);
+int get_vertex_index(const Graph *g, const char *name);
 int get_degree(const Graph *g, int vertex_idx);
-Status bfs_shortest_path(Graph *g, char start, char end);
+Status bfs_shortest_path(Graph *g, const char *start, const char *end);
 void clear_graph(Graph *g);
+void free_graph(Graph *g);
+
+unsigned int hash_name(const char *name);
+int names_equal(const char *a, const char *b);
+unsigned long long hash_edge(unsigned long long key);
+unsigned long long make_edge_key(int u, int v);
+int has_edge(const Graph *g, int u, int v);
+Status grow_vertices(Graph *g);
+Status rehash_names(Graph *g, int new_capacity);
+Status rehash_edges(Graph *g, int new_capacity);
+void insert_edge_key(unsigned long long *set, int capacity,
+                     unsigned long long key);
+
+double get_time_seconds(void);
+Status build_weighted_csr(const Graph *g, WeightedCsr *csr);
+Status generate_road_grid(WeightedCsr *csr, int side);
+void free_weighted_csr(WeightedCsr *csr);
+
+Status heap_init(IndexedHeap *h, int n, int arity);
+void heap_free(IndexedHeap *h);
+void heap_push_or_decrease(IndexedHeap *h, int vertex, long long key);
+HeapEntry heap_pop_min(IndexedHeap *h);
+void heap_sift_up(IndexedHeap *h, int i);
+void heap_sift_down(IndexedHeap *h, int i);
+
+Status search_space_init(SearchSpace *ss, int n, int arity);
+void search_space_reset(SearchSpace *ss);
+void search_space_free(SearchSpace *ss);
+void relax(SearchSpace *ss, int v, long long dist, int parent);
+long long dijkstra(const WeightedCsr *g, int s, int t, SearchSpace *ss,
+                   int *settled);
+long long bidirectional_dijkstra(const WeightedCsr *g, int s, int t,
+                                 SearchSpace *fwd, SearchSpace *bwd,
+                                 int *meeting, int *settled);
 
 int main(void) {
   int option = 0;
   Graph g;
 
-  init_graph(&g);
+  if (init_graph(&g) != SUCCESS) {
+    printf("Fatal Error: Could not allocate initial memory.\n");
+    return 1;
+  }
 
   while (TRUE) {
     show_menu();
@@ -83,7 +180,7 @@ int main(void) {
 
     if (option == MAX_OPTION) {
       printf("\nExiting. Cleaning up memory...\n");
-      clear_graph(&g);
+      free_graph(&g);
       break;
     }
 
@@ -111,6 +208,15 @@ int main(void) {
     case 6:
       run_clear_graph(&g);
       break;
+    case 7:
+      run_dijkstra_path(&g);
+      break;
+    case 8:
+      run_routing_benchmark();
+      break;
+    case 9:
+      run_build_benchmark();
+      break;
     }
   }
 
@@ -120,7 +226,9 @@ int main(void) {
 void show_menu(void) {
   printf("=== Graph (Adjacency List) ===\n\n");
   printf("1. Add Vertex\n2. Add Edge\n3. Show Graph\n"
-         "4. Find Path (BFS)\n5. Vertex Degree\n6. Clear Graph\n7. Exit\n");
+         "4. Find Path (BFS)\n5. Vertex Degree\n6. Clear Graph\n"
+         "7. Shortest Path (Dijkstra)\n8. Routing Benchmark (Road Grid)\n"
+         "9. Graph Build Benchmark\n10. Exit\n");
   printf("Option: ");
 }
 
@@ -147,47 +255,60 @@ void handle_error(Status status) {
   case ERR_NO_PATH:
     printf("Error: No path found between vertices.\n\n");
     break;
+  case ERR_NAME_TOO_LONG:
+    printf("Error: Vertex name too long (max %d characters).\n\n",
+           MAX_NAME_LEN - 1);
+    break;
   case SUCCESS:
     break;
   }
 }
 
 void run_add_vertex(Graph *g) {
-  char label;
-  printf("\nVertex Label (A-Z): ");
-  if (read_char(&label) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  char name[MAX_NAME_LEN];
+  printf("\nVertex Name: ");
+  Status status = read_string(name, MAX_NAME_LEN);
+  if (status == SUCCESS && name[0] == '\0') {
+    status = ERR_INVALID_INPUT;
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
-  label = toupper(label);
 
-  Status status = add_vertex(g, label);
+  status = add_vertex(g, name);
   if (status == SUCCESS) {
-    printf("\n  - Vertex '%c' added.\n\n", label);
+    printf("\n  - Vertex '%s' added.\n\n", name);
   } else {
     handle_error(status);
   }
 }
 
 void run_add_edge(Graph *g) {
-  char src, dest;
+  char src[MAX_NAME_LEN], dest[MAX_NAME_LEN];
   printf("\nSource Vertex: ");
-  if (read_char(&src) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  Status status = read_string(src, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
   printf("Destination Vertex: ");
-  if (read_char(&dest) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  status = read_string(dest, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  src = toupper(src);
-  dest = toupper(dest);
+  int weight = 0;
+  printf("Weight (>= 0): ");
+  if (read_integer(&weight) != SUCCESS || weight < 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
 
-  Status status = add_edge(g, src, dest);
+  status = add_edge(g, src, dest, weight);
   if (status == SUCCESS) {
-    printf("\n  - Edge added: %c <-> %c\n\n", src, dest);
+    printf("\n  - Edge added: %s <-> %s (weight %d)\n\n", src, dest, weight);
   } else {
     handle_error(status);
   }
@@ -201,13 +322,13 @@ void run_show_graph(const Graph *g) {
 
   printf("\nAdjacency List:\n");
   for (int i = 0; i < g->num_vertices; i++) {
-    printf("  %c -> ", g->labels[i]);
+    printf("  %s -> ", g->names[i]);
     AdjNode *temp = g->head[i];
     if (!temp) {
       printf("[None]");
     }
     while (temp) {
-      printf("[%c] ", g->labels[temp->vertex_idx]);
+      printf("[%s:%d] ", g->names[temp->vertex_idx], temp->weight);
       temp = temp->next;
     }
     printf("\n");
@@ -216,45 +337,204 @@ void run_show_graph(const Graph *g) {
 }
 
 void run_bfs_path(Graph *g) {
-  char start, end;
+  char start[MAX_NAME_LEN], end[MAX_NAME_LEN];
   printf("\nStart info: ");
   printf("\nStart Vertex: ");
-  if (read_char(&start) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  Status status = read_string(start, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
   printf("Target Vertex: ");
-  if (read_char(&end) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  status = read_string(end, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  start = toupper(start);
-  end = toupper(end);
+  status = bfs_shortest_path(g, start, end);
+  if (status != SUCCESS) {
+    handle_error(status);
+  }
+}
 
-  Status status = bfs_shortest_path(g, start, end);
+void run_dijkstra_path(Graph *g) {
+  char start[MAX_NAME_LEN], end[MAX_NAME_LEN];
+  printf("\nStart Vertex: ");
+  Status status = read_string(start, MAX_NAME_LEN);
   if (status != SUCCESS) {
     handle_error(status);
+    return;
   }
+  printf("Target Vertex: ");
+  status = read_string(end, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  int s = get_vertex_index(g, start);
+  int t = get_vertex_index(g, end);
+  if (s == -1 || t == -1) {
+    handle_error(ERR_NOT_FOUND);
+    return;
+  }
+
+  WeightedCsr csr;
+  SearchSpace ss;
+  if (build_weighted_csr(g, &csr) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  if (search_space_init(&ss, csr.num_vertices, HEAP_ARITY) != SUCCESS) {
+    free_weighted_csr(&csr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  int settled = 0;
+  long long cost = dijkstra(&csr, s, t, &ss, &settled);
+
+  if (cost == INF_DISTANCE) {
+    handle_error(ERR_NO_PATH);
+  } else {
+    // Count the parent chain first, then fill it back to front
+    int path_len = 0;
+    for (int curr = t; curr != -1; curr = ss.parent[curr]) {
+      path_len++;
+    }
+
+    int *path = (int *)malloc(path_len * sizeof(int));
+    if (path == NULL) {
+      handle_error(ERR_MEMORY_ALLOCATION);
+    } else {
+      int i = path_len;
+      for (int curr = t; curr != -1; curr = ss.parent[curr]) {
+        path[--i] = curr;
+      }
+
+      printf("\n  - Path found: ");
+      for (i = 0; i < path_len; i++) {
+        printf("%s%s", g->names[path[i]], (i < path_len - 1) ? " -> " : "");
+      }
+      printf("\n  - Total cost: %lld (%d hops, %d vertices settled)\n\n",
+             cost, path_len - 1, settled);
+      free(path);
+    }
+  }
+
+  search_space_free(&ss);
+  free_weighted_csr(&csr);
+}
+
+void run_routing_benchmark(void) {
+  int side = 0, queries = 0;
+
+  printf("\n=== Routing Benchmark (Road Grid) ===\n");
+  printf("Grid side (default %d): ", DEFAULT_GRID_SIDE);
+  if (read_integer(&side) != SUCCESS || side < 2 || side > 20000) {
+    printf("  - Using default (%d).\n", DEFAULT_GRID_SIDE);
+    side = DEFAULT_GRID_SIDE;
+  }
+  printf("Queries (default %d): ", DEFAULT_QUERIES);
+  if (read_integer(&queries) != SUCCESS || queries < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_QUERIES);
+    queries = DEFAULT_QUERIES;
+  }
+
+  WeightedCsr csr;
+  printf("\nGenerating %dx%d grid...\n", side, side);
+  if (generate_road_grid(&csr, side) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  printf("  - %d vertices, %lld directed edges\n", csr.num_vertices,
+         csr.num_edges);
+
+  SearchSpace binary, dary, fwd, bwd;
+  memset(&binary, 0, sizeof(SearchSpace));
+  memset(&dary, 0, sizeof(SearchSpace));
+  memset(&fwd, 0, sizeof(SearchSpace));
+  memset(&bwd, 0, sizeof(SearchSpace));
+  if (search_space_init(&binary, csr.num_vertices, 2) != SUCCESS ||
+      search_space_init(&dary, csr.num_vertices, HEAP_ARITY) != SUCCESS ||
+      search_space_init(&fwd, csr.num_vertices, HEAP_ARITY) != SUCCESS ||
+      search_space_init(&bwd, csr.num_vertices, HEAP_ARITY) != SUCCESS) {
+    // All four start zeroed, so freeing the ones never initialized is safe
+    search_space_free(&binary);
+    search_space_free(&dary);
+    search_space_free(&fwd);
+    search_space_free(&bwd);
+    free_weighted_csr(&csr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  double time_binary = 0, time_dary = 0, time_bidir = 0;
+  long long settled_binary = 0, settled_dary = 0, settled_bidir = 0;
+  int mismatches = 0;
+  srand(time(NULL));
+
+  for (int q = 0; q < queries; q++) {
+    int s = rand() % csr.num_vertices;
+    int t = rand() % csr.num_vertices;
+    int settled = 0, meeting = -1;
+
+    double start = get_time_seconds();
+    long long d1 = dijkstra(&csr, s, t, &binary, &settled);
+    time_binary += get_time_seconds() - start;
+    settled_binary += settled;
+
+    start = get_time_seconds();
+    long long d2 = dijkstra(&csr, s, t, &dary, &settled);
+    time_dary += get_time_seconds() - start;
+    settled_dary += settled;
+
+    start = get_time_seconds();
+    long long d3 = bidirectional_dijkstra(&csr, s, t, &fwd, &bwd, &meeting,
+                                          &settled);
+    time_bidir += get_time_seconds() - start;
+    settled_bidir += settled;
+
+    if (d1 != d2 || d1 != d3)
+      mismatches++;
+  }
+
+  printf("\n  %-24s %-14s %s\n", "Algorithm", "Avg ms/query",
+         "Avg settled");
+  printf("  %-24s %-14.3f %lld\n", "Dijkstra (binary heap)",
+         time_binary * 1000 / queries, settled_binary / queries);
+  printf("  %-24s %-14.3f %lld\n", "Dijkstra (4-ary heap)",
+         time_dary * 1000 / queries, settled_dary / queries);
+  printf("  %-24s %-14.3f %lld\n", "Bidirectional (4-ary)",
+         time_bidir * 1000 / queries, settled_bidir / queries);
+  printf("\n  - Distance check: %s\n\n",
+         mismatches == 0 ? "all queries agree" : "MISMATCH");
+
+  search_space_free(&binary);
+  search_space_free(&dary);
+  search_space_free(&fwd);
+  search_space_free(&bwd);
+  free_weighted_csr(&csr);
 }
 
 void run_vertex_degree(Graph *g) {
-  char label;
+  char name[MAX_NAME_LEN];
   printf("\nVertex to check: ");
-  if (read_char(&label) != SUCCESS) {
-    handle_error(ERR_INVALID_INPUT);
+  Status status = read_string(name, MAX_NAME_LEN);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
-  label = toupper(label);
 
-  int idx = get_vertex_index(g, label);
+  int idx = get_vertex_index(g, name);
   if (idx == -1) {
     handle_error(ERR_NOT_FOUND);
     return;
   }
 
   int degree = get_degree(g, idx);
-  printf("\n  - Vertex '%c' has degree: %d\n\n", label, degree);
+  printf("\n  - Vertex '%s' has degree: %d\n\n", name, degree);
 }
 
 void run_clear_graph(Graph *g) {
@@ -262,6 +542,71 @@ void run_clear_graph(Graph *g) {
   printf("\n  - Graph cleared.\n\n");
 }
 
+void run_build_benchmark(void) {
+  int n = 0, m = 0;
+
+  printf("\n=== Graph Build Benchmark ===\n");
+  printf("Vertices (default %d): ", DEFAULT_BUILD_VERTICES);
+  if (read_integer(&n) != SUCCESS || n < 2) {
+    printf("  - Using default (%d).\n", DEFAULT_BUILD_VERTICES);
+    n = DEFAULT_BUILD_VERTICES;
+  }
+  printf("Edges (default %d): ", DEFAULT_BUILD_EDGES);
+  if (read_integer(&m) != SUCCESS || m < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_BUILD_EDGES);
+    m = DEFAULT_BUILD_EDGES;
+  }
+
+  Graph g;
+  if (init_graph(&g) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  char src[MAX_NAME_LEN], dest[MAX_NAME_LEN];
+  Status status = SUCCESS;
+
+  double start = get_time_seconds();
+  for (int i = 0; i < n && status == SUCCESS; i++) {
+    snprintf(src, MAX_NAME_LEN, "city_%d", i);
+    status = add_vertex(&g, src);
+  }
+  double vertex_time = get_time_seconds() - start;
+
+  int added = 0, duplicates = 0;
+  srand(time(NULL));
+  start = get_time_seconds();
+  for (int i = 0; i < m && status == SUCCESS; i++) {
+    snprintf(src, MAX_NAME_LEN, "city_%d", rand() % n);
+    snprintf(dest, MAX_NAME_LEN, "city_%d", rand() % n);
+
+    Status st = add_edge(&g, src, dest, 1 + rand() % 100);
+    if (st == SUCCESS) {
+      added++;
+    } else if (st == ERR_ALREADY_EXISTS || st == ERR_INVALID_INPUT) {
+      duplicates++;
+    } else {
+      status = st;
+    }
+  }
+  double edge_time = get_time_seconds() - start;
+
+  if (status != SUCCESS) {
+    handle_error(status);
+  } else {
+    printf("\n  - Vertices inserted: %d in %.3f s (%.0f ns/vertex)\n", n,
+           vertex_time, vertex_time * 1e9 / n);
+    printf("  - Edges attempted:   %d in %.3f s (%.0f ns/edge)\n", m,
+           edge_time, edge_time * 1e9 / m);
+    printf("  - Edges added:       %d\n", added);
+    printf("  - Rejected:          %d (duplicates / self-loops)\n", duplicates);
+    printf("  - Name index slots:  %d | Edge set slots: %d\n\n",
+           g.index_capacity, g.edge_capacity);
+  }
+
+  free_graph(&g);
+}
+
 void clear_input_buffer(void) {
   int c;
   while ((c = getchar()) != '\n' && c != EOF) {
@@ -278,50 +623,113 @@ Status read_integer(int *value) {
   return SUCCESS;
 }
 
-Status read_char(char *value) {
-  if (scanf(" %c", value) != 1) {
-    clear_input_buffer();
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
     return ERR_INVALID_INPUT;
   }
-  clear_input_buffer();
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+    return SUCCESS;
+  }
+
+  // No newline in the buffer: accept only if the line ends right here
+  int c = getchar();
+  if (c != '\n' && c != EOF) {
+    clear_input_buffer();
+    return ERR_NAME_TOO_LONG;
+  }
   return SUCCESS;
 }
 
-void init_graph(Graph *g) {
+Status init_graph(Graph *g) {
   g->num_vertices = 0;
   g->num_edges = 0;
-  for (int i = 0; i < MAX_VERTICES; i++) {
-    g->head[i] = NULL;
+  g->capacity = INITIAL_VERTEX_CAPACITY;
+  g->index_capacity = INITIAL_TABLE_CAPACITY;
+  g->edge_capacity = INITIAL_TABLE_CAPACITY;
+
+  g->head = (AdjNode **)malloc(g->capacity * sizeof(AdjNode *));
+  g->names = (char **)malloc(g->capacity * sizeof(char *));
+  g->name_index = (int *)malloc(g->index_capacity * sizeof(int));
+  g->edge_set = (unsigned long long *)malloc(g->edge_capacity *
+                                             sizeof(unsigned long long));
+  if (!g->head || !g->names || !g->name_index || !g->edge_set) {
+    free(g->head);
+    free(g->names);
+    free(g->name_index);
+    free(g->edge_set);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < g->index_capacity; i++) {
+    g->name_index[i] = EMPTY_SLOT;
   }
+  for (int i = 0; i < g->edge_capacity; i++) {
+    g->edge_set[i] = EMPTY_EDGE;
+  }
+
+  return SUCCESS;
 }
 
-int get_vertex_index(const Graph *g, char label) {
-  for (int i = 0; i < g->num_vertices; i++) {
-    if (g->labels[i] == label) {
-      return i;
+int get_vertex_index(const Graph *g, const char *name) {
+  int mask = g->index_capacity - 1;
+  int slot = (int)(hash_name(name) & mask);
+
+  // Linear probing: stop at the first empty slot
+  while (g->name_index[slot] != EMPTY_SLOT) {
+    int idx = g->name_index[slot];
+    if (names_equal(g->names[idx], name)) {
+      return idx;
     }
+    slot = (slot + 1) & mask;
   }
 
   return -1;
 }
 
-Status add_vertex(Graph *g, char label) {
-  if (g->num_vertices >= MAX_VERTICES) {
+Status add_vertex(Graph *g, const char *name) {
+  if (g->num_vertices == INT_MAX) {
     return ERR_FULL;
   }
 
-  if (get_vertex_index(g, label) != -1) {
+  if (get_vertex_index(g, name) != -1) {
     return ERR_ALREADY_EXISTS;
   }
 
-  g->labels[g->num_vertices] = label;
-  g->head[g->num_vertices] = NULL;
+  if (g->num_vertices == g->capacity && grow_vertices(g) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Keep the index at most half full so probe chains stay short
+  if ((g->num_vertices + 1) * 2 > g->index_capacity &&
+      rehash_names(g, g->index_capacity * 2) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  size_t len = strlen(name);
+  char *copy = (char *)malloc(len + 1);
+  if (copy == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  memcpy(copy, name, len + 1);
+
+  int idx = g->num_vertices;
+  g->names[idx] = copy;
+  g->head[idx] = NULL;
   g->num_vertices++;
 
+  int mask = g->index_capacity - 1;
+  int slot = (int)(hash_name(name) & mask);
+  while (g->name_index[slot] != EMPTY_SLOT) {
+    slot = (slot + 1) & mask;
+  }
+  g->name_index[slot] = idx;
+
   return SUCCESS;
 }
 
-Status add_edge(Graph *g, char src, char dest) {
+Status add_edge(Graph *g, const char *src, const char *dest, int weight) {
   int u = get_vertex_index(g, src);
   int v = get_vertex_index(g, dest);
 
@@ -329,34 +737,44 @@ Status add_edge(Graph *g, char src, char dest) {
     return ERR_NOT_FOUND;
   }
 
+  return add_edge_by_index(g, u, v, weight);
+}
+
+Status add_edge_by_index(Graph *g, int u, int v, int weight) {
   if (u == v) {
     return ERR_INVALID_INPUT;
   }
 
-  AdjNode *temp = g->head[u];
-  while (temp) {
-    if (temp->vertex_idx == v) {
-      return ERR_ALREADY_EXISTS;
-    }
-    temp = temp->next;
+  if (has_edge(g, u, v)) {
+    return ERR_ALREADY_EXISTS;
+  }
+
+  if ((g->num_edges + 1) * 2 > g->edge_capacity &&
+      rehash_edges(g, g->edge_capacity * 2) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
   }
 
   AdjNode *newNodeUV = (AdjNode *)malloc(sizeof(AdjNode));
   if (!newNodeUV) {
     return ERR_MEMORY_ALLOCATION;
   }
-  newNodeUV->vertex_idx = v;
-  newNodeUV->next = g->head[u];
-  g->head[u] = newNodeUV;
-
   AdjNode *newNodeVU = (AdjNode *)malloc(sizeof(AdjNode));
   if (!newNodeVU) {
+    free(newNodeUV);
     return ERR_MEMORY_ALLOCATION;
   }
+
+  newNodeUV->vertex_idx = v;
+  newNodeUV->weight = weight;
+  newNodeUV->next = g->head[u];
+  g->head[u] = newNodeUV;
+
   newNodeVU->vertex_idx = u;
+  newNodeVU->weight = weight;
   newNodeVU->next = g->head[v];
   g->head[v] = newNodeVU;
 
+  insert_edge_key(g->edge_set, g->edge_capacity, make_edge_key(u, v));
   g->num_edges++;
 
   return SUCCESS;
@@ -373,7 +791,7 @@ int get_degree(const Graph *g, int vertex_idx) {
   return degree;
 }
 
-Status bfs_shortest_path(Graph *g, char start, char end) {
+Status bfs_shortest_path(Graph *g, const char *start, const char *end) {
   int s = get_vertex_index(g, start);
   int e = get_vertex_index(g, end);
 
@@ -381,12 +799,19 @@ Status bfs_shortest_path(Graph *g, char start, char end) {
     return ERR_NOT_FOUND;
   }
 
-  int queue[MAX_VERTICES];
+  int n = g->num_vertices;
   int front = 0, rear = 0;
-  int visited[MAX_VERTICES];
-  int parent[MAX_VERTICES];
+  int *queue = (int *)malloc(n * sizeof(int));
+  int *visited = (int *)malloc(n * sizeof(int));
+  int *parent = (int *)malloc(n * sizeof(int));
+  if (!queue || !visited || !parent) {
+    free(queue);
+    free(visited);
+    free(parent);
+    return ERR_MEMORY_ALLOCATION;
+  }
 
-  for (int i = 0; i < MAX_VERTICES; i++) {
+  for (int i = 0; i < n; i++) {
     visited[i] = FALSE;
     parent[i] = -1;
   }
@@ -415,8 +840,8 @@ Status bfs_shortest_path(Graph *g, char start, char end) {
   }
 
   if (found) {
-    // Reconstruct path
-    int path[MAX_VERTICES];
+    // Reconstruct path (the queue is no longer needed, reuse it)
+    int *path = queue;
     int path_len = 0;
     int curr = e;
     while (curr != -1) {
@@ -426,15 +851,17 @@ Status bfs_shortest_path(Graph *g, char start, char end) {
 
     printf("\n  - Path found: ");
     for (int i = path_len - 1; i >= 0; i--) {
-      printf("%c", g->labels[path[i]]);
+      printf("%s", g->names[path[i]]);
       if (i > 0)
         printf(" -> ");
     }
     printf("\n  - Distance: %d hops\n\n", path_len - 1);
-    return SUCCESS;
-  } else {
-    return ERR_NO_PATH;
   }
+
+  free(queue);
+  free(visited);
+  free(parent);
+  return found ? SUCCESS : ERR_NO_PATH;
 }
 
 void clear_graph(Graph *g) {
@@ -446,7 +873,486 @@ void clear_graph(Graph *g) {
       free(temp);
     }
     g->head[i] = NULL;
+    free(g->names[i]);
+    g->names[i] = NULL;
+  }
+  for (int i = 0; i < g->index_capacity; i++) {
+    g->name_index[i] = EMPTY_SLOT;
+  }
+  for (int i = 0; i < g->edge_capacity; i++) {
+    g->edge_set[i] = EMPTY_EDGE;
   }
   g->num_vertices = 0;
   g->num_edges = 0;
 }
+
+void free_graph(Graph *g) {
+  clear_graph(g);
+  free(g->head);
+  free(g->names);
+  free(g->name_index);
+  free(g->edge_set);
+  g->head = NULL;
+  g->names = NULL;
+  g->name_index = NULL;
+  g->edge_set = NULL;
+  g->capacity = 0;
+  g->index_capacity = 0;
+  g->edge_capacity = 0;
+}
+
+unsigned int hash_name(const char *name) {
+  // FNV-1a over the lowercased bytes, so "Madrid" and "MADRID" collide
+  unsigned int hash = 2166136261u;
+  for (int i = 0; name[i] != '\0'; i++) {
+    hash ^= (unsigned char)tolower((unsigned char)name[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+int names_equal(const char *a, const char *b) {
+  while (*a != '\0' &&
+         tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+    a++;
+    b++;
+  }
+  return tolower((unsigned char)*a) == tolower((unsigned char)*b);
+}
+
+unsigned long long hash_edge(unsigned long long key) {
+  // splitmix64 finalizer
+  key ^= key >> 30;
+  key *= 0xBF58476D1CE4E5B9ULL;
+  key ^= key >> 27;
+  key *= 0x94D049BB133111EBULL;
+  key ^= key >> 31;
+  return key;
+}
+
+unsigned long long make_edge_key(int u, int v) {
+  // Undirected: store each pair once as (min, max)
+  if (u > v) {
+    int tmp = u;
+    u = v;
+    v = tmp;
+  }
+  return ((unsigned long long)u << 32) | (unsigned int)v;
+}
+
+int has_edge(const Graph *g, int u, int v) {
+  unsigned long long key = make_edge_key(u, v);
+  int mask = g->edge_capacity - 1;
+  int slot = (int)(hash_edge(key) & mask);
+
+  while (g->edge_set[slot] != EMPTY_EDGE) {
+    if (g->edge_set[slot] == key) {
+      return TRUE;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return FALSE;
+}
+
+Status grow_vertices(Graph *g) {
+  int new_cap = g->capacity * 2;
+
+  AdjNode **new_head =
+      (AdjNode **)realloc(g->head, new_cap * sizeof(AdjNode *));
+  if (new_head == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  g->head = new_head;
+
+  char **new_names = (char **)realloc(g->names, new_cap * sizeof(char *));
+  if (new_names == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  g->names = new_names;
+  g->capacity = new_cap;
+
+  return SUCCESS;
+}
+
+Status rehash_names(Graph *g, int new_capacity) {
+  int *new_index = (int *)malloc(new_capacity * sizeof(int));
+  if (new_index == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < new_capacity; i++) {
+    new_index[i] = EMPTY_SLOT;
+  }
+
+  int mask = new_capacity - 1;
+  for (int idx = 0; idx < g->num_vertices; idx++) {
+    int slot = (int)(hash_name(g->names[idx]) & mask);
+    while (new_index[slot] != EMPTY_SLOT) {
+      slot = (slot + 1) & mask;
+    }
+    new_index[slot] = idx;
+  }
+
+  free(g->name_index);
+  g->name_index = new_index;
+  g->index_capacity = new_capacity;
+
+  return SUCCESS;
+}
+
+Status rehash_edges(Graph *g, int new_capacity) {
+  unsigned long long *new_set = (unsigned long long *)malloc(
+      new_capacity * sizeof(unsigned long long));
+  if (new_set == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < new_capacity; i++) {
+    new_set[i] = EMPTY_EDGE;
+  }
+
+  for (int i = 0; i < g->edge_capacity; i++) {
+    if (g->edge_set[i] != EMPTY_EDGE) {
+      insert_edge_key(new_set, new_capacity, g->edge_set[i]);
+    }
+  }
+
+  free(g->edge_set);
+  g->edge_set = new_set;
+  g->edge_capacity = new_capacity;
+
+  return SUCCESS;
+}
+
+void insert_edge_key(unsigned long long *set, int capacity,
+                     unsigned long long key) {
+  int mask = capacity - 1;
+  int slot = (int)(hash_edge(key) & mask);
+  while (set[slot] != EMPTY_EDGE) {
+    slot = (slot + 1) & mask;
+  }
+  set[slot] = key;
+}
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+Status build_weighted_csr(const Graph *g, WeightedCsr *csr) {
+  int n = g->num_vertices;
+  long long edges = 0;
+
+  for (int u = 0; u < n; u++) {
+    edges += get_degree(g, u);
+  }
+
+  csr->num_vertices = n;
+  csr->num_edges = edges;
+  csr->offsets = (long long *)malloc((n + 1) * sizeof(long long));
+  csr->targets = (int *)malloc((edges + 1) * sizeof(int));
+  csr->weights = (int *)malloc((edges + 1) * sizeof(int));
+  if (!csr->offsets || !csr->targets || !csr->weights) {
+    free_weighted_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  long long e = 0;
+  for (int u = 0; u < n; u++) {
+    csr->offsets[u] = e;
+    for (AdjNode *temp = g->head[u]; temp; temp = temp->next) {
+      csr->targets[e] = temp->vertex_idx;
+      csr->weights[e] = temp->weight;
+      e++;
+    }
+  }
+  csr->offsets[n] = e;
+
+  return SUCCESS;
+}
+
+Status generate_road_grid(WeightedCsr *csr, int side) {
+  int n = side * side;
+  long long edges = 4LL * side * (side - 1);
+
+  csr->num_vertices = n;
+  csr->num_edges = edges;
+  csr->offsets = (long long *)malloc((n + 1) * sizeof(long long));
+  csr->targets = (int *)malloc(edges * sizeof(int));
+  csr->weights = (int *)malloc(edges * sizeof(int));
+  if (!csr->offsets || !csr->targets || !csr->weights) {
+    free_weighted_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Local streets cost 20-99; every ARTERIAL_SPACING-th row/column is a
+  // fast arterial road (cost 5-9), so optimal routes are not just L-shapes.
+  int *right = (int *)malloc(n * sizeof(int));
+  int *down = (int *)malloc(n * sizeof(int));
+  if (!right || !down) {
+    free(right);
+    free(down);
+    free_weighted_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  srand(time(NULL));
+  for (int r = 0; r < side; r++) {
+    for (int c = 0; c < side; c++) {
+      int v = r * side + c;
+      right[v] =
+          (r % ARTERIAL_SPACING == 0) ? 5 + rand() % 5 : 20 + rand() % 80;
+      down[v] =
+          (c % ARTERIAL_SPACING == 0) ? 5 + rand() % 5 : 20 + rand() % 80;
+    }
+  }
+
+  long long e = 0;
+  for (int r = 0; r < side; r++) {
+    for (int c = 0; c < side; c++) {
+      int v = r * side + c;
+      csr->offsets[v] = e;
+      if (c + 1 < side) {
+        csr->targets[e] = v + 1;
+        csr->weights[e++] = right[v];
+      }
+      if (c > 0) {
+        csr->targets[e] = v - 1;
+        csr->weights[e++] = right[v - 1];
+      }
+      if (r + 1 < side) {
+        csr->targets[e] = v + side;
+        csr->weights[e++] = down[v];
+      }
+      if (r > 0) {
+        csr->targets[e] = v - side;
+        csr->weights[e++] = down[v - side];
+      }
+    }
+  }
+  csr->offsets[n] = e;
+
+  free(right);
+  free(down);
+  return SUCCESS;
+}
+
+void free_weighted_csr(WeightedCsr *csr) {
+  free(csr->offsets);
+  free(csr->targets);
+  free(csr->weights);
+  csr->offsets = NULL;
+  csr->targets = NULL;
+  csr->weights = NULL;
+  csr->num_vertices = 0;
+  csr->num_edges = 0;
+}
+
+Status heap_init(IndexedHeap *h, int n, int arity) {
+  h->entries = (HeapEntry *)malloc((n > 0 ? n : 1) * sizeof(HeapEntry));
+  h->pos = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+  h->size = 0;
+  h->arity = arity;
+  if (h->entries == NULL || h->pos == NULL) {
+    heap_free(h);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < n; i++) {
+    h->pos[i] = -1;
+  }
+  return SUCCESS;
+}
+
+void heap_free(IndexedHeap *h) {
+  free(h->entries);
+  free(h->pos);
+  h->entries = NULL;
+  h->pos = NULL;
+  h->size = 0;
+}
+
+void heap_push_or_decrease(IndexedHeap *h, int vertex, long long key) {
+  int i = h->pos[vertex];
+  if (i == -1) {
+    i = h->size++;
+    h->entries[i].vertex = vertex;
+    h->pos[vertex] = i;
+  }
+  h->entries[i].key = key;
+  heap_sift_up(h, i);
+}
+
+HeapEntry heap_pop_min(IndexedHeap *h) {
+  HeapEntry top = h->entries[0];
+  h->pos[top.vertex] = -1;
+  h->size--;
+  if (h->size > 0) {
+    h->entries[0] = h->entries[h->size];
+    h->pos[h->entries[0].vertex] = 0;
+    heap_sift_down(h, 0);
+  }
+  return top;
+}
+
+void heap_sift_up(IndexedHeap *h, int i) {
+  HeapEntry moving = h->entries[i];
+  while (i > 0) {
+    int parent = (i - 1) / h->arity;
+    if (h->entries[parent].key <= moving.key)
+      break;
+    h->entries[i] = h->entries[parent];
+    h->pos[h->entries[i].vertex] = i;
+    i = parent;
+  }
+  h->entries[i] = moving;
+  h->pos[moving.vertex] = i;
+}
+
+void heap_sift_down(IndexedHeap *h, int i) {
+  HeapEntry moving = h->entries[i];
+  while (TRUE) {
+    int first = i * h->arity + 1;
+    if (first >= h->size)
+      break;
+
+    int last = first + h->arity;
+    if (last > h->size)
+      last = h->size;
+
+    int best = first;
+    for (int c = first + 1; c < last; c++) {
+      if (h->entries[c].key < h->entries[best].key)
+        best = c;
+    }
+    if (h->entries[best].key >= moving.key)
+      break;
+
+    h->entries[i] = h->entries[best];
+    h->pos[h->entries[i].vertex] = i;
+    i = best;
+  }
+  h->entries[i] = moving;
+  h->pos[moving.vertex] = i;
+}
+
+Status search_space_init(SearchSpace *ss, int n, int arity) {
+  ss->dist = (long long *)malloc(n * sizeof(long long));
+  ss->parent = (int *)malloc(n * sizeof(int));
+  ss->touched = (int *)malloc(n * sizeof(int));
+  ss->touched_count = 0;
+  ss->heap.entries = NULL;
+  ss->heap.pos = NULL;
+
+  if (!ss->dist || !ss->parent || !ss->touched ||
+      heap_init(&ss->heap, n, arity) != SUCCESS) {
+    search_space_free(ss);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < n; i++) {
+    ss->dist[i] = INF_DISTANCE;
+    ss->parent[i] = -1;
+  }
+  return SUCCESS;
+}
+
+void search_space_reset(SearchSpace *ss) {
+  // Only undo what the last query wrote, so a query costs O(touched)
+  for (int i = 0; i < ss->touched_count; i++) {
+    int v = ss->touched[i];
+    ss->dist[v] = INF_DISTANCE;
+    ss->parent[v] = -1;
+    ss->heap.pos[v] = -1;
+  }
+  ss->touched_count = 0;
+  ss->heap.size = 0;
+}
+
+void search_space_free(SearchSpace *ss) {
+  free(ss->dist);
+  free(ss->parent);
+  free(ss->touched);
+  heap_free(&ss->heap);
+  ss->dist = NULL;
+  ss->parent = NULL;
+  ss->touched = NULL;
+  ss->touched_count = 0;
+}
+
+void relax(SearchSpace *ss, int v, long long dist, int parent) {
+  if (ss->dist[v] == INF_DISTANCE) {
+    ss->touched[ss->touched_count++] = v;
+  } else if (dist >= ss->dist[v]) {
+    return;
+  }
+  ss->dist[v] = dist;
+  ss->parent[v] = parent;
+  heap_push_or_decrease(&ss->heap, v, dist);
+}
+
+long long dijkstra(const WeightedCsr *g, int s, int t, SearchSpace *ss,
+                   int *settled) {
+  search_space_reset(ss);
+  *settled = 0;
+  relax(ss, s, 0, -1);
+
+  while (ss->heap.size > 0) {
+    HeapEntry top = heap_pop_min(&ss->heap);
+    int u = top.vertex;
+    (*settled)++;
+
+    if (u == t) {
+      return top.key;
+    }
+
+    for (long long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+      relax(ss, g->targets[e], top.key + g->weights[e], u);
+    }
+  }
+
+  return INF_DISTANCE;
+}
+
+long long bidirectional_dijkstra(const WeightedCsr *g, int s, int t,
+                                 SearchSpace *fwd, SearchSpace *bwd,
+                                 int *meeting, int *settled) {
+  long long best = INF_DISTANCE;
+
+  search_space_reset(fwd);
+  search_space_reset(bwd);
+  *settled = 0;
+  *meeting = -1;
+
+  relax(fwd, s, 0, -1);
+  relax(bwd, t, 0, -1);
+  if (s == t) {
+    *meeting = s;
+    return 0;
+  }
+
+  // Edges are undirected, so the backward search reuses the same CSR
+  while (fwd->heap.size > 0 && bwd->heap.size > 0) {
+    long long top_f = fwd->heap.entries[0].key;
+    long long top_b = bwd->heap.entries[0].key;
+    if (best != INF_DISTANCE && top_f + top_b >= best)
+      break;
+
+    SearchSpace *side = (top_f <= top_b) ? fwd : bwd;
+    SearchSpace *other = (side == fwd) ? bwd : fwd;
+    HeapEntry top = heap_pop_min(&side->heap);
+    int u = top.vertex;
+    (*settled)++;
+
+    for (long long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+      int v = g->targets[e];
+      relax(side, v, top.key + g->weights[e], u);
+      if (other->dist[v] != INF_DISTANCE &&
+          side->dist[v] + other->dist[v] < best) {
+        best = side->dist[v] + other->dist[v];
+        *meeting = v;
+      }
+    }
+  }
+
+  return best;
+}
@@ -8,20 +8,57 @@
  - Dynamic Array Generation (Sorted)
  - Algorithm 1: Linear Search O(n)
  - Algorithm 2: Binary Search O(log n)
+ - AVX2 linear scan (8 ints per compare, selected at runtime),
+   interpolation search for uniform keys and exponential search
+ - Branchless binary search (conditional moves + prefetching) and an
+   Eytzinger (BFS-order) layout, benchmarked from 1K to 1G elements
+ - Batch search API: interleaved groups of branchless searches so their
+   cache misses overlap, plus a merge-join mode for sorted queries
  - Performance Metrics: Time (seconds) and Comparison Count
+ - Hardware counters (cycles, instructions, branch and cache misses)
+   via perf_event_open when the kernel allows it
  - Automatic efficiency calculation and recommendation
  - Dynamic memory management with proper cleanup
  ===============================================================================
 */
 
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(__linux__) && !defined(NO_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENTS 1
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 2
+#define MAX_OPTION 4
+#define LAYOUT_MIN_SIZE 1000
+#define LAYOUT_MAX_SIZE 1000000000
+#define DEFAULT_LAYOUT_MAX 100000000
+#define LAYOUT_QUERIES (1 << 20)
+#define EYTZINGER_PREFETCH 16
+#define CACHE_LINE 64
+#define DEFAULT_BATCH_SIZE 10000000
+#define DEFAULT_BATCH_QUERIES 1000000
+#define MAX_BATCH_GROUP 64
+#define SIMD_WIDTH 8
+#define SEARCH_METHODS 5
+#define SEARCH_TIMING_SECONDS 0.05
+#define SEARCH_TIMING_BATCH 16
 
 typedef enum {
   SUCCESS,
@@ -30,15 +67,42 @@ typedef enum {
   ERR_MEMORY_ALLOCATION
 } Status;
 
+typedef enum {
+  LAYOUT_BRANCHY,
+  LAYOUT_BRANCHLESS,
+  LAYOUT_EYTZINGER,
+  LAYOUT_COUNT
+} SearchLayout;
+
+typedef enum {
+  HW_CYCLES,
+  HW_INSTRUCTIONS,
+  HW_BRANCH_MISSES,
+  HW_CACHE_MISSES,
+  HW_COUNTER_COUNT
+} HwCounterId;
+
+// Hardware counters per measured call; -1 when not available
+typedef struct {
+  long long value[HW_COUNTER_COUNT];
+} HwCounters;
+
 typedef struct {
   int index;
   long comparisons;
   double time_taken;
+  HwCounters hw;
 } SearchResult;
 
+typedef SearchResult (*SearchFunction)(const int *arr, int size, int target);
+typedef int (*ScanKernel)(const int *arr, int size, int target,
+                          long *compares);
+
 void show_menu(void);
 void handle_error(Status status);
 void run_comparison_mode(void);
+void run_layout_benchmark(void);
+void run_batch_benchmark(void);
 void run_algorithm_explanation(void);
 
 void clear_input_buffer(void);
@@ -47,11 +111,48 @@ Status read_integer(int *value);
 Status generate_sorted_array(int **arr, int size);
 SearchResult linear_search(const int *arr, int size, int target);
 SearchResult binary_search(const int *arr, int size, int target);
+SearchResult simd_linear_search(const int *arr, int size, int target);
+SearchResult interpolation_search(const int *arr, int size, int target);
+SearchResult exponential_search(const int *arr, int size, int target);
+int linear_scan_scalar(const int *arr, int size, int target, long *compares);
+#ifdef HAVE_X86_SIMD
+int linear_scan_avx2(const int *arr, int size, int target, long *compares);
+#endif
+void select_simd_kernels(void);
+SearchResult measure_search(SearchFunction search, const int *arr, int size,
+                            int target);
+void print_search_result(const char *title, const SearchResult *res,
+                         const char *complexity);
+int branchy_search(const int *arr, int size, int target);
+int branchless_search(const int *arr, int size, int target);
+Status build_eytzinger(const int *arr, int size, int **eytzinger);
+int eytzinger_fill(const int *arr, int *eytzinger, int size, int next,
+                   long long node);
+long long eytzinger_search(const int *eytzinger, int size, int target);
+long long run_layout_queries(SearchLayout layout, const int *arr,
+                             const int *eytzinger, int size,
+                             const int *queries, int count);
+void batch_search(const int *arr, int size, const int *queries, int count,
+                  int group, int *results);
+void merge_join_search(const int *arr, int size, const int *queries,
+                       int count, int *results);
+int compare_ints(const void *a, const void *b);
+double get_time_seconds(void);
 void print_array_preview(const int *arr, int size);
+void perf_counters_open(void);
+void perf_counters_start(void);
+void perf_counters_stop(HwCounters *hw);
+void print_hw_counters(const HwCounters *hw);
+
+int perf_fds[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
+ScanKernel scan_kernel = linear_scan_scalar;
+const char *scan_kernel_name = "scalar";
 
 int main(void) {
   int option = 0;
   srand(time(NULL));
+  select_simd_kernels();
+  perf_counters_open();
 
   while (TRUE) {
     show_menu();
@@ -66,13 +167,13 @@ int main(void) {
       break;
     }
 
-    // Standard Exit Option logic if preferred, but simpler 1-2 menu structure:
-    if (option == 3) {
+    // Standard Exit Option logic if preferred, but simpler 1-4 menu structure:
+    if (option == 5) {
       printf("\nExiting. Goodbye!\n");
       break;
     }
 
-    if (option < MIN_OPTION || option > 3) {
+    if (option < MIN_OPTION || option > 5) {
       handle_error(ERR_INVALID_OPTION);
       continue;
     }
@@ -82,6 +183,12 @@ int main(void) {
       run_comparison_mode();
       break;
     case 2:
+      run_layout_benchmark();
+      break;
+    case 3:
+      run_batch_benchmark();
+      break;
+    case 4:
       run_algorithm_explanation();
       break;
     }
@@ -93,8 +200,10 @@ int main(void) {
 void show_menu(void) {
   printf("=== Search Algorithm Comparator ===\n\n");
   printf("1. Run Performance Comparison\n");
-  printf("2. Algorithm Explanations\n");
-  printf("3. Exit\n");
+  printf("2. Binary Search Layouts (1K - 1G elements)\n");
+  printf("3. Batched Multi-Key Search\n");
+  printf("4. Algorithm Explanations\n");
+  printf("5. Exit\n");
   printf("Option: ");
 }
 
@@ -140,29 +249,46 @@ void run_comparison_mode(void) {
     return;
   }
 
-  printf("\n=== Linear Search ===\n");
-  SearchResult lin_res = linear_search(arr, size, target);
-  if (lin_res.index != -1) {
-    printf("  - Found at index: %d\n", lin_res.index);
-  } else {
-    printf("  - Status: Not Found\n");
+  char simd_name[48];
+  snprintf(simd_name, sizeof(simd_name), "SIMD Linear Search (%s)",
+           scan_kernel_name);
+  const char *names[SEARCH_METHODS] = {"Linear Search", simd_name,
+                                       "Binary Search", "Interpolation Search",
+                                       "Exponential Search"};
+  const char *complexities[SEARCH_METHODS] = {
+      "O(n)", "O(n / 8)", "O(log n)", "O(log log n) uniform, O(n) worst",
+      "O(log i), i = position of target"};
+  SearchFunction searches[SEARCH_METHODS] = {
+      linear_search, simd_linear_search, binary_search, interpolation_search,
+      exponential_search};
+  SearchResult results[SEARCH_METHODS];
+
+  for (int m = 0; m < SEARCH_METHODS; m++) {
+    results[m] = measure_search(searches[m], arr, size, target);
   }
-  printf("  - Comparisons: %ld\n", lin_res.comparisons);
-  printf("  - Time: %.6f sec\n", lin_res.time_taken);
-  printf("  - Complexity: O(n)\n");
 
-  printf("\n=== Binary Search ===\n");
-  SearchResult bin_res = binary_search(arr, size, target);
-  if (bin_res.index != -1) {
-    printf("  - Found at index: %d\n", bin_res.index);
-  } else {
-    printf("  - Status: Not Found\n");
+  int fewest = 0;
+  int fastest = 0;
+  int agree = TRUE;
+  for (int m = 0; m < SEARCH_METHODS; m++) {
+    print_search_result(names[m], &results[m], complexities[m]);
+    if (results[m].comparisons < results[fewest].comparisons) {
+      fewest = m;
+    }
+    if (results[m].time_taken < results[fastest].time_taken) {
+      fastest = m;
+    }
+    agree = agree && results[m].index == results[0].index;
   }
-  printf("  - Comparisons: %ld\n", bin_res.comparisons);
-  printf("  - Time: %.6f sec\n", bin_res.time_taken);
-  printf("  - Complexity: O(log n)\n");
+  SearchResult lin_res = results[0];
+  SearchResult bin_res = results[2];
 
   printf("\n=== Conclusion ===\n");
+  printf("  - Results agree: %s\n", agree ? "Yes" : "NO");
+  printf("  - Fewest comparisons: %s (%ld)\n", names[fewest],
+         results[fewest].comparisons);
+  printf("  - Fastest: %s (%.1f ns per call)\n", names[fastest],
+         results[fastest].time_taken * 1e9);
   if (bin_res.comparisons > 0 && lin_res.comparisons > 0) {
     double reduction = 100.0 * (double)(lin_res.comparisons - bin_res.comparisons) / lin_res.comparisons;
     printf("  - Optimization: Binary Search used %.1f%% fewer comparisons.\n", reduction);
@@ -172,6 +298,191 @@ void run_comparison_mode(void) {
   free(arr);
 }
 
+/*
+ * Same random queries (about half hits) against every layout, for
+ * sizes 1K, 10K, ... up to the chosen maximum. At 1G the sorted array
+ * and its Eytzinger copy need 8 GB; sizes that do not fit are skipped.
+ */
+void run_layout_benchmark(void) {
+  const char *names[LAYOUT_COUNT] = {"Branchy", "Branchless", "Eytzinger"};
+  int max_size = 0;
+  int *queries = NULL;
+
+  printf("\nLargest array size (0 for default %d, max %d): ",
+         DEFAULT_LAYOUT_MAX, LAYOUT_MAX_SIZE);
+  if (read_integer(&max_size) != SUCCESS || max_size < LAYOUT_MIN_SIZE ||
+      max_size > LAYOUT_MAX_SIZE) {
+    printf("Using default (%d).\n", DEFAULT_LAYOUT_MAX);
+    max_size = DEFAULT_LAYOUT_MAX;
+  }
+
+  queries = (int *)malloc(LAYOUT_QUERIES * sizeof(int));
+  if (queries == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n%d random lookups per size (ns per lookup):\n\n",
+         LAYOUT_QUERIES);
+  printf("  %-12s | %-10s | %-10s | %-10s | %s\n", "Size", names[0],
+         names[1], names[2], "Check");
+  printf("  -------------|------------|------------|------------|------\n");
+
+  for (long long size = LAYOUT_MIN_SIZE; size <= max_size; size *= 10) {
+    int n = (int)size;
+    int *arr = NULL;
+    int *eytzinger = NULL;
+    double ns[LAYOUT_COUNT];
+    long long found[LAYOUT_COUNT];
+    HwCounters hw[LAYOUT_COUNT];
+
+    if (generate_sorted_array(&arr, n) != SUCCESS ||
+        build_eytzinger(arr, n, &eytzinger) != SUCCESS) {
+      printf("  %-12d | skipped: not enough memory\n", n);
+      free(arr);
+      continue;
+    }
+
+    for (int q = 0; q < LAYOUT_QUERIES; q++) {
+      queries[q] = rand() % (arr[n - 1] + 1);
+    }
+
+    for (int l = 0; l < LAYOUT_COUNT; l++) {
+      perf_counters_start();
+      double start = get_time_seconds();
+      found[l] = run_layout_queries((SearchLayout)l, arr, eytzinger, n,
+                                    queries, LAYOUT_QUERIES);
+      ns[l] = (get_time_seconds() - start) * 1e9 / LAYOUT_QUERIES;
+      perf_counters_stop(&hw[l]);
+    }
+
+    printf("  %-12d | %-10.1f | %-10.1f | %-10.1f | %s\n", n, ns[0], ns[1],
+           ns[2],
+           (found[0] == found[1] && found[0] == found[2]) ? "OK" : "ERROR");
+    if (hw[0].value[HW_BRANCH_MISSES] >= 0) {
+      printf("  %-12s | %-10.2f | %-10.2f | %-10.2f | br-miss/q\n", "",
+             (double)hw[0].value[HW_BRANCH_MISSES] / LAYOUT_QUERIES,
+             (double)hw[1].value[HW_BRANCH_MISSES] / LAYOUT_QUERIES,
+             (double)hw[2].value[HW_BRANCH_MISSES] / LAYOUT_QUERIES);
+    }
+    if (hw[0].value[HW_CACHE_MISSES] >= 0) {
+      printf("  %-12s | %-10.2f | %-10.2f | %-10.2f | cache-miss/q\n", "",
+             (double)hw[0].value[HW_CACHE_MISSES] / LAYOUT_QUERIES,
+             (double)hw[1].value[HW_CACHE_MISSES] / LAYOUT_QUERIES,
+             (double)hw[2].value[HW_CACHE_MISSES] / LAYOUT_QUERIES);
+    }
+
+    free(arr);
+    free(eytzinger);
+  }
+
+  printf("\n  - Small arrays fit in cache: the layouts are close.\n");
+  printf("  - Large arrays: each probe is a cache miss, so removing\n");
+  printf("    mispredictions and prefetching ahead pays off.\n\n");
+  free(queries);
+}
+
+void run_batch_benchmark(void) {
+  const int groups[] = {4, 8, 16, 32};
+  int num_groups = sizeof(groups) / sizeof(groups[0]);
+  int size = 0;
+  int count = 0;
+
+  printf("\nArray size (0 for default %d): ", DEFAULT_BATCH_SIZE);
+  if (read_integer(&size) != SUCCESS || size <= 0) {
+    printf("Using default (%d).\n", DEFAULT_BATCH_SIZE);
+    size = DEFAULT_BATCH_SIZE;
+  }
+  printf("Number of queries (0 for default %d): ", DEFAULT_BATCH_QUERIES);
+  if (read_integer(&count) != SUCCESS || count <= 0) {
+    printf("Using default (%d).\n", DEFAULT_BATCH_QUERIES);
+    count = DEFAULT_BATCH_QUERIES;
+  }
+
+  int *arr = NULL;
+  int *queries = (int *)malloc(count * sizeof(int));
+  int *sorted = (int *)malloc(count * sizeof(int));
+  int *expected = (int *)malloc(count * sizeof(int));
+  int *results = (int *)malloc(count * sizeof(int));
+  if (queries == NULL || sorted == NULL || expected == NULL ||
+      results == NULL || generate_sorted_array(&arr, size) != SUCCESS) {
+    free(queries);
+    free(sorted);
+    free(expected);
+    free(results);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  for (int q = 0; q < count; q++) {
+    queries[q] = rand() % (arr[size - 1] + 1);
+  }
+
+  printf("\n%d queries against %d sorted elements:\n\n", count, size);
+  printf("  %-26s | %-10s | %-8s | %s\n", "Method", "ns/query", "Speedup",
+         "Check");
+  printf("  ---------------------------|------------|----------|------\n");
+
+  // Reference: the classic search, one query at a time
+  double start = get_time_seconds();
+  for (int q = 0; q < count; q++) {
+    expected[q] = branchy_search(arr, size, queries[q]);
+  }
+  double base_ns = (get_time_seconds() - start) * 1e9 / count;
+  printf("  %-26s | %-10.1f | %-8.2f | %s\n", "Branchy, one at a time",
+         base_ns, 1.0, "-");
+
+  start = get_time_seconds();
+  for (int q = 0; q < count; q++) {
+    results[q] = branchless_search(arr, size, queries[q]);
+  }
+  double ns = (get_time_seconds() - start) * 1e9 / count;
+  int ok = memcmp(results, expected, count * sizeof(int)) == 0;
+  printf("  %-26s | %-10.1f | %-8.2f | %s\n", "Branchless, one at a time",
+         ns, base_ns / ns, ok ? "OK" : "ERROR");
+
+  for (int g = 0; g < num_groups; g++) {
+    char label[32];
+    snprintf(label, sizeof(label), "Batched, groups of %d", groups[g]);
+
+    start = get_time_seconds();
+    batch_search(arr, size, queries, count, groups[g], results);
+    ns = (get_time_seconds() - start) * 1e9 / count;
+    ok = memcmp(results, expected, count * sizeof(int)) == 0;
+    printf("  %-26s | %-10.1f | %-8.2f | %s\n", label, ns, base_ns / ns,
+           ok ? "OK" : "ERROR");
+  }
+
+  // Merge-join needs sorted queries; the sort is timed separately
+  memcpy(sorted, queries, count * sizeof(int));
+  start = get_time_seconds();
+  qsort(sorted, count, sizeof(int), compare_ints);
+  double sort_ns = (get_time_seconds() - start) * 1e9 / count;
+
+  start = get_time_seconds();
+  merge_join_search(arr, size, sorted, count, results);
+  ns = (get_time_seconds() - start) * 1e9 / count;
+
+  ok = TRUE;
+  for (int q = 0; q < count && ok; q++) {
+    ok = results[q] == branchy_search(arr, size, sorted[q]);
+  }
+  printf("  %-26s | %-10.1f | %-8.2f | %s\n", "Merge-join (sorted)", ns,
+         base_ns / ns, ok ? "OK" : "ERROR");
+  printf("  %-26s | %-10.1f | %-8.2f | %s\n", "Merge-join + qsort",
+         ns + sort_ns, base_ns / (ns + sort_ns), ok ? "OK" : "ERROR");
+
+  printf("\n  - Batching hides memory latency when the array is larger\n");
+  printf("    than the cache; merge-join wins when queries are dense\n");
+  printf("    or already sorted.\n\n");
+
+  free(arr);
+  free(queries);
+  free(sorted);
+  free(expected);
+  free(results);
+}
+
 void run_algorithm_explanation(void) {
   printf("\n=== Algorithm Logic ===\n\n");
   printf("1. Linear Search (O(n)):\n");
@@ -181,6 +492,33 @@ void run_algorithm_explanation(void) {
   printf("   - Requires a SORTED array.\n");
   printf("   - Repeatedly divides the search interval in half.\n");
   printf("   - Extremely fast for large datasets.\n\n");
+  printf("3. Branchless Binary Search:\n");
+  printf("   - Halves the range with a conditional move, not a branch.\n");
+  printf("   - No mispredictions; both possible next probes are\n");
+  printf("     prefetched so the memory loads overlap.\n\n");
+  printf("4. Eytzinger Layout:\n");
+  printf("   - Stores the array in BFS order of the implicit search tree\n");
+  printf("     (children of node k at 2k and 2k+1).\n");
+  printf("   - The top levels share a few cache lines, and the 16\n");
+  printf("     nodes 4 levels down sit in one prefetchable line.\n\n");
+  printf("5. SIMD Linear Search:\n");
+  printf("   - AVX2 compares 8 ints per instruction and stops at the\n");
+  printf("     first block holding the target or a larger value.\n");
+  printf("   - Still O(n), but the fastest choice for short arrays.\n\n");
+  printf("6. Interpolation Search:\n");
+  printf("   - Guesses the position from the key value, like a phone\n");
+  printf("     book: O(log log n) when keys are evenly spread.\n");
+  printf("   - Degrades to O(n) on skewed data.\n\n");
+  printf("7. Exponential Search:\n");
+  printf("   - Probes 1, 2, 4, 8, ... until it passes the target, then\n");
+  printf("     binary-searches the last range.\n");
+  printf("   - O(log i): cheap for targets near the start and works on\n");
+  printf("     unbounded lists.\n\n");
+  printf("8. Batched Search:\n");
+  printf("   - Advances a group of searches one level at a time, so\n");
+  printf("     their memory loads are in flight together.\n");
+  printf("   - Merge-join: with sorted queries, one forward cursor\n");
+  printf("     gallops through the array (O(m log(n/m))).\n\n");
 }
 
 void clear_input_buffer(void) {
@@ -215,8 +553,7 @@ Status generate_sorted_array(int **arr, int size) {
 }
 
 SearchResult linear_search(const int *arr, int size, int target) {
-  SearchResult res = {-1, 0, 0.0};
-  clock_t start = clock();
+  SearchResult res = {-1, 0, 0.0, {{0}}};
 
   for (int i = 0; i < size; i++) {
     res.comparisons++;
@@ -230,15 +567,11 @@ SearchResult linear_search(const int *arr, int size, int target) {
     }
   }
 
-  clock_t end = clock();
-  res.time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-
   return res;
 }
 
 SearchResult binary_search(const int *arr, int size, int target) {
-  SearchResult res = {-1, 0, 0.0};
-  clock_t start = clock();
+  SearchResult res = {-1, 0, 0.0, {{0}}};
 
   int low = 0;
   int high = size - 1;
@@ -259,12 +592,481 @@ SearchResult binary_search(const int *arr, int size, int target) {
     }
   }
 
-  clock_t end = clock();
-  res.time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+  return res;
+}
+
+// Cycles, instructions and misses of this process, user space only
+void perf_counters_open(void) {
+#ifdef HAVE_PERF_EVENTS
+  const unsigned long long configs[HW_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+}
+
+void perf_counters_start(void) {
+#ifdef HAVE_PERF_EVENTS
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (perf_fds[i] >= 0) {
+      ioctl(perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+// data = {value, time enabled, time running}; scaled if multiplexed
+void perf_counters_stop(HwCounters *hw) {
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    hw->value[i] = -1;
+#ifdef HAVE_PERF_EVENTS
+    unsigned long long data[3];
+    if (perf_fds[i] >= 0 &&
+        ioctl(perf_fds[i], PERF_EVENT_IOC_DISABLE, 0) == 0 &&
+        read(perf_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) &&
+        data[2] != 0) {
+      hw->value[i] = (long long)((double)data[0] * data[1] / data[2]);
+    }
+#endif
+  }
+}
+
+void print_hw_counters(const HwCounters *hw) {
+  const char *labels[HW_COUNTER_COUNT] = {"Cycles:", "Instructions:",
+                                          "Branch misses:", "Cache misses:"};
+  int available = FALSE;
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      available = TRUE;
+    }
+  }
+  if (!available) {
+    printf("  - HW counters:  N/A (perf_event_open denied)\n");
+    return;
+  }
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      printf("  - %-14s %lld\n", labels[i], hw->value[i]);
+    } else {
+      printf("  - %-14s N/A\n", labels[i]);
+    }
+  }
+  if (hw->value[HW_CYCLES] > 0 && hw->value[HW_INSTRUCTIONS] >= 0) {
+    printf("  - %-14s %.2f\n", "IPC:",
+           (double)hw->value[HW_INSTRUCTIONS] / hw->value[HW_CYCLES]);
+  }
+}
 
+/*
+ * Runs the scan kernel chosen at startup: 8 ints per AVX2 compare when
+ * the CPU supports it, else the scalar loop. comparisons counts compare
+ * instructions, so it shows the 8x reduction directly.
+ */
+SearchResult simd_linear_search(const int *arr, int size, int target) {
+  SearchResult res = {-1, 0, 0.0, {{0}}};
+  res.index = scan_kernel(arr, size, target, &res.comparisons);
   return res;
 }
 
+// Same early exit as the AVX2 kernel, one element per compare
+int linear_scan_scalar(const int *arr, int size, int target, long *compares) {
+  for (int i = 0; i < size; i++) {
+    (*compares)++;
+    if (arr[i] >= target) {
+      return arr[i] == target ? i : -1;
+    }
+  }
+  return -1;
+}
+
+#ifdef HAVE_X86_SIMD
+// Sorted input: a lane greater than target means it cannot appear later
+__attribute__((target("avx2"))) int
+linear_scan_avx2(const int *arr, int size, int target, long *compares) {
+  __m256i key = _mm256_set1_epi32(target);
+  int i = 0;
+
+  for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH) {
+    __m256i block = _mm256_loadu_si256((const __m256i *)(arr + i));
+    int equal = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(block, key)));
+    (*compares)++;
+    if (equal != 0) {
+      return i + __builtin_ctz(equal);
+    }
+    int greater = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(block, key)));
+    if (greater != 0) {
+      return -1;
+    }
+  }
+
+  int tail = linear_scan_scalar(arr + i, size - i, target, compares);
+  return tail < 0 ? -1 : i + tail;
+}
+#endif
+
+// Resolved once, so timed calls do not repeat the CPU feature check
+void select_simd_kernels(void) {
+  scan_kernel = linear_scan_scalar;
+  scan_kernel_name = "scalar";
+
+#ifdef HAVE_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    scan_kernel = linear_scan_avx2;
+    scan_kernel_name = "AVX2";
+  }
+#endif
+}
+
+/*
+ * Probes where the target would sit if keys were evenly spread between
+ * arr[low] and arr[high]. The range check also guarantees the probe
+ * stays inside [low, high]; it counts as a comparison like the probe.
+ */
+SearchResult interpolation_search(const int *arr, int size, int target) {
+  SearchResult res = {-1, 0, 0.0, {{0}}};
+
+  int low = 0;
+  int high = size - 1;
+
+  while (low <= high) {
+    res.comparisons++;
+    if (target < arr[low] || target > arr[high]) {
+      break;
+    }
+    if (arr[high] == arr[low]) {
+      res.index = arr[low] == target ? low : -1;
+      break;
+    }
+
+    long long offset = ((long long)target - arr[low]) * (high - low) /
+                       ((long long)arr[high] - arr[low]);
+    int pos = low + (int)offset;
+
+    res.comparisons++;
+    if (arr[pos] == target) {
+      res.index = pos;
+      break;
+    }
+    if (arr[pos] < target) {
+      low = pos + 1;
+    } else {
+      high = pos - 1;
+    }
+  }
+
+  return res;
+}
+
+// Doubles the bound until it passes target, then binary-searches that gap
+SearchResult exponential_search(const int *arr, int size, int target) {
+  SearchResult res = {-1, 0, 0.0, {{0}}};
+
+  long long bound = 1;
+  while (bound < size) {
+    res.comparisons++;
+    if (arr[bound] >= target) {
+      break;
+    }
+    bound *= 2;
+  }
+
+  int low = (int)(bound / 2);
+  int high = bound < size ? (int)bound : size - 1;
+  while (low <= high) {
+    res.comparisons++;
+    int mid = low + (high - low) / 2;
+
+    if (arr[mid] == target) {
+      res.index = mid;
+      break;
+    }
+    if (arr[mid] < target) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  return res;
+}
+
+/*
+ * A single search is far below the timer resolution, so the call is
+ * repeated in batches for at least SEARCH_TIMING_SECONDS. time_taken and
+ * the counters are averages per call over that loop.
+ */
+SearchResult measure_search(SearchFunction search, const int *arr, int size,
+                            int target) {
+  SearchResult res = search(arr, size, target);
+
+  // Summing every run's comparisons keeps the timed calls from being
+  // optimized out; the average is the same count as the first call
+  long long total = 0;
+  long long runs = 0;
+  double elapsed = 0.0;
+  perf_counters_start();
+  double start = get_time_seconds();
+  while (elapsed < SEARCH_TIMING_SECONDS) {
+    for (int r = 0; r < SEARCH_TIMING_BATCH; r++) {
+      total += search(arr, size, target).comparisons;
+    }
+    runs += SEARCH_TIMING_BATCH;
+    elapsed = get_time_seconds() - start;
+  }
+  perf_counters_stop(&res.hw);
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (res.hw.value[i] >= 0) {
+      res.hw.value[i] /= runs;
+    }
+  }
+  res.comparisons = (long)(total / runs);
+  res.time_taken = elapsed / runs;
+  return res;
+}
+
+void print_search_result(const char *title, const SearchResult *res,
+                         const char *complexity) {
+  printf("\n=== %s ===\n", title);
+  if (res->index != -1) {
+    printf("  - Found at index: %d\n", res->index);
+  } else {
+    printf("  - Status: Not Found\n");
+  }
+  printf("  - Comparisons: %ld\n", res->comparisons);
+  printf("  - Time: %.1f ns per call\n", res->time_taken * 1e9);
+  print_hw_counters(&res->hw);
+  printf("  - Complexity: %s\n", complexity);
+}
+
+// Same loop as binary_search, without counters, so only the search is timed
+int branchy_search(const int *arr, int size, int target) {
+  int low = 0;
+  int high = size - 1;
+
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    if (arr[mid] == target) {
+      return mid;
+    }
+    if (arr[mid] < target) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Lower bound with a fixed number of steps: each step keeps either half
+ * through a ternary the compiler turns into cmov, so there is nothing
+ * to mispredict. The probes of the next step are prefetched because
+ * they are the only loads the CPU cannot otherwise start early.
+ */
+int branchless_search(const int *arr, int size, int target) {
+  if (size <= 0) {
+    return -1;
+  }
+
+  const int *base = arr;
+  int n = size;
+  while (n > 1) {
+    int half = n / 2;
+    __builtin_prefetch(base + half / 2);
+    __builtin_prefetch(base + half + half / 2);
+    base = (base[half] < target) ? base + half : base;
+    n -= half;
+  }
+
+  int index = (int)(base - arr) + (*base < target);
+  return (index < size && arr[index] == target) ? index : -1;
+}
+
+/*
+ * Eytzinger array is 1-indexed: slot 0 is unused, node k has kids 2k,
+ * 2k+1. Slot 0 sits on a cache-line boundary, so the 16 nodes starting
+ * at 16k, four levels below k, fill exactly one line.
+ */
+Status build_eytzinger(const int *arr, int size, int **eytzinger) {
+  size_t bytes = ((size_t)size + 1) * sizeof(int);
+  void *block = NULL;
+  if (posix_memalign(&block, CACHE_LINE, bytes) != 0) {
+    *eytzinger = NULL;
+    return ERR_MEMORY_ALLOCATION;
+  }
+  *eytzinger = (int *)block;
+
+  (*eytzinger)[0] = 0;
+  eytzinger_fill(arr, *eytzinger, size, 0, 1);
+  return SUCCESS;
+}
+
+// In-order walk of the implicit tree hands out the sorted values in order
+int eytzinger_fill(const int *arr, int *eytzinger, int size, int next,
+                   long long node) {
+  if (node <= size) {
+    next = eytzinger_fill(arr, eytzinger, size, next, 2 * node);
+    eytzinger[node] = arr[next++];
+    next = eytzinger_fill(arr, eytzinger, size, next, 2 * node + 1);
+  }
+  return next;
+}
+
+/*
+ * Descends left/right branch-free. The 16 descendants four levels down
+ * are contiguous (one cache line), so a single prefetch hides most of
+ * the latency. On exit the trailing 1-bits of k record the final right
+ * turns; shifting them off (plus one) yields the lower-bound node.
+ */
+long long eytzinger_search(const int *eytzinger, int size, int target) {
+  long long k = 1;
+
+  while (k <= size) {
+    __builtin_prefetch(eytzinger + k * EYTZINGER_PREFETCH);
+    k = 2 * k + (eytzinger[k] < target);
+  }
+  k >>= __builtin_ffsll(~k);
+
+  return (k != 0 && eytzinger[k] == target) ? k : -1;
+}
+
+// Returns how many queries were found, so layouts can be cross-checked
+long long run_layout_queries(SearchLayout layout, const int *arr,
+                             const int *eytzinger, int size,
+                             const int *queries, int count) {
+  long long found = 0;
+
+  for (int q = 0; q < count; q++) {
+    switch (layout) {
+    case LAYOUT_BRANCHY:
+      found += branchy_search(arr, size, queries[q]) != -1;
+      break;
+    case LAYOUT_BRANCHLESS:
+      found += branchless_search(arr, size, queries[q]) != -1;
+      break;
+    case LAYOUT_EYTZINGER:
+      found += eytzinger_search(eytzinger, size, queries[q]) != -1;
+      break;
+    case LAYOUT_COUNT:
+      break;
+    }
+  }
+  return found;
+}
+
+/*
+ * Branchless searches run in groups: every step advances all of the
+ * group's searches by one level. A single search waits on each load,
+ * but the group's loads are independent, so up to `group` cache misses
+ * are in flight together. Once a step has picked a member's half, it
+ * prefetches that member's next probe while the rest of the group
+ * moves. results[i] is the index of queries[i] or -1.
+ */
+void batch_search(const int *arr, int size, const int *queries, int count,
+                  int group, int *results) {
+  const int *base[MAX_BATCH_GROUP];
+
+  if (group > MAX_BATCH_GROUP) {
+    group = MAX_BATCH_GROUP;
+  }
+
+  for (int start = 0; start < count; start += group) {
+    int members = count - start < group ? count - start : group;
+    const int *keys = queries + start;
+    int n = size;
+
+    for (int g = 0; g < members; g++) {
+      base[g] = arr;
+    }
+
+    while (n > 1) {
+      int half = n / 2;
+      int next_half = (n - half) / 2;
+      for (int g = 0; g < members; g++) {
+        base[g] = (base[g][half] < keys[g]) ? base[g] + half : base[g];
+        __builtin_prefetch(base[g] + next_half);
+      }
+      n -= half;
+    }
+
+    for (int g = 0; g < members; g++) {
+      int index = size > 0 ? (int)(base[g] - arr) + (*base[g] < keys[g]) : 0;
+      results[start + g] =
+          (index < size && arr[index] == keys[g]) ? index : -1;
+    }
+  }
+}
+
+/*
+ * queries must be ascending. The cursor never moves back: each lookup
+ * gallops forward (1, 2, 4, ... elements) and then binary-searches the
+ * last gap, so memory is read in order and nearby queries are cheap.
+ */
+void merge_join_search(const int *arr, int size, const int *queries,
+                       int count, int *results) {
+  int pos = 0;
+
+  for (int i = 0; i < count; i++) {
+    int target = queries[i];
+    int low = pos;
+    int high = pos;
+    int step = 1;
+
+    while (high < size && arr[high] < target) {
+      low = high + 1;
+      high += step;
+      step *= 2;
+    }
+    if (high > size) {
+      high = size;
+    }
+
+    while (low < high) {
+      int mid = low + (high - low) / 2;
+      if (arr[mid] < target) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    pos = low;
+    results[i] = (pos < size && arr[pos] == target) ? pos : -1;
+  }
+}
+
+int compare_ints(const void *a, const void *b) {
+  int x = *(const int *)a;
+  int y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
 void print_array_preview(const int *arr, int size) {
   printf("Data Preview: [");
   if (size <= 10) {
@@ -1,11 +1,31 @@
 /*
  ===============================================================================
  Exercise: 03_advanced_sorting.c
- Description: Advanced Sorting Algorithms (Merge Sort vs Quick Sort)
+ Description: Advanced Sorting Algorithms (Merge Sort vs Introsort)
  Platform: GNU/Linux (Arch/WSL) on x86_64
  ===============================================================================
  Features:
  - Implementation of O(n log n) algorithms: Merge Sort & Quick Sort
+ - Introsort: ninther pivot, Hoare partition, insertion sort for small
+   ranges and heapsort fallback, so sorted input stays O(n log n)
+ - Benchmark over random, sorted, reversed and few-unique inputs
+ - Parallel merge sort on a pthread task pool: ping-pong buffers instead
+   of copy-back, and merge-path parallel merges on the top levels
+ - Thread scaling benchmark (default 100M ints) with result validation
+ - LSD radix sort (8-bit digits, constant digits skipped) and a parallel
+   variant with per-thread histograms
+ - AVX2 bitonic sorting networks (8/16/32 ints) as the merge sort base
+   case and an 8-wide vectorized merge, selected at runtime
+ - External merge sort for binary int files larger than RAM: parallel
+   sorted runs, then a loser-tree k-way merge with large buffered I/O
+ - Generic record sorting (element size + comparator), stable and
+   unstable, plus a key/index path that moves each record only once
+ - TimSort: natural run detection, binary insertion up to minrun, and
+   galloping merges, benchmarked across levels of presortedness
+ - Headless benchmark (--bench): every sort over a size x pattern grid
+   with warmups, median/p95 wall time and CSV/JSON output
+ - Hardware counters (cycles, instructions, branch and cache misses)
+   via perf_event_open, per sort and in the benchmark output
  - Performance benchmarking (Time & Comparisons)
  - Dynamic comparison against O(n²) Bubble Sort (Estimated)
  - Handling of large arrays (heap allocation)
@@ -13,54 +33,574 @@
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__) && !defined(NO_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define HAVE_PERF_EVENTS 1
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
 
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 3
+#define MAX_OPTION 11
+#define INSERTION_THRESHOLD 16
+#define NINTHER_THRESHOLD 128
+#define FEW_UNIQUE_VALUES 16
+#define DEFAULT_PATTERN_SIZE 1000000
+#define DEFAULT_PARALLEL_SIZE 100000000
+#define MAX_THREADS 64
+#define PARALLEL_CUTOFF 65536
+#define PARALLEL_MERGE_MIN (1 << 16)
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+#define RADIX_PASSES (32 / RADIX_BITS)
+#define RADIX_SIGN_BIT 0x80000000u
+#define SORT_KERNEL_MAX 32
+#define SIMD_WIDTH 8
+#define DEFAULT_SIMD_SIZE 4000000
+#define MAX_PATH_LEN 256
+#define DEFAULT_EXTERNAL_INPUT "enteros.bin"
+#define DEFAULT_EXTERNAL_OUTPUT "enteros_ordenados.bin"
+#define DEFAULT_EXTERNAL_MEMORY_MB 256
+#define DEFAULT_GENERATE_MILLIONS 100
+#define EXTERNAL_MAX_FANIN 128
+#define MIN_RUN_BUFFER 4096
+#define GENERATE_BLOCK (1 << 20)
+#define MAX_NAME 50
+#define MAX_DEPT 50
+#define STUDENT_NAME_LEN 20
+#define DEFAULT_RECORD_COUNT 1000000
+#define KEY_BITS 64
+#define SWAP_CHUNK 64
+#define TIM_MIN_MERGE 32
+#define TIM_MIN_GALLOP 7
+#define TIM_MAX_RUNS 85
+#define DEFAULT_PRESORT_SIZE 1000000
+#define BENCH_MIN_SIZE 1000
+#define BENCH_MAX_SIZE 1000000
+#define BENCH_QUADRATIC_MAX 10000
+#define BENCH_WARMUPS 1
+#define BENCH_REPETITIONS 5
+#define BENCH_MAX_REPETITIONS 1000
+#define BENCH_SEED 12345u
+#define DEFAULT_BENCH_CSV "benchmark.csv"
+#define DEFAULT_BENCH_JSON "benchmark.json"
 
 typedef enum {
   SUCCESS,
   ERR_INVALID_INPUT,
   ERR_INVALID_OPTION,
-  ERR_MEMORY_ALLOCATION
+  ERR_MEMORY_ALLOCATION,
+  ERR_THREAD_CREATION,
+  ERR_FILE_NOT_FOUND,
+  ERR_FILE_IO
 } Status;
 
+typedef enum {
+  HW_CYCLES,
+  HW_INSTRUCTIONS,
+  HW_BRANCH_MISSES,
+  HW_CACHE_MISSES,
+  HW_COUNTER_COUNT
+} HwCounterId;
+
+// Hardware counters for one measured call; -1 when not available
+typedef struct {
+  long long value[HW_COUNTER_COUNT];
+} HwCounters;
+
 typedef struct {
   unsigned long long comparisons;
   double time_taken;
+  HwCounters hw;
 } SortStats;
 
+typedef enum {
+  PATTERN_RANDOM,
+  PATTERN_SORTED,
+  PATTERN_REVERSED,
+  PATTERN_FEW_UNIQUE,
+  PATTERN_COUNT
+} InputPattern;
+
+typedef enum {
+  PRESORT_SORTED,
+  PRESORT_REVERSED,
+  PRESORT_SWAPS_1,
+  PRESORT_SWAPS_10,
+  PRESORT_APPENDED,
+  PRESORT_RUNS,
+  PRESORT_RANDOM,
+  PRESORT_COUNT
+} PresortKind;
+
+/*
+ * Pending runs live on a stack whose lengths are kept roughly
+ * Fibonacci-like, so merges stay balanced and the stack stays tiny.
+ * min_gallop adapts: it drops while galloping pays off and rises
+ * when the inputs interleave.
+ */
+typedef struct {
+  int *arr;
+  int *temp;
+  int min_gallop;
+  int run_base[TIM_MAX_RUNS];
+  int run_len[TIM_MAX_RUNS];
+  int stack_size;
+  unsigned long long *comps;
+} TimState;
+
+typedef struct Task Task;
+typedef struct TaskPool TaskPool;
+
+/*
+ * Unit of work for the pool. Concrete tasks embed Task as their first
+ * member and recover themselves by casting in run().
+ */
+struct Task {
+  void (*run)(TaskPool *pool, Task *task);
+  Task *next;
+};
+
+// Workers pop from a shared LIFO stack; wait() returns once it drains
+struct TaskPool {
+  pthread_t threads[MAX_THREADS];
+  int num_threads;
+  pthread_mutex_t lock;
+  pthread_cond_t work_ready;
+  pthread_cond_t all_done;
+  Task *stack;
+  int outstanding;
+  int shutdown;
+};
+
+typedef struct {
+  int *arr;
+  int *temp;
+  int merge_split;
+  int merge_pieces;
+} ParallelSortJob;
+
+/*
+ * Sorts [low, high). With to_temp set the result lands in temp,
+ * otherwise in arr; children always target the opposite buffer, so
+ * every merge reads one buffer and writes the other with no copy-back.
+ */
+typedef struct SortTask {
+  Task base;
+  ParallelSortJob *job;
+  struct SortTask *parent;
+  int low;
+  int high;
+  int to_temp;
+  int pending;
+  int split;
+  void *chunks;
+} SortTask;
+
+typedef struct {
+  Task base;
+  SortTask *owner;
+  const int *src;
+  int *dst;
+  int a_low;
+  int a_high;
+  int b_low;
+  int b_high;
+  int out;
+} MergeChunkTask;
+
+// Sorts up to SORT_KERNEL_MAX ints in place
+typedef void (*SmallSortFn)(int *arr, int n);
+// Merges sorted a and b into out (no overlap)
+typedef void (*MergeRunsFn)(const int *a, int na, const int *b, int nb,
+                            int *out);
+
+typedef enum { RADIX_COUNT, RADIX_SCATTER } RadixPhase;
+
+/*
+ * One radix pass over src is a count round and a scatter round. Thread
+ * t owns slice t in both; counts[t] first holds its histogram, then its
+ * write offsets (bucket-major, thread-minor, which keeps the sort stable).
+ */
+typedef struct {
+  const int *src;
+  int *dst;
+  int size;
+  int num_threads;
+  int shift;
+  RadixPhase phase;
+  int (*counts)[RADIX_BUCKETS];
+} RadixJob;
+
+typedef struct {
+  Task base;
+  RadixJob *job;
+  int thread;
+} RadixTask;
+
+// Sequential reader over one sorted run file, refilled in large blocks
+typedef struct {
+  FILE *file;
+  int *buffer;
+  int capacity;
+  int count;
+  int pos;
+  int head;
+  int done;
+} RunReader;
+
+/*
+ * Loser tree over k runs: nodes[0] holds the index of the current
+ * minimum and nodes[1..k-1] the loser of each match, so replacing the
+ * winner costs one root-to-leaf walk of log2(k) comparisons.
+ */
+typedef struct {
+  int k;
+  int *nodes;
+  RunReader *runs;
+} LoserTree;
+
+// Same 32-byte layout as 04_file_handling/02_binary_file_handler.c
+#pragma pack(push, 1)
+typedef struct {
+  int id;
+  char nombre[STUDENT_NAME_LEN];
+  int edad;
+  float promedio;
+} Student;
+#pragma pack(pop)
+
+// Same layout as 04_file_handling/03_csv_parser.c
+typedef struct {
+  int id;
+  char name[MAX_NAME];
+  char department[MAX_DEPT];
+  float salary;
+} Employee;
+
+typedef int (*CompareFn)(const void *a, const void *b);
+// Maps a record to an unsigned key whose order matches the field order
+typedef unsigned long long (*KeyFn)(const void *record);
+
+typedef struct {
+  unsigned long long key;
+  int index;
+} KeyIndex;
+
+typedef struct {
+  long long elements;
+  long long checksum;
+  int runs;
+  int merge_passes;
+  double run_time;
+  double merge_time;
+} ExternalStats;
+
+typedef enum { FORMAT_CSV, FORMAT_JSON } BenchFormat;
+
+typedef struct {
+  int max_size;
+  int warmups;
+  int repetitions;
+  int threads;
+  BenchFormat format;
+} BenchConfig;
+
+// Uniform entry point so every sort can sit in the benchmark table
+typedef Status (*BenchSortFn)(int *arr, int *temp, int size,
+                              unsigned long long *comps);
+
+typedef struct {
+  const char *name;
+  BenchSortFn run;
+  int max_size;
+} BenchAlgorithm;
+
+typedef struct {
+  const char *algorithm;
+  const char *pattern;
+  int size;
+  int repetitions;
+  double median;
+  double p95;
+  double min;
+  unsigned long long comparisons;
+  HwCounters hw;
+  int verified;
+} BenchResult;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_benchmark(void);
 void run_algorithm_info(void);
+void run_pattern_benchmark(void);
+void run_parallel_benchmark(void);
+void run_simd_benchmark(void);
+void run_generate_int_file(void);
+void run_external_sort(void);
+void run_record_benchmark(void);
+void run_presort_benchmark(void);
+void run_full_benchmark(void);
+int read_max_threads(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
+Status read_string(char *buffer, int max_len);
+void read_path(const char *prompt, const char *fallback, char *path);
 
 Status generate_random_array(int **arr, int size);
 void run_merge_sort(int *arr, int size, SortStats *stats);
 void run_quick_sort(int *arr, int size, SortStats *stats);
+void run_radix_sort(int *arr, int size, SortStats *stats);
+void run_parallel_radix_sort(int *arr, int size, int num_threads,
+                             SortStats *stats);
 void merge_sort_recursive(int *arr, int l, int r, int *temp,
                           unsigned long long *comps);
 void merge(int *arr, int l, int m, int r, int *temp, unsigned long long *comps);
-void quick_sort_recursive(int *arr, int low, int high,
+void introsort(int *arr, int size, unsigned long long *comps);
+void introsort_loop(int *arr, int low, int high, int depth_limit,
+                    unsigned long long *comps);
+int hoare_partition(int *arr, int low, int high, unsigned long long *comps);
+int choose_pivot(const int *arr, int low, int high,
+                 unsigned long long *comps);
+int median_of_three(const int *arr, int a, int b, int c,
+                    unsigned long long *comps);
+void insertion_sort_range(int *arr, int low, int high,
+                          unsigned long long *comps);
+void heap_sort_range(int *arr, int low, int high, unsigned long long *comps);
+void sift_down(int *arr, int root, int size, unsigned long long *comps);
+void fill_pattern_array(int *arr, int size, InputPattern pattern);
+const char *pattern_name(InputPattern pattern);
+int is_sorted(const int *arr, int size);
+long long array_checksum(const int *arr, int size);
+double get_time_seconds(void);
+
+Status task_pool_init(TaskPool *pool, int num_threads);
+void task_pool_submit(TaskPool *pool, Task *task);
+void task_pool_wait(TaskPool *pool);
+void task_pool_destroy(TaskPool *pool);
+void *task_pool_worker(void *arg);
+
+Status parallel_merge_sort(int *arr, int *temp, int size, int num_threads);
+SortTask *new_sort_task(ParallelSortJob *job, SortTask *parent, int low,
+                        int high, int to_temp);
+void sort_task_run(TaskPool *pool, Task *task);
+void sort_task_finish(TaskPool *pool, SortTask *st);
+void merge_chunk_run(TaskPool *pool, Task *task);
+void merge_sort_pingpong(int *arr, int *temp, int low, int high,
+                         int to_temp);
+int merge_co_rank(const int *a, int na, const int *b, int nb, int k);
+int radix_digit(int value, int shift);
+void radix_sort(int *arr, int *temp, int size);
+Status parallel_radix_sort(int *arr, int *temp, int size, int num_threads);
+void radix_task_run(TaskPool *pool, Task *task);
+int default_thread_count(void);
+
+void sort_small_scalar(int *arr, int n);
+void merge_runs_scalar(const int *a, int na, const int *b, int nb, int *out);
+#ifdef HAVE_X86_SIMD
+__m256i bitonic_clean_8(__m256i v);
+__m256i bitonic_sort_8(__m256i v);
+__m256i reverse_8(__m256i v);
+void bitonic_merge_8x8(__m256i *a, __m256i *b);
+void bitonic_clean_16(__m256i *a, __m256i *b);
+void sort_small_avx2(int *arr, int n);
+void merge_runs_avx2(const int *a, int na, const int *b, int nb, int *out);
+#endif
+void select_simd_kernels(void);
+
+Status external_sort(const char *input, const char *output,
+                     size_t memory_bytes, int num_threads,
+                     ExternalStats *stats);
+Status merge_run_files(const char *base, int pass, int first, int count,
+                       const char *dest, size_t memory_bytes);
+void run_file_path(char *path, const char *base, int pass, int index);
+Status write_ints(FILE *file, const int *values, size_t count);
+Status run_reader_open(RunReader *reader, const char *path, int capacity);
+void run_reader_next(RunReader *reader);
+void run_reader_close(RunReader *reader);
+Status loser_tree_init(LoserTree *tree, RunReader *runs, int k);
+void loser_tree_adjust(LoserTree *tree, int leaf);
+int loser_tree_beats(const LoserTree *tree, int a, int b);
+Status verify_sorted_file(const char *path, long long *count,
+                          long long *checksum, int *sorted);
+double time_small_sort(SmallSortFn kernel, const int *src, int *work,
+                       int size, int width);
+
+Status generic_merge_sort(void *base, int count, size_t size, CompareFn cmp);
+void generic_merge_pingpong(char *arr, char *temp, int low, int high,
+                            int to_temp, size_t size, CompareFn cmp);
+Status generic_introsort(void *base, int count, size_t size, CompareFn cmp);
+void generic_introsort_loop(char *arr, int low, int high, int depth_limit,
+                            size_t size, CompareFn cmp, char *scratch);
+void generic_insertion_sort(char *arr, int low, int high, size_t size,
+                            CompareFn cmp, char *scratch);
+void generic_heap_sort(char *arr, int low, int high, size_t size,
+                       CompareFn cmp);
+void generic_sift_down(char *arr, int root, int count, size_t size,
+                       CompareFn cmp);
+void generic_swap(void *a, void *b, size_t size);
+Status sort_records_by_key(void *base, int count, size_t size, KeyFn key,
+                           CompareFn tie_break);
+void radix_sort_pairs(KeyIndex *pairs, KeyIndex *temp, int count);
+void sort_tied_indices(KeyIndex *run, KeyIndex *temp, int count,
+                       const char *base, size_t size, CompareFn cmp);
+void apply_permutation(void *base, int *perm, int count, size_t size,
+                       void *scratch);
+
+unsigned long long key_from_float(float value);
+unsigned long long key_from_string(const char *text, size_t max_len);
+unsigned long long student_key_promedio(const void *record);
+int compare_student_promedio(const void *a, const void *b);
+unsigned long long employee_key_salary(const void *record);
+int compare_employee_salary(const void *a, const void *b);
+unsigned long long employee_key_name(const void *record);
+int compare_employee_name(const void *a, const void *b);
+Status tim_sort(int *arr, int size, unsigned long long *comps);
+int tim_min_run(int n);
+int tim_count_run(int *arr, int low, int high, unsigned long long *comps);
+void tim_binary_insertion(int *arr, int low, int high, int start,
                           unsigned long long *comps);
-int partition(int *arr, int low, int high, unsigned long long *comps);
+void tim_merge_collapse(TimState *ts);
+void tim_merge_force_collapse(TimState *ts);
+void tim_merge_at(TimState *ts, int i);
+void tim_merge_lo(TimState *ts, int base1, int len1, int base2, int len2);
+void tim_merge_hi(TimState *ts, int base1, int len1, int base2, int len2);
+int gallop_left(int key, const int *arr, int n, int hint,
+                unsigned long long *comps);
+int gallop_right(int key, const int *arr, int n, int hint,
+                 unsigned long long *comps);
+void reverse_range(int *arr, int low, int high);
+void fill_presorted_array(int *arr, int size, PresortKind kind);
+const char *presort_name(PresortKind kind);
+void bubble_sort(int *arr, int size, unsigned long long *comps);
+void selection_sort(int *arr, int size, unsigned long long *comps);
+Status bench_bubble(int *arr, int *temp, int size, unsigned long long *comps);
+Status bench_selection(int *arr, int *temp, int size,
+                       unsigned long long *comps);
+Status bench_insertion(int *arr, int *temp, int size,
+                       unsigned long long *comps);
+Status bench_merge(int *arr, int *temp, int size, unsigned long long *comps);
+Status bench_introsort(int *arr, int *temp, int size,
+                       unsigned long long *comps);
+Status bench_timsort(int *arr, int *temp, int size, unsigned long long *comps);
+Status bench_radix(int *arr, int *temp, int size, unsigned long long *comps);
+Status bench_parallel_merge(int *arr, int *temp, int size,
+                            unsigned long long *comps);
+Status bench_parallel_radix(int *arr, int *temp, int size,
+                            unsigned long long *comps);
+Status parse_bench_args(int argc, char *argv[], BenchConfig *config,
+                        char *path);
+Status run_benchmark_suite(FILE *out, const BenchConfig *config,
+                           int *failures);
+Status benchmark_cell(const BenchAlgorithm *algo, const int *master,
+                      int *work, int *temp, int size,
+                      const BenchConfig *config, BenchResult *result);
+void write_bench_result(FILE *out, BenchFormat format,
+                        const BenchResult *result, int first);
+double percentile(const double *sorted, int count, double fraction);
+void sort_doubles(double *values, int count);
+const char *pattern_key(InputPattern pattern);
+void perf_counters_open(void);
+void perf_counters_start(void);
+void perf_counters_stop(HwCounters *hw);
+void print_hw_counters(const HwCounters *hw);
+void generate_students(Student *students, int count);
+void generate_employees(Employee *employees, int count);
+int record_id(const void *record);
+const char *check_record_order(const void *base, int count, size_t size,
+                               CompareFn cmp);
+void benchmark_record_sorts(const char *title, const void *source, void *work,
+                            int count, size_t size, CompareFn cmp, KeyFn key,
+                            CompareFn tie_break);
+
+SmallSortFn small_sort_kernel = sort_small_scalar;
+MergeRunsFn merge_kernel = merge_runs_scalar;
+const char *simd_kernel_name = "escalar";
+int bench_threads = 1;
+int headless_mode = FALSE;
+int perf_fds[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
+
+/*
+ * Everything the headless benchmark runs. O(n²) sorts stop at
+ * BENCH_QUADRATIC_MAX so the full grid still finishes in minutes.
+ */
+const BenchAlgorithm bench_algorithms[] = {
+    {"bubble", bench_bubble, BENCH_QUADRATIC_MAX},
+    {"selection", bench_selection, BENCH_QUADRATIC_MAX},
+    {"insertion", bench_insertion, BENCH_QUADRATIC_MAX},
+    {"merge", bench_merge, BENCH_MAX_SIZE},
+    {"introsort", bench_introsort, BENCH_MAX_SIZE},
+    {"timsort", bench_timsort, BENCH_MAX_SIZE},
+    {"radix", bench_radix, BENCH_MAX_SIZE},
+    {"parallel_merge", bench_parallel_merge, BENCH_MAX_SIZE},
+    {"parallel_radix", bench_parallel_radix, BENCH_MAX_SIZE},
+};
+const int bench_algorithm_count =
+    (int)(sizeof(bench_algorithms) / sizeof(bench_algorithms[0]));
 void show_final_comparison(int size, SortStats merge_stats,
-                           SortStats quick_stats);
+                           SortStats quick_stats, SortStats radix_stats);
 void print_array_preview(const int *arr, int size);
 void copy_array(const int *src, int *dest, int size);
 void swap(int *a, int *b);
 
-int main(void) {
+int main(int argc, char *argv[]) {
   int option = 0;
   srand(time(NULL));
+  select_simd_kernels();
+  perf_counters_open();
+
+  // Headless mode: no prompts, results to a file or stdout for diffing
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    BenchConfig config;
+    char path[MAX_PATH_LEN] = "-";
+    int failures = 0;
+
+    headless_mode = TRUE;
+    if (parse_bench_args(argc, argv, &config, path) != SUCCESS) {
+      fprintf(stderr,
+              "Uso: %s --bench [--format csv|json] [--output archivo]\n"
+              "       [--reps N] [--warmups N] [--max-size N] "
+              "[--threads N]\n",
+              argv[0]);
+      return 1;
+    }
+
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (out == NULL) {
+      handle_error(ERR_FILE_NOT_FOUND);
+      return 1;
+    }
+    Status status = run_benchmark_suite(out, &config, &failures);
+    if (out != stdout) {
+      fclose(out);
+    }
+    if (status != SUCCESS) {
+      handle_error(status);
+      return 1;
+    }
+    return failures == 0 ? 0 : 1;
+  }
 
   while (TRUE) {
     show_menu();
@@ -85,6 +625,30 @@ int main(void) {
       run_benchmark();
       break;
     case 2:
+      run_pattern_benchmark();
+      break;
+    case 3:
+      run_parallel_benchmark();
+      break;
+    case 4:
+      run_simd_benchmark();
+      break;
+    case 5:
+      run_generate_int_file();
+      break;
+    case 6:
+      run_external_sort();
+      break;
+    case 7:
+      run_record_benchmark();
+      break;
+    case 8:
+      run_presort_benchmark();
+      break;
+    case 9:
+      run_full_benchmark();
+      break;
+    case 10:
       run_algorithm_info();
       break;
     }
@@ -95,22 +659,43 @@ int main(void) {
 
 void show_menu(void) {
   printf("=== Algoritmos de Ordenamiento Avanzados ===\n\n");
-  printf("1. Ejecutar Benchmark (Merge Sort vs Quick Sort)\n"
-         "2. Información de Algoritmos\n"
-         "3. Salir\n");
+  printf("1. Ejecutar Benchmark (Merge, Introsort y Radix)\n"
+         "2. Benchmark por patrón de entrada\n"
+         "3. Escalabilidad de Merge Sort paralelo\n"
+         "4. Kernels SIMD (redes bitónicas)\n"
+         "5. Generar archivo binario de enteros\n"
+         "6. Ordenamiento externo (archivo > RAM)\n"
+         "7. Ordenar registros (Student / Employee)\n"
+         "8. TimSort vs orden previo de los datos\n"
+         "9. Benchmark completo (CSV/JSON)\n"
+         "10. Información de Algoritmos\n"
+         "11. Salir\n");
   printf("Opción: ");
 }
 
 void handle_error(Status status) {
+  // In --bench mode stdout carries the CSV/JSON rows
+  FILE *stream = headless_mode ? stderr : stdout;
+
   switch (status) {
   case ERR_INVALID_INPUT:
-    printf("Error: Entrada inválida. Por favor ingrese un número.\n\n");
+    fprintf(stream,
+            "Error: Entrada inválida. Por favor ingrese un número.\n\n");
     break;
   case ERR_INVALID_OPTION:
-    printf("Error: Opción inválida seleccionada.\n\n");
+    fprintf(stream, "Error: Opción inválida seleccionada.\n\n");
     break;
   case ERR_MEMORY_ALLOCATION:
-    printf("Error: Memoria insuficiente.\n\n");
+    fprintf(stream, "Error: Memoria insuficiente.\n\n");
+    break;
+  case ERR_THREAD_CREATION:
+    fprintf(stream, "Error: No se pudieron crear los hilos.\n\n");
+    break;
+  case ERR_FILE_NOT_FOUND:
+    fprintf(stream, "Error: No se pudo abrir el archivo.\n\n");
+    break;
+  case ERR_FILE_IO:
+    fprintf(stream, "Error: Fallo de lectura/escritura en disco.\n\n");
     break;
   case SUCCESS:
     break;
@@ -121,8 +706,11 @@ void run_benchmark(void) {
   int size = 0;
   int *master_arr = NULL;
   int *work_arr = NULL;
-  SortStats merge_stats = {0, 0.0};
-  SortStats quick_stats = {0, 0.0};
+  SortStats merge_stats = {0, 0.0, {{0}}};
+  SortStats quick_stats = {0, 0.0, {{0}}};
+  SortStats radix_stats = {0, 0.0, {{0}}};
+  SortStats par_radix_stats = {0, 0.0, {{0}}};
+  int threads = default_thread_count();
 
   printf("\nIngrese tamaño del array (Recomendado 1000+): ");
   if (read_integer(&size) != SUCCESS || size < 2) {
@@ -150,11 +738,19 @@ void run_benchmark(void) {
   copy_array(master_arr, work_arr, size);
   run_merge_sort(work_arr, size, &merge_stats);
 
-  printf("\n=== Quick Sort ===\n");
+  printf("\n=== Introsort ===\n");
   copy_array(master_arr, work_arr, size);
   run_quick_sort(work_arr, size, &quick_stats);
 
-  show_final_comparison(size, merge_stats, quick_stats);
+  printf("\n=== Radix Sort (LSD) ===\n");
+  copy_array(master_arr, work_arr, size);
+  run_radix_sort(work_arr, size, &radix_stats);
+
+  printf("\n=== Radix Sort paralelo (%d hilos) ===\n", threads);
+  copy_array(master_arr, work_arr, size);
+  run_parallel_radix_sort(work_arr, size, threads, &par_radix_stats);
+
+  show_final_comparison(size, merge_stats, quick_stats, radix_stats);
 
   free(master_arr);
   free(work_arr);
@@ -166,166 +762,3339 @@ void run_algorithm_info(void) {
   printf("  - Complejidad: O(n log n) en todos los casos\n");
   printf("  - Memoria adicional: O(n)\n");
   printf("  - Estable: Sí\n\n");
-  printf("Quick Sort:\n");
-  printf("  - Complejidad: O(n log n) promedio, O(n²) peor caso\n");
+  printf("Merge Sort paralelo:\n");
+  printf("  - Subtareas en un pool de hilos por encima de %d elementos\n",
+         PARALLEL_CUTOFF);
+  printf("  - Alterna array y temp por nivel (sin copia de vuelta)\n");
+  printf("  - Niveles superiores: merge paralelo por particiones\n");
+  printf("  - Casos base: red bitónica de <= %d enteros y merge de %d\n",
+         SORT_KERNEL_MAX, SIMD_WIDTH);
+  printf("    en paralelo (kernels activos: %s)\n\n", simd_kernel_name);
+  printf("Radix Sort (LSD):\n");
+  printf("  - Complejidad: O(n * k), k = %d pasadas de %d bits\n",
+         RADIX_PASSES, RADIX_BITS);
+  printf("  - No compara: cuenta dígitos y los reparte (prefix-sum)\n");
+  printf("  - Omite las pasadas cuyo dígito es igual en todo el array\n");
+  printf("  - Memoria adicional: O(n + %d)\n", RADIX_BUCKETS);
+  printf("  - Estable: Sí\n\n");
+  printf("TimSort (adaptativo):\n");
+  printf("  - Detecta runs ascendentes y descendentes (que invierte)\n");
+  printf("  - Runs cortos se extienden a minrun con inserción binaria\n");
+  printf("  - Merge con galope: busca exponencial cuando un run domina\n");
+  printf("  - Complejidad: O(n) con datos ordenados, O(n log n) peor caso\n");
+  printf("  - Estable: Sí\n\n");
+  printf("Benchmark completo:\n");
+  printf("  - Todos los algoritmos x tamaños (%d..%d) x patrones\n",
+         BENCH_MIN_SIZE, BENCH_MAX_SIZE);
+  printf("  - %d calentamiento(s), %d repeticiones: mediana y p95\n",
+         BENCH_WARMUPS, BENCH_REPETITIONS);
+  printf("  - Entradas con semilla fija: CSV/JSON comparables entre builds\n");
+  printf("  - Sin menú: ./programa --bench --format json --output r.json\n\n");
+  printf("Ordenamiento de registros:\n");
+  printf("  - Genéricos: tamaño de elemento + comparador (como qsort)\n");
+  printf("  - Clave/índice: ordena pares (clave, índice) con Radix y\n"
+         "    permuta los registros una sola vez por ciclos\n\n");
+  printf("Ordenamiento externo:\n");
+  printf("  - Fase 1: runs ordenados en paralelo del tamaño de la memoria\n");
+  printf("  - Fase 2: merge de hasta %d runs con árbol de perdedores\n",
+         EXTERNAL_MAX_FANIN);
+  printf("  - E/S en bloques grandes; memoria acotada sin importar el\n"
+         "    tamaño del archivo\n\n");
+  printf("Introsort (Quick Sort híbrido):\n");
+  printf("  - Complejidad: O(n log n) en todos los casos\n");
+  printf("  - Pivote: mediana de tres (ninther en rangos grandes)\n");
+  printf("  - Rangos pequeños: Insertion Sort (<= %d elementos)\n",
+         INSERTION_THRESHOLD);
+  printf("  - Respaldo: Heap Sort al superar 2*log2(n) niveles\n");
   printf("  - Memoria adicional: O(log n) (stack de recursión)\n");
   printf("  - Estable: No\n\n");
   printf("Recomendación:\n");
   printf("  - Merge Sort: cuando se necesita estabilidad garantizada\n");
-  printf("  - Quick Sort: mejor rendimiento en promedio para datos aleatorios\n\n");
+  printf("  - Introsort: mejor promedio y sin peor caso O(n²)\n\n");
 }
 
-void clear_input_buffer(void) {
-  int c;
-  while ((c = getchar()) != '\n' && c != EOF) {
-    ;
+void run_pattern_benchmark(void) {
+  int size = 0;
+
+  printf("\nIngrese tamaño del array (defecto %d): ", DEFAULT_PATTERN_SIZE);
+  if (read_integer(&size) != SUCCESS || size < 2) {
+    printf("Tamaño inválido. Usando defecto (%d).\n", DEFAULT_PATTERN_SIZE);
+    size = DEFAULT_PATTERN_SIZE;
   }
-}
 
-Status read_integer(int *value) {
-  if (scanf("%d", value) != 1) {
-    clear_input_buffer();
-    return ERR_INVALID_INPUT;
+  int *master_arr = (int *)malloc(size * sizeof(int));
+  int *work_arr = (int *)malloc(size * sizeof(int));
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (master_arr == NULL || work_arr == NULL || temp == NULL) {
+    free(master_arr);
+    free(work_arr);
+    free(temp);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
   }
-  clear_input_buffer();
-  return SUCCESS;
+
+  printf("\n  %-12s %-12s %-12s %-16s %s\n", "Patrón", "Merge (s)",
+         "Intro (s)", "Comps Intro", "Verificación");
+
+  for (int p = 0; p < PATTERN_COUNT; p++) {
+    SortStats merge_stats = {0, 0.0, {{0}}};
+    SortStats intro_stats = {0, 0.0, {{0}}};
+    fill_pattern_array(master_arr, size, (InputPattern)p);
+
+    copy_array(master_arr, work_arr, size);
+    double start = get_time_seconds();
+    merge_sort_recursive(work_arr, 0, size - 1, temp,
+                         &merge_stats.comparisons);
+    merge_stats.time_taken = get_time_seconds() - start;
+    int merge_ok = is_sorted(work_arr, size);
+
+    copy_array(master_arr, work_arr, size);
+    start = get_time_seconds();
+    introsort(work_arr, size, &intro_stats.comparisons);
+    intro_stats.time_taken = get_time_seconds() - start;
+    int intro_ok = is_sorted(work_arr, size);
+
+    printf("  %-12s %-12.6f %-12.6f %-16llu %s\n",
+           pattern_name((InputPattern)p), merge_stats.time_taken,
+           intro_stats.time_taken, intro_stats.comparisons,
+           (merge_ok && intro_ok) ? "OK" : "ERROR");
+  }
+  printf("\n");
+
+  free(master_arr);
+  free(work_arr);
+  free(temp);
 }
 
-Status generate_random_array(int **arr, int size) {
-  *arr = (int *)malloc(size * sizeof(int));
-  if (*arr == NULL) {
-    return ERR_MEMORY_ALLOCATION;
+void run_parallel_benchmark(void) {
+  int size = 0;
+
+  printf("\nIngrese tamaño del array (defecto %d): ", DEFAULT_PARALLEL_SIZE);
+  if (read_integer(&size) != SUCCESS || size < 2) {
+    printf("Tamaño inválido. Usando defecto (%d).\n", DEFAULT_PARALLEL_SIZE);
+    size = DEFAULT_PARALLEL_SIZE;
   }
+  int max_threads = read_max_threads();
 
-  for (int i = 0; i < size; i++) {
-    (*arr)[i] = rand() % 10000;
+  int *master_arr = (int *)malloc((size_t)size * sizeof(int));
+  int *work_arr = (int *)malloc((size_t)size * sizeof(int));
+  int *temp = (int *)malloc((size_t)size * sizeof(int));
+  if (master_arr == NULL || work_arr == NULL || temp == NULL) {
+    free(master_arr);
+    free(work_arr);
+    free(temp);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
   }
-  return SUCCESS;
+
+  printf("Generando array aleatorio de %d elementos...\n", size);
+  fill_pattern_array(master_arr, size, PATTERN_RANDOM);
+  long long checksum = array_checksum(master_arr, size);
+
+  unsigned long long comps = 0;
+  copy_array(master_arr, work_arr, size);
+  double start = get_time_seconds();
+  merge_sort_recursive(work_arr, 0, size - 1, temp, &comps);
+  double serial_time = get_time_seconds() - start;
+
+  printf("\n  Serial (con copia de vuelta): %.4f s\n\n", serial_time);
+  printf("  %-8s %-12s %-10s %s\n", "Hilos", "Tiempo (s)", "Speedup",
+         "Verificación");
+
+  for (int threads = 1; threads <= max_threads;) {
+    copy_array(master_arr, work_arr, size);
+    start = get_time_seconds();
+    Status status = parallel_merge_sort(work_arr, temp, size, threads);
+    double elapsed = get_time_seconds() - start;
+    if (status != SUCCESS) {
+      handle_error(status);
+      break;
+    }
+
+    int ok = is_sorted(work_arr, size) &&
+             array_checksum(work_arr, size) == checksum;
+    printf("  %-8d %-12.4f %-10.2f %s\n", threads, elapsed,
+           elapsed > 0 ? serial_time / elapsed : 0.0, ok ? "OK" : "ERROR");
+
+    if (threads == max_threads)
+      break;
+    threads = (threads * 2 > max_threads) ? max_threads : threads * 2;
+  }
+  printf("\n");
+
+  free(master_arr);
+  free(work_arr);
+  free(temp);
 }
 
-void run_merge_sort(int *arr, int size, SortStats *stats) {
-  printf("Ejecutando...\n");
+int read_max_threads(void) {
+  int max_threads = 0;
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+  printf("Máximo de hilos (defecto %ld): ", online > 0 ? online : 1);
+  if (read_integer(&max_threads) != SUCCESS || max_threads < 1) {
+    max_threads = online > 0 ? (int)online : 1;
+  }
+  if (max_threads > MAX_THREADS) {
+    max_threads = MAX_THREADS;
+  }
+  return max_threads;
+}
+
+void run_simd_benchmark(void) {
+  int size = 0;
+
+  printf("\nIngrese tamaño del array (defecto %d): ", DEFAULT_SIMD_SIZE);
+  if (read_integer(&size) != SUCCESS || size < 2 * SORT_KERNEL_MAX) {
+    printf("Tamaño inválido. Usando defecto (%d).\n", DEFAULT_SIMD_SIZE);
+    size = DEFAULT_SIMD_SIZE;
+  }
+
+#ifndef HAVE_X86_SIMD
+  printf("\nEsta plataforma no tiene kernels SIMD; solo escalar.\n\n");
+#else
+  if (small_sort_kernel == sort_small_scalar) {
+    printf("\nLa CPU no soporta AVX2; solo se usan kernels escalares.\n\n");
+    return;
+  }
 
+  int *master_arr = (int *)malloc(size * sizeof(int));
+  int *work_arr = (int *)malloc(size * sizeof(int));
   int *temp = (int *)malloc(size * sizeof(int));
-  if (temp == NULL) {
+  if (master_arr == NULL || work_arr == NULL || temp == NULL) {
+    free(master_arr);
+    free(work_arr);
+    free(temp);
     handle_error(ERR_MEMORY_ALLOCATION);
     return;
   }
+  fill_pattern_array(master_arr, size, PATTERN_RANDOM);
+  long long checksum = array_checksum(master_arr, size);
 
-  clock_t start = clock();
-  merge_sort_recursive(arr, 0, size - 1, temp, &stats->comparisons);
-  clock_t end = clock();
+  printf("\n=== Casos base: bloques independientes ===\n\n");
+  printf("  %-8s %-16s %-16s %s\n", "Bloque", "Escalar (ns)", "AVX2 (ns)",
+         "Speedup");
+  for (int width = 8; width <= SORT_KERNEL_MAX; width *= 2) {
+    double scalar = time_small_sort(sort_small_scalar, master_arr, work_arr,
+                                    size, width);
+    double simd = time_small_sort(sort_small_avx2, master_arr, work_arr,
+                                  size, width);
+    printf("  %-8d %-16.1f %-16.1f %.2fx\n", width, scalar, simd,
+           simd > 0 ? scalar / simd : 0.0);
+  }
 
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-  free(temp);
+  // Merge of the two sorted halves in isolation
+  int half = size / 2;
+  copy_array(master_arr, work_arr, size);
+  radix_sort(work_arr, temp, half);
+  radix_sort(work_arr + half, temp, size - half);
 
-  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
-  printf("  - Comparaciones: %llu\n", stats->comparisons);
-  printf("  - Complejidad:   O(n log n)\n");
-  printf("  - Memoria extra: O(n)\n");
-}
+  printf("\n=== Merge de dos runs de %d ===\n\n", half);
+  double start = get_time_seconds();
+  merge_runs_scalar(work_arr, half, work_arr + half, size - half, temp);
+  double scalar_merge = get_time_seconds() - start;
+  start = get_time_seconds();
+  merge_runs_avx2(work_arr, half, work_arr + half, size - half, master_arr);
+  double simd_merge = get_time_seconds() - start;
+  int merge_ok = memcmp(temp, master_arr, size * sizeof(int)) == 0 &&
+                 is_sorted(temp, size);
+  printf("  - Escalar: %.4f s\n", scalar_merge);
+  printf("  - AVX2:    %.4f s (%.2fx) %s\n", simd_merge,
+         simd_merge > 0 ? scalar_merge / simd_merge : 0.0,
+         merge_ok ? "OK" : "ERROR");
 
-void merge_sort_recursive(int *arr, int l, int r, int *temp,
-                          unsigned long long *comps) {
-  if (l < r) {
-    int m = l + (r - l) / 2;
-    merge_sort_recursive(arr, l, m, temp, comps);
-    merge_sort_recursive(arr, m + 1, r, temp, comps);
-    merge(arr, l, m, r, temp, comps);
+  // The merge above overwrote master_arr, so regenerate it
+  fill_pattern_array(master_arr, size, PATTERN_RANDOM);
+  checksum = array_checksum(master_arr, size);
+
+  printf("\n=== Merge Sort completo (ping-pong, 1 hilo) ===\n\n");
+  printf("  %-24s %-12s %s\n", "Kernels", "Tiempo (s)", "Verificación");
+
+  const char *names[] = {"Escalar", "Red bitónica", "Red bitónica + merge"};
+  SmallSortFn leaves[] = {sort_small_scalar, sort_small_avx2,
+                          sort_small_avx2};
+  MergeRunsFn merges[] = {merge_runs_scalar, merge_runs_scalar,
+                          merge_runs_avx2};
+  for (int v = 0; v < 3; v++) {
+    small_sort_kernel = leaves[v];
+    merge_kernel = merges[v];
+
+    copy_array(master_arr, work_arr, size);
+    start = get_time_seconds();
+    merge_sort_pingpong(work_arr, temp, 0, size, FALSE);
+    double elapsed = get_time_seconds() - start;
+
+    int ok = is_sorted(work_arr, size) &&
+             array_checksum(work_arr, size) == checksum;
+    printf("  %-24s %-12.4f %s\n", names[v], elapsed, ok ? "OK" : "ERROR");
   }
+  printf("\n");
+
+  select_simd_kernels();
+  free(master_arr);
+  free(work_arr);
+  free(temp);
+#endif
 }
 
-void merge(int *arr, int l, int m, int r, int *temp,
-           unsigned long long *comps) {
-  int i = l;
-  int j = m + 1;
-  int k = l;
+// Average nanoseconds per block of `width` ints sorted by kernel
+double time_small_sort(SmallSortFn kernel, const int *src, int *work,
+                       int size, int width) {
+  int blocks = size / width;
 
-  while (i <= m && j <= r) {
-    (*comps)++;
-    if (arr[i] <= arr[j]) {
-      temp[k++] = arr[i++];
-    } else {
-      temp[k++] = arr[j++];
+  copy_array(src, work, blocks * width);
+  double start = get_time_seconds();
+  for (int b = 0; b < blocks; b++) {
+    kernel(work + b * width, width);
+  }
+  double elapsed = get_time_seconds() - start;
+
+  for (int b = 0; b < blocks; b++) {
+    if (!is_sorted(work + b * width, width)) {
+      printf("  ! Bloque %d mal ordenado\n", b);
+      break;
     }
   }
+  return blocks > 0 ? elapsed * 1e9 / blocks : 0.0;
+}
 
-  while (i <= m) {
-    temp[k++] = arr[i++];
+void run_generate_int_file(void) {
+  char path[MAX_PATH_LEN];
+  int millions = 0;
+
+  printf("\n");
+  read_path("Archivo de salida", DEFAULT_EXTERNAL_INPUT, path);
+  printf("Cantidad de enteros en millones (defecto %d): ",
+         DEFAULT_GENERATE_MILLIONS);
+  if (read_integer(&millions) != SUCCESS || millions < 1) {
+    millions = DEFAULT_GENERATE_MILLIONS;
   }
-  while (j <= r) {
-    temp[k++] = arr[j++];
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+  int *block = (int *)malloc(GENERATE_BLOCK * sizeof(int));
+  if (block == NULL) {
+    fclose(file);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
   }
 
-  for (i = l; i <= r; i++) {
-    arr[i] = temp[i];
+  long long total = (long long)millions * 1000000;
+  double start = get_time_seconds();
+  Status status = SUCCESS;
+  for (long long written = 0; written < total && status == SUCCESS;) {
+    int n = total - written < GENERATE_BLOCK ? (int)(total - written)
+                                              : GENERATE_BLOCK;
+    fill_pattern_array(block, n, PATTERN_RANDOM);
+    status = write_ints(file, block, n);
+    written += n;
+  }
+  if (fclose(file) != 0 && status == SUCCESS) {
+    status = ERR_FILE_IO;
+  }
+  free(block);
+
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
   }
+  printf("  - %lld enteros (%.1f MB) escritos en %s en %.2f s\n\n", total,
+         total * sizeof(int) / 1e6, path, get_time_seconds() - start);
 }
 
-void run_quick_sort(int *arr, int size, SortStats *stats) {
-  printf("Ejecutando...\n");
+void run_external_sort(void) {
+  char input[MAX_PATH_LEN], output[MAX_PATH_LEN];
+  int memory_mb = 0;
+  ExternalStats stats;
 
-  clock_t start = clock();
-  quick_sort_recursive(arr, 0, size - 1, &stats->comparisons);
-  clock_t end = clock();
+  printf("\n");
+  read_path("Archivo de entrada", DEFAULT_EXTERNAL_INPUT, input);
+  read_path("Archivo de salida", DEFAULT_EXTERNAL_OUTPUT, output);
+  printf("Memoria para runs en MB (defecto %d): ", DEFAULT_EXTERNAL_MEMORY_MB);
+  if (read_integer(&memory_mb) != SUCCESS || memory_mb < 1) {
+    memory_mb = DEFAULT_EXTERNAL_MEMORY_MB;
+  }
+  int threads = read_max_threads();
 
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+  Status status = external_sort(input, output, (size_t)memory_mb << 20,
+                                threads, &stats);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
 
-  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
-  printf("  - Comparaciones: %llu\n", stats->comparisons);
-  printf("  - Complejidad:   O(n log n) promedio\n");
-  printf("  - Memoria extra: O(log n) (Stack)\n");
-}
+  printf("\n  - Elementos:       %lld (%.1f MB)\n", stats.elements,
+         stats.elements * sizeof(int) / 1e6);
+  printf("  - Runs iniciales:  %d\n", stats.runs);
+  printf("  - Pasadas merge:   %d\n", stats.merge_passes);
+  printf("  - Fase de runs:    %.3f s\n", stats.run_time);
+  printf("  - Fase de merge:   %.3f s\n", stats.merge_time);
 
-void quick_sort_recursive(int *arr, int low, int high,
-                          unsigned long long *comps) {
-  if (low < high) {
-    int pi = partition(arr, low, high, comps);
-    quick_sort_recursive(arr, low, pi - 1, comps);
-    quick_sort_recursive(arr, pi + 1, high, comps);
+  long long count = 0;
+  long long checksum = 0;
+  int sorted = FALSE;
+  status = verify_sorted_file(output, &count, &checksum, &sorted);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
   }
+  printf("  - Verificación:    %s\n\n",
+         (sorted && count == stats.elements && checksum == stats.checksum)
+             ? "OK"
+             : "ERROR");
 }
 
-int partition(int *arr, int low, int high, unsigned long long *comps) {
-  int pivot = arr[high];
-  int i = (low - 1);
+void run_record_benchmark(void) {
+  int count = 0;
 
-  for (int j = low; j <= high - 1; j++) {
-    (*comps)++;
-    if (arr[j] < pivot) {
-      i++;
-      swap(&arr[i], &arr[j]);
-    }
+  printf("\nCantidad de registros (defecto %d): ", DEFAULT_RECORD_COUNT);
+  if (read_integer(&count) != SUCCESS || count < 2) {
+    printf("Cantidad inválida. Usando defecto (%d).\n", DEFAULT_RECORD_COUNT);
+    count = DEFAULT_RECORD_COUNT;
   }
 
-  swap(&arr[i + 1], &arr[high]);
-  return (i + 1);
+  Student *students = (Student *)malloc(count * sizeof(Student));
+  Student *student_work = (Student *)malloc(count * sizeof(Student));
+  Employee *employees = (Employee *)malloc(count * sizeof(Employee));
+  Employee *employee_work = (Employee *)malloc(count * sizeof(Employee));
+  if (students == NULL || student_work == NULL || employees == NULL ||
+      employee_work == NULL) {
+    free(students);
+    free(student_work);
+    free(employees);
+    free(employee_work);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  generate_students(students, count);
+  generate_employees(employees, count);
+
+  benchmark_record_sorts("Student por promedio", students, student_work,
+                         count, sizeof(Student), compare_student_promedio,
+                         student_key_promedio, NULL);
+  benchmark_record_sorts("Employee por salario", employees, employee_work,
+                         count, sizeof(Employee), compare_employee_salary,
+                         employee_key_salary, NULL);
+  benchmark_record_sorts("Employee por nombre", employees, employee_work,
+                         count, sizeof(Employee), compare_employee_name,
+                         employee_key_name, compare_employee_name);
+  printf("\n");
+
+  free(students);
+  free(student_work);
+  free(employees);
+  free(employee_work);
 }
 
-void show_final_comparison(int size, SortStats merge_stats,
-                           SortStats quick_stats) {
-  double n = (double)size;
-  double log_n = log2(n);
-  double ratio = (n * n) / (n * log_n);
-  double base_time =
-      (quick_stats.time_taken > 0) ? quick_stats.time_taken : 0.000001;
-  double estimated_bubble_time = base_time * ratio * 0.5;
+void benchmark_record_sorts(const char *title, const void *source, void *work,
+                            int count, size_t size, CompareFn cmp, KeyFn key,
+                            CompareFn tie_break) {
+  const char *names[] = {"Introsort genérico", "Merge Sort genérico",
+                         "Clave/índice + permutar"};
 
-  printf("\n=== Comparación con Bubble Sort (estimado) ===\n\n");
-  printf("  - Bubble Sort tomaría: ~%.4f segundos\n", estimated_bubble_time);
+  printf("\n=== %s (%d registros de %zu bytes) ===\n\n", title, count, size);
+  printf("  %-26s %-12s %s\n", "Variante", "Tiempo (s)", "Verificación");
 
-  if (quick_stats.time_taken > 0) {
-    printf("  - Quick Sort es %.0fx más rápido que Bubble Sort\n",
-           estimated_bubble_time / quick_stats.time_taken);
-  }
-  if (merge_stats.time_taken > 0) {
-    printf("  - Merge Sort es %.0fx más rápido que Bubble Sort\n",
-           estimated_bubble_time / merge_stats.time_taken);
-  }
+  for (int v = 0; v < 3; v++) {
+    memcpy(work, source, count * size);
 
-  printf("\n  - Recomendación para arrays grandes (>1000 elementos):\n");
-  printf("    + Quick Sort: más rápido en promedio\n");
-  printf("    + Merge Sort: estable y predecible\n\n");
+    double start = get_time_seconds();
+    Status status;
+    if (v == 0) {
+      status = generic_introsort(work, count, size, cmp);
+    } else if (v == 1) {
+      status = generic_merge_sort(work, count, size, cmp);
+    } else {
+      status = sort_records_by_key(work, count, size, key, tie_break);
+    }
+    double elapsed = get_time_seconds() - start;
+
+    if (status != SUCCESS) {
+      handle_error(status);
+      return;
+    }
+    printf("  %-26s %-12.4f %s\n", names[v], elapsed,
+           check_record_order(work, count, size, cmp));
+  }
+}
+
+void run_presort_benchmark(void) {
+  int size = 0;
+
+  printf("\nIngrese tamaño del array (defecto %d): ", DEFAULT_PRESORT_SIZE);
+  if (read_integer(&size) != SUCCESS || size < 2) {
+    printf("Tamaño inválido. Usando defecto (%d).\n", DEFAULT_PRESORT_SIZE);
+    size = DEFAULT_PRESORT_SIZE;
+  }
+
+  int *master_arr = (int *)malloc(size * sizeof(int));
+  int *work_arr = (int *)malloc(size * sizeof(int));
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (master_arr == NULL || work_arr == NULL || temp == NULL) {
+    free(master_arr);
+    free(work_arr);
+    free(temp);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n  %-16s %-10s %-10s %-10s %-14s %s\n", "Datos", "Merge (s)",
+         "Intro (s)", "Tim (s)", "Comps Tim", "Verificación");
+
+  for (int k = 0; k < PRESORT_COUNT; k++) {
+    SortStats merge_stats = {0, 0.0, {{0}}};
+    SortStats intro_stats = {0, 0.0, {{0}}};
+    SortStats tim_stats = {0, 0.0, {{0}}};
+    fill_presorted_array(master_arr, size, (PresortKind)k);
+
+    copy_array(master_arr, work_arr, size);
+    double start = get_time_seconds();
+    merge_sort_recursive(work_arr, 0, size - 1, temp,
+                         &merge_stats.comparisons);
+    merge_stats.time_taken = get_time_seconds() - start;
+    // Merge sort is stable, so its output is the reference
+    copy_array(work_arr, temp, size);
+
+    copy_array(master_arr, work_arr, size);
+    start = get_time_seconds();
+    introsort(work_arr, size, &intro_stats.comparisons);
+    intro_stats.time_taken = get_time_seconds() - start;
+    int ok = memcmp(work_arr, temp, size * sizeof(int)) == 0;
+
+    copy_array(master_arr, work_arr, size);
+    start = get_time_seconds();
+    Status status = tim_sort(work_arr, size, &tim_stats.comparisons);
+    tim_stats.time_taken = get_time_seconds() - start;
+    if (status != SUCCESS) {
+      handle_error(status);
+      break;
+    }
+    ok = ok && memcmp(work_arr, temp, size * sizeof(int)) == 0;
+
+    printf("  %-16s %-10.4f %-10.4f %-10.4f %-14llu %s\n",
+           presort_name((PresortKind)k), merge_stats.time_taken,
+           intro_stats.time_taken, tim_stats.time_taken,
+           tim_stats.comparisons, ok ? "OK" : "ERROR");
+  }
+  printf("\n");
+
+  free(master_arr);
+  free(work_arr);
+  free(temp);
+}
+
+void run_full_benchmark(void) {
+  BenchConfig config = {BENCH_MAX_SIZE, BENCH_WARMUPS, BENCH_REPETITIONS,
+                        default_thread_count(), FORMAT_CSV};
+  char path[MAX_PATH_LEN];
+  int choice = 0;
+  int failures = 0;
+
+  printf("\nFormato de salida (1 = CSV, 2 = JSON): ");
+  if (read_integer(&choice) == SUCCESS && choice == 2) {
+    config.format = FORMAT_JSON;
+  }
+  printf("Tamaño máximo (defecto %d): ", BENCH_MAX_SIZE);
+  if (read_integer(&config.max_size) != SUCCESS ||
+      config.max_size < BENCH_MIN_SIZE) {
+    config.max_size = BENCH_MAX_SIZE;
+  }
+  read_path("Archivo de salida",
+            config.format == FORMAT_JSON ? DEFAULT_BENCH_JSON
+                                         : DEFAULT_BENCH_CSV,
+            path);
+
+  FILE *out = fopen(path, "w");
+  if (out == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+
+  double start = get_time_seconds();
+  Status status = run_benchmark_suite(out, &config, &failures);
+  fclose(out);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\nResultados en '%s' (%.2f segundos)\n", path,
+         get_time_seconds() - start);
+  printf("Verificación: %s\n\n",
+         failures == 0 ? "OK" : "ERROR (ver columna verified)");
+}
+
+void clear_input_buffer(void) {
+  int c;
+  while ((c = getchar()) != '\n' && c != EOF) {
+    ;
+  }
+}
+
+Status read_integer(int *value) {
+  if (scanf("%d", value) != 1) {
+    clear_input_buffer();
+    return ERR_INVALID_INPUT;
+  }
+  clear_input_buffer();
+  return SUCCESS;
+}
+
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  } else if (len == (size_t)(max_len - 1)) {
+    clear_input_buffer();
+  }
+  return SUCCESS;
+}
+
+void read_path(const char *prompt, const char *fallback, char *path) {
+  printf("%s (defecto %s): ", prompt, fallback);
+  if (read_string(path, MAX_PATH_LEN) != SUCCESS || path[0] == '\0') {
+    strcpy(path, fallback);
+  }
+}
+
+Status generate_random_array(int **arr, int size) {
+  *arr = (int *)malloc(size * sizeof(int));
+  if (*arr == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < size; i++) {
+    (*arr)[i] = rand() % 10000;
+  }
+  return SUCCESS;
+}
+
+void run_merge_sort(int *arr, int size, SortStats *stats) {
+  printf("Ejecutando...\n");
+
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (temp == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  perf_counters_start();
+  double start = get_time_seconds();
+  merge_sort_recursive(arr, 0, size - 1, temp, &stats->comparisons);
+  stats->time_taken = get_time_seconds() - start;
+  perf_counters_stop(&stats->hw);
+  free(temp);
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  printf("  - Comparaciones: %llu\n", stats->comparisons);
+  printf("  - Complejidad:   O(n log n)\n");
+  printf("  - Memoria extra: O(n)\n");
+  print_hw_counters(&stats->hw);
+}
+
+void merge_sort_recursive(int *arr, int l, int r, int *temp,
+                          unsigned long long *comps) {
+  if (l < r) {
+    int m = l + (r - l) / 2;
+    merge_sort_recursive(arr, l, m, temp, comps);
+    merge_sort_recursive(arr, m + 1, r, temp, comps);
+    merge(arr, l, m, r, temp, comps);
+  }
+}
+
+void merge(int *arr, int l, int m, int r, int *temp,
+           unsigned long long *comps) {
+  int i = l;
+  int j = m + 1;
+  int k = l;
+
+  while (i <= m && j <= r) {
+    (*comps)++;
+    if (arr[i] <= arr[j]) {
+      temp[k++] = arr[i++];
+    } else {
+      temp[k++] = arr[j++];
+    }
+  }
+
+  while (i <= m) {
+    temp[k++] = arr[i++];
+  }
+  while (j <= r) {
+    temp[k++] = arr[j++];
+  }
+
+  for (i = l; i <= r; i++) {
+    arr[i] = temp[i];
+  }
+}
+
+Status task_pool_init(TaskPool *pool, int num_threads) {
+  pool->num_threads = 0;
+  pool->stack = NULL;
+  pool->outstanding = 0;
+  pool->shutdown = FALSE;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_ready, NULL);
+  pthread_cond_init(&pool->all_done, NULL);
+
+  for (int t = 0; t < num_threads; t++) {
+    if (pthread_create(&pool->threads[t], NULL, task_pool_worker, pool) != 0) {
+      task_pool_destroy(pool);
+      return ERR_THREAD_CREATION;
+    }
+    pool->num_threads++;
+  }
+  return SUCCESS;
+}
+
+void task_pool_submit(TaskPool *pool, Task *task) {
+  pthread_mutex_lock(&pool->lock);
+  task->next = pool->stack;
+  pool->stack = task;
+  pool->outstanding++;
+  pthread_cond_signal(&pool->work_ready);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void task_pool_wait(TaskPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  while (pool->outstanding > 0) {
+    pthread_cond_wait(&pool->all_done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void task_pool_destroy(TaskPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = TRUE;
+  pthread_cond_broadcast(&pool->work_ready);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int t = 0; t < pool->num_threads; t++) {
+    pthread_join(pool->threads[t], NULL);
+  }
+  pthread_cond_destroy(&pool->all_done);
+  pthread_cond_destroy(&pool->work_ready);
+  pthread_mutex_destroy(&pool->lock);
+}
+
+// A task counts as outstanding until run() returns, including the
+// children it submits, so wait() cannot wake between parent and child.
+void *task_pool_worker(void *arg) {
+  TaskPool *pool = (TaskPool *)arg;
+
+  pthread_mutex_lock(&pool->lock);
+  while (TRUE) {
+    while (pool->stack == NULL && !pool->shutdown) {
+      pthread_cond_wait(&pool->work_ready, &pool->lock);
+    }
+    if (pool->stack == NULL) {
+      break;
+    }
+
+    Task *task = pool->stack;
+    pool->stack = task->next;
+    pthread_mutex_unlock(&pool->lock);
+
+    task->run(pool, task);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->outstanding == 0) {
+      pthread_cond_broadcast(&pool->all_done);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+Status parallel_merge_sort(int *arr, int *temp, int size, int num_threads) {
+  ParallelSortJob job;
+  job.arr = arr;
+  job.temp = temp;
+  // Below size / threads there are already enough concurrent merges
+  job.merge_split = num_threads > 1 ? size / num_threads : size + 1;
+  job.merge_pieces = num_threads;
+
+  SortTask *root = new_sort_task(&job, NULL, 0, size, FALSE);
+  if (root == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  TaskPool pool;
+  Status status = task_pool_init(&pool, num_threads);
+  if (status != SUCCESS) {
+    free(root);
+    return status;
+  }
+
+  task_pool_submit(&pool, &root->base);
+  task_pool_wait(&pool);
+  task_pool_destroy(&pool);
+
+  return SUCCESS;
+}
+
+SortTask *new_sort_task(ParallelSortJob *job, SortTask *parent, int low,
+                        int high, int to_temp) {
+  SortTask *st = (SortTask *)malloc(sizeof(SortTask));
+  if (st == NULL) {
+    return NULL;
+  }
+  st->base.run = sort_task_run;
+  st->base.next = NULL;
+  st->job = job;
+  st->parent = parent;
+  st->low = low;
+  st->high = high;
+  st->to_temp = to_temp;
+  st->pending = 0;
+  st->split = FALSE;
+  st->chunks = NULL;
+  return st;
+}
+
+/*
+ * First run splits the range into two child tasks; the last child to
+ * finish resubmits the parent, whose second run merges the halves.
+ */
+void sort_task_run(TaskPool *pool, Task *task) {
+  SortTask *st = (SortTask *)task;
+  ParallelSortJob *job = st->job;
+  int n = st->high - st->low;
+
+  if (!st->split) {
+    int mid = st->low + n / 2;
+    SortTask *left = NULL;
+    SortTask *right = NULL;
+
+    if (n > PARALLEL_CUTOFF) {
+      left = new_sort_task(job, st, st->low, mid, !st->to_temp);
+      right = new_sort_task(job, st, mid, st->high, !st->to_temp);
+    }
+    if (left == NULL || right == NULL) {
+      // Small range, or out of memory: finish this subtree serially
+      free(left);
+      free(right);
+      merge_sort_pingpong(job->arr, job->temp, st->low, st->high,
+                          st->to_temp);
+      sort_task_finish(pool, st);
+      return;
+    }
+
+    st->split = TRUE;
+    st->pending = 2;
+    task_pool_submit(pool, &left->base);
+    task_pool_submit(pool, &right->base);
+    return;
+  }
+
+  const int *src = st->to_temp ? job->arr : job->temp;
+  int *dst = st->to_temp ? job->temp : job->arr;
+  int mid = st->low + n / 2;
+  int pieces = n / PARALLEL_MERGE_MIN;
+  if (pieces > job->merge_pieces) {
+    pieces = job->merge_pieces;
+  }
+
+  if (n < job->merge_split || pieces < 2) {
+    merge_kernel(src + st->low, mid - st->low, src + mid, st->high - mid,
+                 dst + st->low);
+    sort_task_finish(pool, st);
+    return;
+  }
+
+  // Top levels: cut the output into equal slices along the merge path
+  MergeChunkTask *chunks =
+      (MergeChunkTask *)malloc(pieces * sizeof(MergeChunkTask));
+  if (chunks == NULL) {
+    merge_kernel(src + st->low, mid - st->low, src + mid, st->high - mid,
+                 dst + st->low);
+    sort_task_finish(pool, st);
+    return;
+  }
+
+  const int *a = src + st->low;
+  const int *b = src + mid;
+  int na = mid - st->low;
+  int nb = st->high - mid;
+  int prev_i = 0;
+
+  st->chunks = chunks;
+  st->pending = pieces;
+  for (int p = 0; p < pieces; p++) {
+    int k_end = (int)((long long)n * (p + 1) / pieces);
+    int i_end = p == pieces - 1 ? na : merge_co_rank(a, na, b, nb, k_end);
+    int k_begin = (int)((long long)n * p / pieces);
+
+    chunks[p].base.run = merge_chunk_run;
+    chunks[p].owner = st;
+    chunks[p].src = src;
+    chunks[p].dst = dst;
+    chunks[p].a_low = st->low + prev_i;
+    chunks[p].a_high = st->low + i_end;
+    chunks[p].b_low = mid + (k_begin - prev_i);
+    chunks[p].b_high = mid + (k_end - i_end);
+    chunks[p].out = st->low + k_begin;
+    prev_i = i_end;
+  }
+  for (int p = 0; p < pieces; p++) {
+    task_pool_submit(pool, &chunks[p].base);
+  }
+}
+
+void sort_task_finish(TaskPool *pool, SortTask *st) {
+  SortTask *parent = st->parent;
+  free(st->chunks);
+  free(st);
+
+  if (parent != NULL &&
+      __atomic_sub_fetch(&parent->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+    task_pool_submit(pool, &parent->base);
+  }
+}
+
+void merge_chunk_run(TaskPool *pool, Task *task) {
+  MergeChunkTask *chunk = (MergeChunkTask *)task;
+  SortTask *owner = chunk->owner;
+
+  merge_kernel(chunk->src + chunk->a_low, chunk->a_high - chunk->a_low,
+               chunk->src + chunk->b_low, chunk->b_high - chunk->b_low,
+               chunk->dst + chunk->out);
+
+  if (__atomic_sub_fetch(&owner->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+    sort_task_finish(pool, owner);
+  }
+}
+
+// Sorts [low, high) of arr; the result lands in temp when to_temp is set
+void merge_sort_pingpong(int *arr, int *temp, int low, int high,
+                         int to_temp) {
+  if (high - low <= SORT_KERNEL_MAX) {
+    small_sort_kernel(arr + low, high - low);
+    if (to_temp) {
+      memcpy(temp + low, arr + low, (size_t)(high - low) * sizeof(int));
+    }
+    return;
+  }
+
+  int mid = low + (high - low) / 2;
+  merge_sort_pingpong(arr, temp, low, mid, !to_temp);
+  merge_sort_pingpong(arr, temp, mid, high, !to_temp);
+
+  const int *src = to_temp ? arr : temp;
+  int *dst = to_temp ? temp : arr;
+  merge_kernel(src + low, mid - low, src + mid, high - mid, dst + low);
+}
+
+void merge_runs_scalar(const int *a, int na, const int *b, int nb, int *out) {
+  int i = 0;
+  int j = 0;
+  int k = 0;
+
+  while (i < na && j < nb) {
+    if (a[i] <= b[j]) {
+      out[k++] = a[i++];
+    } else {
+      out[k++] = b[j++];
+    }
+  }
+  while (i < na) {
+    out[k++] = a[i++];
+  }
+  while (j < nb) {
+    out[k++] = b[j++];
+  }
+}
+
+/*
+ * Number of elements of a among the first k outputs of the stable
+ * merge of a and b (ties go to a).
+ */
+int merge_co_rank(const int *a, int na, const int *b, int nb, int k) {
+  int low = k > nb ? k - nb : 0;
+  int high = k < na ? k : na;
+
+  while (low < high) {
+    int i = low + (high - low) / 2;
+    if (a[i] <= b[k - i - 1]) {
+      low = i + 1;
+    } else {
+      high = i;
+    }
+  }
+  return low;
+}
+
+void sort_small_scalar(int *arr, int n) {
+  for (int i = 1; i < n; i++) {
+    int key = arr[i];
+    int j = i - 1;
+
+    while (j >= 0 && arr[j] > key) {
+      arr[j + 1] = arr[j];
+      j--;
+    }
+    arr[j + 1] = key;
+  }
+}
+
+#ifdef HAVE_X86_SIMD
+/*
+ * Compare-exchange of every lane with its partner lane: mask bit i set
+ * means lane i keeps the max of the pair, otherwise the min.
+ */
+#define BITONIC_STEP(v, partner, mask)                                         \
+  _mm256_blend_epi32(_mm256_min_epi32((v), (partner)),                         \
+                     _mm256_max_epi32((v), (partner)), (mask))
+
+// Sorts a bitonic register ascending: lane distances 4, 2, 1
+__attribute__((target("avx2"))) __m256i
+bitonic_clean_8(__m256i v) {
+  v = BITONIC_STEP(v, _mm256_permute2x128_si256(v, v, 0x01), 0xF0);
+  v = BITONIC_STEP(v, _mm256_shuffle_epi32(v, 0x4E), 0xCC);
+  v = BITONIC_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0xAA);
+  return v;
+}
+
+// Full in-register bitonic sort of 8 lanes (6 compare-exchange stages)
+__attribute__((target("avx2"))) __m256i
+bitonic_sort_8(__m256i v) {
+  v = BITONIC_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0x66);
+  v = BITONIC_STEP(v, _mm256_shuffle_epi32(v, 0x4E), 0x3C);
+  v = BITONIC_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0x5A);
+  return bitonic_clean_8(v);
+}
+
+__attribute__((target("avx2"))) __m256i reverse_8(__m256i v) {
+  return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2,
+                                                          1, 0));
+}
+
+// Two sorted registers in, the low 8 in *a and the high 8 in *b out
+__attribute__((target("avx2"))) void
+bitonic_merge_8x8(__m256i *a, __m256i *b) {
+  __m256i r = reverse_8(*b);
+  __m256i lo = _mm256_min_epi32(*a, r);
+  __m256i hi = _mm256_max_epi32(*a, r);
+  *a = bitonic_clean_8(lo);
+  *b = bitonic_clean_8(hi);
+}
+
+// Sorts a bitonic 16-lane sequence held in (*a, *b)
+__attribute__((target("avx2"))) void
+bitonic_clean_16(__m256i *a, __m256i *b) {
+  __m256i lo = _mm256_min_epi32(*a, *b);
+  __m256i hi = _mm256_max_epi32(*a, *b);
+  *a = bitonic_clean_8(lo);
+  *b = bitonic_clean_8(hi);
+}
+
+/*
+ * Pads the input with INT_MAX up to 8, 16 or 32 lanes so a fixed
+ * network always runs: sort each register, then bitonic-merge pairs.
+ */
+__attribute__((target("avx2"))) void sort_small_avx2(int *arr, int n) {
+  int buf[SORT_KERNEL_MAX] __attribute__((aligned(32)));
+  int lanes = n <= 8 ? 8 : (n <= 16 ? 16 : 32);
+
+  if (n < 2) {
+    return;
+  }
+  memcpy(buf, arr, n * sizeof(int));
+  for (int i = n; i < lanes; i++) {
+    buf[i] = 0x7fffffff;
+  }
+
+  __m256i v0 = bitonic_sort_8(_mm256_load_si256((const __m256i *)buf));
+  if (lanes == 8) {
+    _mm256_store_si256((__m256i *)buf, v0);
+    memcpy(arr, buf, n * sizeof(int));
+    return;
+  }
+
+  __m256i v1 = bitonic_sort_8(_mm256_load_si256((const __m256i *)buf + 1));
+  bitonic_merge_8x8(&v0, &v1);
+  if (lanes == 32) {
+    __m256i v2 = bitonic_sort_8(_mm256_load_si256((const __m256i *)buf + 2));
+    __m256i v3 = bitonic_sort_8(_mm256_load_si256((const __m256i *)buf + 3));
+    bitonic_merge_8x8(&v2, &v3);
+
+    // Reversing the second run makes the 32 lanes bitonic
+    __m256i r2 = reverse_8(v3);
+    __m256i r3 = reverse_8(v2);
+    __m256i lo0 = _mm256_min_epi32(v0, r2);
+    __m256i lo1 = _mm256_min_epi32(v1, r3);
+    __m256i hi0 = _mm256_max_epi32(v0, r2);
+    __m256i hi1 = _mm256_max_epi32(v1, r3);
+    bitonic_clean_16(&lo0, &lo1);
+    bitonic_clean_16(&hi0, &hi1);
+    _mm256_store_si256((__m256i *)buf + 2, hi0);
+    _mm256_store_si256((__m256i *)buf + 3, hi1);
+    v0 = lo0;
+    v1 = lo1;
+  }
+  _mm256_store_si256((__m256i *)buf, v0);
+  _mm256_store_si256((__m256i *)buf + 1, v1);
+  memcpy(arr, buf, n * sizeof(int));
+}
+
+/*
+ * Keeps the 8 largest seen so far in a register: each step merges it
+ * with the next 8 from whichever run has the smaller head, emits the
+ * low half and carries the high half. The tails finish in scalar code.
+ */
+__attribute__((target("avx2"))) void
+merge_runs_avx2(const int *a, int na, const int *b, int nb, int *out) {
+  if (na < SIMD_WIDTH || nb < SIMD_WIDTH) {
+    merge_runs_scalar(a, na, b, nb, out);
+    return;
+  }
+
+  __m256i lo = _mm256_loadu_si256((const __m256i *)a);
+  __m256i hi = _mm256_loadu_si256((const __m256i *)b);
+  int i = SIMD_WIDTH;
+  int j = SIMD_WIDTH;
+  int k = 0;
+
+  while (TRUE) {
+    bitonic_merge_8x8(&lo, &hi);
+    _mm256_storeu_si256((__m256i *)(out + k), lo);
+    k += SIMD_WIDTH;
+
+    // Only the run with the smaller head may refill, or order breaks
+    int take_a = j >= nb || (i < na && a[i] <= b[j]);
+    if (take_a && i + SIMD_WIDTH <= na) {
+      lo = _mm256_loadu_si256((const __m256i *)(a + i));
+      i += SIMD_WIDTH;
+    } else if (!take_a && j + SIMD_WIDTH <= nb) {
+      lo = _mm256_loadu_si256((const __m256i *)(b + j));
+      j += SIMD_WIDTH;
+    } else {
+      break;
+    }
+  }
+
+  // Three-way scalar merge of the carried register and both tails
+  int carry[SIMD_WIDTH];
+  int c = 0;
+  _mm256_storeu_si256((__m256i *)carry, hi);
+  while (c < SIMD_WIDTH || i < na || j < nb) {
+    int best = 0;
+    int value = 0x7fffffff;
+    if (c < SIMD_WIDTH) {
+      value = carry[c];
+      best = 1;
+    }
+    if (i < na && (best == 0 || a[i] < value)) {
+      value = a[i];
+      best = 2;
+    }
+    if (j < nb && (best == 0 || b[j] < value)) {
+      value = b[j];
+      best = 3;
+    }
+    out[k++] = value;
+    if (best == 1) {
+      c++;
+    } else if (best == 2) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+}
+#endif
+
+void select_simd_kernels(void) {
+  small_sort_kernel = sort_small_scalar;
+  merge_kernel = merge_runs_scalar;
+  simd_kernel_name = "escalar";
+
+#ifdef HAVE_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    small_sort_kernel = sort_small_avx2;
+    merge_kernel = merge_runs_avx2;
+    simd_kernel_name = "AVX2";
+  }
+#endif
+}
+
+/*
+ * Phase 1 cuts the input into memory-sized runs sorted with the
+ * parallel merge sort. Phase 2 merges up to EXTERNAL_MAX_FANIN runs at
+ * a time, adding passes only when there are more runs than that.
+ */
+Status external_sort(const char *input, const char *output,
+                     size_t memory_bytes, int num_threads,
+                     ExternalStats *stats) {
+  char path[MAX_PATH_LEN];
+  size_t chunk = memory_bytes / (2 * sizeof(int));
+  if (chunk > 0x7fffffff) {
+    chunk = 0x7fffffff;
+  }
+  if (chunk < MIN_RUN_BUFFER) {
+    chunk = MIN_RUN_BUFFER;
+  }
+
+  stats->elements = 0;
+  stats->checksum = 0;
+  stats->runs = 0;
+  stats->merge_passes = 0;
+  stats->run_time = 0.0;
+  stats->merge_time = 0.0;
+
+  FILE *in = fopen(input, "rb");
+  if (in == NULL) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  int *arr = (int *)malloc(chunk * sizeof(int));
+  int *temp = (int *)malloc(chunk * sizeof(int));
+  if (arr == NULL || temp == NULL) {
+    free(arr);
+    free(temp);
+    fclose(in);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  double start = get_time_seconds();
+  Status status = SUCCESS;
+  while (status == SUCCESS) {
+    size_t n = fread(arr, sizeof(int), chunk, in);
+    if (n == 0) {
+      status = ferror(in) ? ERR_FILE_IO : SUCCESS;
+      break;
+    }
+    stats->elements += n;
+    stats->checksum += array_checksum(arr, (int)n);
+
+    status = parallel_merge_sort(arr, temp, (int)n, num_threads);
+    if (status != SUCCESS) {
+      break;
+    }
+
+    run_file_path(path, output, 0, stats->runs);
+    FILE *run = fopen(path, "wb");
+    if (run == NULL) {
+      status = ERR_FILE_IO;
+      break;
+    }
+    status = write_ints(run, arr, n);
+    if (fclose(run) != 0 && status == SUCCESS) {
+      status = ERR_FILE_IO;
+    }
+    stats->runs++;
+  }
+  fclose(in);
+  free(arr);
+  free(temp);
+  stats->run_time = get_time_seconds() - start;
+
+  start = get_time_seconds();
+  int pass = 0;
+  int count = stats->runs;
+  while (status == SUCCESS && count > EXTERNAL_MAX_FANIN) {
+    int next = 0;
+    for (int first = 0; first < count && status == SUCCESS;
+         first += EXTERNAL_MAX_FANIN) {
+      int group = count - first < EXTERNAL_MAX_FANIN ? count - first
+                                                      : EXTERNAL_MAX_FANIN;
+      run_file_path(path, output, pass + 1, next++);
+      status = merge_run_files(output, pass, first, group, path, memory_bytes);
+    }
+    pass++;
+    count = next;
+    stats->merge_passes++;
+  }
+
+  if (status == SUCCESS) {
+    if (count == 0) {
+      FILE *empty = fopen(output, "wb");
+      status = (empty != NULL && fclose(empty) == 0) ? SUCCESS : ERR_FILE_IO;
+    } else if (count == 1) {
+      run_file_path(path, output, pass, 0);
+      status = rename(path, output) == 0 ? SUCCESS : ERR_FILE_IO;
+    } else {
+      status = merge_run_files(output, pass, 0, count, output, memory_bytes);
+      stats->merge_passes++;
+    }
+  }
+  stats->merge_time = get_time_seconds() - start;
+
+  if (status != SUCCESS) {
+    // Best effort: leave no stray runs behind
+    for (int i = 0; i < stats->runs; i++) {
+      run_file_path(path, output, pass, i);
+      remove(path);
+    }
+  }
+  return status;
+}
+
+// Merges runs [first, first + count) of a pass into dest, then drops them
+Status merge_run_files(const char *base, int pass, int first, int count,
+                       const char *dest, size_t memory_bytes) {
+  char path[MAX_PATH_LEN];
+  size_t per_buffer = memory_bytes / sizeof(int) / (count + 1);
+  int capacity = per_buffer < MIN_RUN_BUFFER ? MIN_RUN_BUFFER
+                 : per_buffer > 0x7fffffff   ? 0x7fffffff
+                                             : (int)per_buffer;
+
+  RunReader *runs = (RunReader *)calloc(count, sizeof(RunReader));
+  int *out = (int *)malloc((size_t)capacity * sizeof(int));
+  if (runs == NULL || out == NULL) {
+    free(runs);
+    free(out);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  Status status = SUCCESS;
+  int opened = 0;
+  for (; opened < count && status == SUCCESS; opened++) {
+    run_file_path(path, base, pass, first + opened);
+    status = run_reader_open(&runs[opened], path, capacity);
+  }
+
+  LoserTree tree;
+  tree.nodes = NULL;
+  FILE *file = NULL;
+  if (status == SUCCESS) {
+    status = loser_tree_init(&tree, runs, count);
+  }
+  if (status == SUCCESS) {
+    file = fopen(dest, "wb");
+    status = file != NULL ? SUCCESS : ERR_FILE_IO;
+  }
+
+  int filled = 0;
+  while (status == SUCCESS && !runs[tree.nodes[0]].done) {
+    int winner = tree.nodes[0];
+    out[filled++] = runs[winner].head;
+    if (filled == capacity) {
+      status = write_ints(file, out, filled);
+      filled = 0;
+    }
+    run_reader_next(&runs[winner]);
+    loser_tree_adjust(&tree, winner);
+  }
+  if (status == SUCCESS) {
+    status = write_ints(file, out, filled);
+  }
+  for (int r = 0; r < count; r++) {
+    if (runs[r].file != NULL && ferror(runs[r].file)) {
+      status = ERR_FILE_IO;
+    }
+  }
+  if (file != NULL && fclose(file) != 0 && status == SUCCESS) {
+    status = ERR_FILE_IO;
+  }
+
+  for (int r = 0; r < opened; r++) {
+    run_reader_close(&runs[r]);
+    run_file_path(path, base, pass, first + r);
+    remove(path);
+  }
+  free(tree.nodes);
+  free(runs);
+  free(out);
+  return status;
+}
+
+void run_file_path(char *path, const char *base, int pass, int index) {
+  snprintf(path, MAX_PATH_LEN, "%s.run%d_%d", base, pass, index);
+}
+
+Status write_ints(FILE *file, const int *values, size_t count) {
+  if (fwrite(values, sizeof(int), count, file) != count) {
+    return ERR_FILE_IO;
+  }
+  return SUCCESS;
+}
+
+Status run_reader_open(RunReader *reader, const char *path, int capacity) {
+  reader->file = fopen(path, "rb");
+  reader->buffer = NULL;
+  if (reader->file == NULL) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  reader->buffer = (int *)malloc((size_t)capacity * sizeof(int));
+  if (reader->buffer == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  reader->capacity = capacity;
+  reader->count = 0;
+  reader->pos = 0;
+  reader->done = FALSE;
+  run_reader_next(reader);
+  return SUCCESS;
+}
+
+void run_reader_next(RunReader *reader) {
+  if (reader->pos == reader->count) {
+    reader->count = (int)fread(reader->buffer, sizeof(int), reader->capacity,
+                               reader->file);
+    reader->pos = 0;
+    if (reader->count == 0) {
+      reader->done = TRUE;
+      return;
+    }
+  }
+  reader->head = reader->buffer[reader->pos++];
+}
+
+void run_reader_close(RunReader *reader) {
+  if (reader->file != NULL) {
+    fclose(reader->file);
+  }
+  free(reader->buffer);
+  reader->file = NULL;
+  reader->buffer = NULL;
+}
+
+/*
+ * Every node starts as the virtual leaf -1, which beats everything;
+ * adjusting the real leaves from last to first pushes it out.
+ */
+Status loser_tree_init(LoserTree *tree, RunReader *runs, int k) {
+  tree->k = k;
+  tree->runs = runs;
+  tree->nodes = (int *)malloc(k * sizeof(int));
+  if (tree->nodes == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  for (int i = 0; i < k; i++) {
+    tree->nodes[i] = -1;
+  }
+  for (int leaf = k - 1; leaf >= 0; leaf--) {
+    loser_tree_adjust(tree, leaf);
+  }
+  return SUCCESS;
+}
+
+// Replays the matches from leaf to root after its head changed
+void loser_tree_adjust(LoserTree *tree, int leaf) {
+  int winner = leaf;
+
+  for (int t = (leaf + tree->k) / 2; t > 0; t /= 2) {
+    if (loser_tree_beats(tree, tree->nodes[t], winner)) {
+      int loser = winner;
+      winner = tree->nodes[t];
+      tree->nodes[t] = loser;
+    }
+  }
+  tree->nodes[0] = winner;
+}
+
+// Exhausted runs lose to everything; ties go to the lower run index
+int loser_tree_beats(const LoserTree *tree, int a, int b) {
+  if (a == -1) {
+    return TRUE;
+  }
+  if (b == -1) {
+    return FALSE;
+  }
+  const RunReader *ra = &tree->runs[a];
+  const RunReader *rb = &tree->runs[b];
+  if (ra->done) {
+    return FALSE;
+  }
+  if (rb->done) {
+    return TRUE;
+  }
+  return ra->head < rb->head || (ra->head == rb->head && a < b);
+}
+
+Status verify_sorted_file(const char *path, long long *count,
+                          long long *checksum, int *sorted) {
+  RunReader reader;
+  Status status = run_reader_open(&reader, path, GENERATE_BLOCK);
+  if (status != SUCCESS) {
+    run_reader_close(&reader);
+    return status;
+  }
+
+  *count = 0;
+  *checksum = 0;
+  *sorted = TRUE;
+  int prev = 0;
+  while (!reader.done) {
+    if (*count > 0 && reader.head < prev) {
+      *sorted = FALSE;
+    }
+    prev = reader.head;
+    *checksum += reader.head;
+    (*count)++;
+    run_reader_next(&reader);
+  }
+  if (ferror(reader.file)) {
+    status = ERR_FILE_IO;
+  }
+  run_reader_close(&reader);
+  return status;
+}
+
+// Stable: ping-pongs whole records between base and one scratch copy
+Status generic_merge_sort(void *base, int count, size_t size, CompareFn cmp) {
+  if (count < 2) {
+    return SUCCESS;
+  }
+  char *temp = (char *)malloc(count * size);
+  if (temp == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  generic_merge_pingpong((char *)base, temp, 0, count, FALSE, size, cmp);
+  free(temp);
+  return SUCCESS;
+}
+
+void generic_merge_pingpong(char *arr, char *temp, int low, int high,
+                            int to_temp, size_t size, CompareFn cmp) {
+  if (high - low == 1) {
+    if (to_temp) {
+      memcpy(temp + low * size, arr + low * size, size);
+    }
+    return;
+  }
+
+  int mid = low + (high - low) / 2;
+  generic_merge_pingpong(arr, temp, low, mid, !to_temp, size, cmp);
+  generic_merge_pingpong(arr, temp, mid, high, !to_temp, size, cmp);
+
+  const char *src = to_temp ? arr : temp;
+  char *dst = to_temp ? temp : arr;
+  int i = low;
+  int j = mid;
+  int k = low;
+  while (i < mid && j < high) {
+    if (cmp(src + j * size, src + i * size) < 0) {
+      memcpy(dst + k++ * size, src + j++ * size, size);
+    } else {
+      memcpy(dst + k++ * size, src + i++ * size, size);
+    }
+  }
+  memcpy(dst + k * size, src + i * size, (mid - i) * size);
+  k += mid - i;
+  memcpy(dst + k * size, src + j * size, (high - j) * size);
+}
+
+// Unstable, in place; scratch holds the pivot and the insertion key
+Status generic_introsort(void *base, int count, size_t size, CompareFn cmp) {
+  if (count < 2) {
+    return SUCCESS;
+  }
+  char *scratch = (char *)malloc(2 * size);
+  if (scratch == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  int depth_limit = 0;
+  for (int n = count; n > 1; n >>= 1) {
+    depth_limit += 2;
+  }
+  generic_introsort_loop((char *)base, 0, count - 1, depth_limit, size, cmp,
+                         scratch);
+  free(scratch);
+  return SUCCESS;
+}
+
+void generic_introsort_loop(char *arr, int low, int high, int depth_limit,
+                            size_t size, CompareFn cmp, char *scratch) {
+  while (high - low + 1 > INSERTION_THRESHOLD) {
+    if (depth_limit == 0) {
+      generic_heap_sort(arr, low, high, size, cmp);
+      return;
+    }
+    depth_limit--;
+
+    // Median of three moved to low, then copied out as the pivot
+    int mid = low + (high - low) / 2;
+    char *a = arr + low * size;
+    char *b = arr + mid * size;
+    char *c = arr + high * size;
+    char *median = cmp(a, b) < 0
+                       ? (cmp(b, c) < 0 ? b : (cmp(a, c) < 0 ? c : a))
+                       : (cmp(a, c) < 0 ? a : (cmp(b, c) < 0 ? c : b));
+    generic_swap(a, median, size);
+    memcpy(scratch, a, size);
+
+    int i = low - 1;
+    int j = high + 1;
+    while (TRUE) {
+      do {
+        j--;
+      } while (cmp(arr + j * size, scratch) > 0);
+      do {
+        i++;
+      } while (cmp(arr + i * size, scratch) < 0);
+      if (i >= j) {
+        break;
+      }
+      generic_swap(arr + i * size, arr + j * size, size);
+    }
+
+    if (j - low < high - j) {
+      generic_introsort_loop(arr, low, j, depth_limit, size, cmp, scratch);
+      low = j + 1;
+    } else {
+      generic_introsort_loop(arr, j + 1, high, depth_limit, size, cmp,
+                             scratch);
+      high = j;
+    }
+  }
+
+  generic_insertion_sort(arr, low, high, size, cmp, scratch + size);
+}
+
+void generic_insertion_sort(char *arr, int low, int high, size_t size,
+                            CompareFn cmp, char *scratch) {
+  for (int i = low + 1; i <= high; i++) {
+    int j = i - 1;
+    if (cmp(arr + j * size, arr + i * size) <= 0) {
+      continue;
+    }
+
+    memcpy(scratch, arr + i * size, size);
+    while (j >= low && cmp(arr + j * size, scratch) > 0) {
+      j--;
+    }
+    memmove(arr + (j + 2) * size, arr + (j + 1) * size, (i - j - 1) * size);
+    memcpy(arr + (j + 1) * size, scratch, size);
+  }
+}
+
+void generic_heap_sort(char *arr, int low, int high, size_t size,
+                       CompareFn cmp) {
+  char *base = arr + low * size;
+  int count = high - low + 1;
+
+  for (int root = count / 2 - 1; root >= 0; root--) {
+    generic_sift_down(base, root, count, size, cmp);
+  }
+  for (int end = count - 1; end > 0; end--) {
+    generic_swap(base, base + end * size, size);
+    generic_sift_down(base, 0, end, size, cmp);
+  }
+}
+
+void generic_sift_down(char *arr, int root, int count, size_t size,
+                       CompareFn cmp) {
+  while (2 * root + 1 < count) {
+    int child = 2 * root + 1;
+    if (child + 1 < count &&
+        cmp(arr + (child + 1) * size, arr + child * size) > 0) {
+      child++;
+    }
+    if (cmp(arr + child * size, arr + root * size) <= 0) {
+      return;
+    }
+    generic_swap(arr + root * size, arr + child * size, size);
+    root = child;
+  }
+}
+
+void generic_swap(void *a, void *b, size_t size) {
+  unsigned char buffer[SWAP_CHUNK];
+  unsigned char *pa = (unsigned char *)a;
+  unsigned char *pb = (unsigned char *)b;
+
+  while (size > 0) {
+    size_t n = size < SWAP_CHUNK ? size : SWAP_CHUNK;
+    memcpy(buffer, pa, n);
+    memcpy(pa, pb, n);
+    memcpy(pb, buffer, n);
+    pa += n;
+    pb += n;
+    size -= n;
+  }
+}
+
+/*
+ * Sorts 16-byte (key, index) pairs instead of the records, then moves
+ * every record exactly once along the permutation cycles. Keys only
+ * have to agree with the field order; when they are a lossy prefix
+ * (strings), tie_break settles the runs of equal keys.
+ */
+Status sort_records_by_key(void *base, int count, size_t size, KeyFn key,
+                           CompareFn tie_break) {
+  if (count < 2) {
+    return SUCCESS;
+  }
+
+  KeyIndex *pairs = (KeyIndex *)malloc(count * sizeof(KeyIndex));
+  KeyIndex *temp = (KeyIndex *)malloc(count * sizeof(KeyIndex));
+  char *scratch = (char *)malloc(size);
+  if (pairs == NULL || temp == NULL || scratch == NULL) {
+    free(pairs);
+    free(temp);
+    free(scratch);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  const char *records = (const char *)base;
+  for (int i = 0; i < count; i++) {
+    pairs[i].key = key(records + i * size);
+    pairs[i].index = i;
+  }
+  radix_sort_pairs(pairs, temp, count);
+
+  if (tie_break != NULL) {
+    for (int i = 0; i < count;) {
+      int j = i + 1;
+      while (j < count && pairs[j].key == pairs[i].key) {
+        j++;
+      }
+      if (j - i > 1) {
+        sort_tied_indices(pairs + i, temp, j - i, records, size, tie_break);
+      }
+      i = j;
+    }
+  }
+
+  // The pair buffer is no longer needed; reuse it as the permutation
+  int *perm = (int *)temp;
+  for (int i = 0; i < count; i++) {
+    perm[i] = pairs[i].index;
+  }
+  apply_permutation(base, perm, count, size, scratch);
+
+  free(pairs);
+  free(temp);
+  free(scratch);
+  return SUCCESS;
+}
+
+// LSD over 8-bit digits of the 64-bit key; stable, so ties keep index order
+void radix_sort_pairs(KeyIndex *pairs, KeyIndex *temp, int count) {
+  int counts[KEY_BITS / RADIX_BITS][RADIX_BUCKETS];
+  KeyIndex *src = pairs;
+  KeyIndex *dst = temp;
+
+  memset(counts, 0, sizeof(counts));
+  for (int i = 0; i < count; i++) {
+    for (int p = 0; p < KEY_BITS / RADIX_BITS; p++) {
+      counts[p][(pairs[i].key >> (p * RADIX_BITS)) & RADIX_MASK]++;
+    }
+  }
+
+  for (int p = 0; p < KEY_BITS / RADIX_BITS; p++) {
+    int shift = p * RADIX_BITS;
+    int *offsets = counts[p];
+    if (offsets[(pairs[0].key >> shift) & RADIX_MASK] == count) {
+      continue;
+    }
+
+    int running = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+      int n = offsets[b];
+      offsets[b] = running;
+      running += n;
+    }
+    for (int i = 0; i < count; i++) {
+      dst[offsets[(src[i].key >> shift) & RADIX_MASK]++] = src[i];
+    }
+
+    KeyIndex *swap_buf = src;
+    src = dst;
+    dst = swap_buf;
+  }
+
+  if (src != pairs) {
+    memcpy(pairs, src, count * sizeof(KeyIndex));
+  }
+}
+
+// Stable merge sort of a run of equal keys, comparing the full records
+void sort_tied_indices(KeyIndex *run, KeyIndex *temp, int count,
+                       const char *base, size_t size, CompareFn cmp) {
+  if (count < 2) {
+    return;
+  }
+
+  int mid = count / 2;
+  sort_tied_indices(run, temp, mid, base, size, cmp);
+  sort_tied_indices(run + mid, temp, count - mid, base, size, cmp);
+
+  int i = 0;
+  int j = mid;
+  int k = 0;
+  while (i < mid && j < count) {
+    if (cmp(base + run[j].index * size, base + run[i].index * size) < 0) {
+      temp[k++] = run[j++];
+    } else {
+      temp[k++] = run[i++];
+    }
+  }
+  while (i < mid) {
+    temp[k++] = run[i++];
+  }
+  while (j < count) {
+    temp[k++] = run[j++];
+  }
+  memcpy(run, temp, count * sizeof(KeyIndex));
+}
+
+/*
+ * perm[i] is the index of the record that belongs at i. Each cycle is
+ * rotated through one scratch record, and finished slots are marked
+ * with perm[i] = i, so every record is copied once.
+ */
+void apply_permutation(void *base, int *perm, int count, size_t size,
+                       void *scratch) {
+  char *records = (char *)base;
+
+  for (int start = 0; start < count; start++) {
+    if (perm[start] == start) {
+      continue;
+    }
+
+    memcpy(scratch, records + start * size, size);
+    int j = start;
+    while (perm[j] != start) {
+      int next = perm[j];
+      memcpy(records + j * size, records + next * size, size);
+      perm[j] = j;
+      j = next;
+    }
+    memcpy(records + j * size, scratch, size);
+    perm[j] = j;
+  }
+}
+
+// IEEE-754: flip all bits of negatives, only the sign bit of positives
+unsigned long long key_from_float(float value) {
+  unsigned int bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & RADIX_SIGN_BIT) ? ~bits : bits | RADIX_SIGN_BIT;
+}
+
+// First 8 bytes, big-endian: orders like strcmp up to that prefix
+unsigned long long key_from_string(const char *text, size_t max_len) {
+  unsigned long long key = 0;
+  size_t i = 0;
+
+  for (; i < sizeof(key) && i < max_len && text[i] != '\0'; i++) {
+    key = (key << 8) | (unsigned char)text[i];
+  }
+  for (; i < sizeof(key); i++) {
+    key <<= 8;
+  }
+  return key;
+}
+
+unsigned long long student_key_promedio(const void *record) {
+  return key_from_float(((const Student *)record)->promedio);
+}
+
+int compare_student_promedio(const void *a, const void *b) {
+  float x = ((const Student *)a)->promedio;
+  float y = ((const Student *)b)->promedio;
+  return (x > y) - (x < y);
+}
+
+unsigned long long employee_key_salary(const void *record) {
+  return key_from_float(((const Employee *)record)->salary);
+}
+
+int compare_employee_salary(const void *a, const void *b) {
+  float x = ((const Employee *)a)->salary;
+  float y = ((const Employee *)b)->salary;
+  return (x > y) - (x < y);
+}
+
+unsigned long long employee_key_name(const void *record) {
+  return key_from_string(((const Employee *)record)->name, MAX_NAME);
+}
+
+int compare_employee_name(const void *a, const void *b) {
+  return strncmp(((const Employee *)a)->name, ((const Employee *)b)->name,
+                 MAX_NAME);
+}
+
+Status tim_sort(int *arr, int size, unsigned long long *comps) {
+  if (size < 2) {
+    return SUCCESS;
+  }
+  if (size < TIM_MIN_MERGE) {
+    int run = tim_count_run(arr, 0, size, comps);
+    tim_binary_insertion(arr, 0, size, run, comps);
+    return SUCCESS;
+  }
+
+  TimState ts;
+  ts.arr = arr;
+  ts.temp = (int *)malloc((size / 2 + 1) * sizeof(int));
+  if (ts.temp == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  ts.min_gallop = TIM_MIN_GALLOP;
+  ts.stack_size = 0;
+  ts.comps = comps;
+
+  int min_run = tim_min_run(size);
+  int low = 0;
+  while (low < size) {
+    int run = tim_count_run(arr, low, size, comps);
+    if (run < min_run) {
+      int forced = size - low < min_run ? size - low : min_run;
+      tim_binary_insertion(arr, low, low + forced, low + run, comps);
+      run = forced;
+    }
+
+    ts.run_base[ts.stack_size] = low;
+    ts.run_len[ts.stack_size] = run;
+    ts.stack_size++;
+    tim_merge_collapse(&ts);
+    low += run;
+  }
+  tim_merge_force_collapse(&ts);
+
+  free(ts.temp);
+  return SUCCESS;
+}
+
+// n / 2^k rounded up into [16, 32], so n / minrun is close to a power of 2
+int tim_min_run(int n) {
+  int extra = 0;
+  while (n >= TIM_MIN_MERGE) {
+    extra |= n & 1;
+    n >>= 1;
+  }
+  return n + extra;
+}
+
+// Length of the run at low; strictly descending runs are reversed
+int tim_count_run(int *arr, int low, int high, unsigned long long *comps) {
+  int run_high = low + 1;
+  if (run_high == high) {
+    return 1;
+  }
+
+  (*comps)++;
+  if (arr[run_high++] < arr[low]) {
+    while (run_high < high && arr[run_high] < arr[run_high - 1]) {
+      (*comps)++;
+      run_high++;
+    }
+    reverse_range(arr, low, run_high);
+  } else {
+    while (run_high < high && arr[run_high] >= arr[run_high - 1]) {
+      (*comps)++;
+      run_high++;
+    }
+  }
+  return run_high - low;
+}
+
+// [low, start) is already sorted; inserts the rest with binary search
+void tim_binary_insertion(int *arr, int low, int high, int start,
+                          unsigned long long *comps) {
+  for (; start < high; start++) {
+    int pivot = arr[start];
+    int left = low;
+    int right = start;
+
+    while (left < right) {
+      int mid = left + (right - left) / 2;
+      (*comps)++;
+      if (pivot < arr[mid]) {
+        right = mid;
+      } else {
+        left = mid + 1;
+      }
+    }
+    memmove(arr + left + 1, arr + left, (start - left) * sizeof(int));
+    arr[left] = pivot;
+  }
+}
+
+/*
+ * Restores run_len[n-1] > run_len[n] + run_len[n+1] and
+ * run_len[n] > run_len[n+1] over the top four runs (checking only the
+ * top three lets the invariant break deeper in the stack).
+ */
+void tim_merge_collapse(TimState *ts) {
+  while (ts->stack_size > 1) {
+    int n = ts->stack_size - 2;
+    int *len = ts->run_len;
+
+    if ((n > 0 && len[n - 1] <= len[n] + len[n + 1]) ||
+        (n > 1 && len[n - 2] <= len[n - 1] + len[n])) {
+      if (len[n - 1] < len[n + 1]) {
+        n--;
+      }
+    } else if (len[n] > len[n + 1]) {
+      break;
+    }
+    tim_merge_at(ts, n);
+  }
+}
+
+void tim_merge_force_collapse(TimState *ts) {
+  while (ts->stack_size > 1) {
+    int n = ts->stack_size - 2;
+    if (n > 0 && ts->run_len[n - 1] < ts->run_len[n + 1]) {
+      n--;
+    }
+    tim_merge_at(ts, n);
+  }
+}
+
+// Merges stack runs i and i + 1, trimming what is already in place
+void tim_merge_at(TimState *ts, int i) {
+  int *arr = ts->arr;
+  int base1 = ts->run_base[i];
+  int len1 = ts->run_len[i];
+  int base2 = ts->run_base[i + 1];
+  int len2 = ts->run_len[i + 1];
+
+  ts->run_len[i] = len1 + len2;
+  if (i == ts->stack_size - 3) {
+    ts->run_base[i + 1] = ts->run_base[i + 2];
+    ts->run_len[i + 1] = ts->run_len[i + 2];
+  }
+  ts->stack_size--;
+
+  // Elements of run 1 below run2[0] and of run 2 above run1[last] stay
+  int k = gallop_right(arr[base2], arr + base1, len1, 0, ts->comps);
+  base1 += k;
+  len1 -= k;
+  if (len1 == 0) {
+    return;
+  }
+  len2 = gallop_left(arr[base1 + len1 - 1], arr + base2, len2, len2 - 1,
+                     ts->comps);
+  if (len2 == 0) {
+    return;
+  }
+
+  if (len1 <= len2) {
+    tim_merge_lo(ts, base1, len1, base2, len2);
+  } else {
+    tim_merge_hi(ts, base1, len1, base2, len2);
+  }
+}
+
+/*
+ * Forward merge with run 1 copied to temp. Starts one element at a
+ * time; once one side wins min_gallop times in a row it switches to
+ * galloping, which copies whole blocks found by exponential search.
+ */
+void tim_merge_lo(TimState *ts, int base1, int len1, int base2, int len2) {
+  int *arr = ts->arr;
+  int *tmp = ts->temp;
+  int cursor1 = 0;
+  int cursor2 = base2;
+  int dest = base1;
+  int min_gallop = ts->min_gallop;
+  int done = FALSE;
+
+  memcpy(tmp, arr + base1, len1 * sizeof(int));
+  arr[dest++] = arr[cursor2++];
+  len2--;
+  if (len2 == 0 || len1 == 1) {
+    done = TRUE;
+  }
+
+  while (!done) {
+    int count1 = 0;
+    int count2 = 0;
+
+    while (TRUE) {
+      (*ts->comps)++;
+      if (arr[cursor2] < tmp[cursor1]) {
+        arr[dest++] = arr[cursor2++];
+        count2++;
+        count1 = 0;
+        if (--len2 == 0) {
+          done = TRUE;
+          break;
+        }
+      } else {
+        arr[dest++] = tmp[cursor1++];
+        count1++;
+        count2 = 0;
+        if (--len1 == 1) {
+          done = TRUE;
+          break;
+        }
+      }
+      if ((count1 | count2) >= min_gallop) {
+        break;
+      }
+    }
+
+    while (!done) {
+      count1 = gallop_right(arr[cursor2], tmp + cursor1, len1, 0, ts->comps);
+      if (count1 != 0) {
+        memcpy(arr + dest, tmp + cursor1, count1 * sizeof(int));
+        dest += count1;
+        cursor1 += count1;
+        len1 -= count1;
+        if (len1 <= 1) {
+          done = TRUE;
+          break;
+        }
+      }
+      arr[dest++] = arr[cursor2++];
+      if (--len2 == 0) {
+        done = TRUE;
+        break;
+      }
+
+      count2 = gallop_left(tmp[cursor1], arr + cursor2, len2, 0, ts->comps);
+      if (count2 != 0) {
+        memmove(arr + dest, arr + cursor2, count2 * sizeof(int));
+        dest += count2;
+        cursor2 += count2;
+        len2 -= count2;
+        if (len2 == 0) {
+          done = TRUE;
+          break;
+        }
+      }
+      arr[dest++] = tmp[cursor1++];
+      if (--len1 == 1) {
+        done = TRUE;
+        break;
+      }
+
+      min_gallop--;
+      if (count1 < TIM_MIN_GALLOP && count2 < TIM_MIN_GALLOP) {
+        break;
+      }
+    }
+    if (min_gallop < 0) {
+      min_gallop = 0;
+    }
+    min_gallop += 2;
+  }
+  ts->min_gallop = min_gallop < 1 ? 1 : min_gallop;
+
+  if (len1 == 1) {
+    // Last element of run 1 is the largest left; it goes after run 2
+    memmove(arr + dest, arr + cursor2, len2 * sizeof(int));
+    arr[dest + len2] = tmp[cursor1];
+  } else {
+    memcpy(arr + dest, tmp + cursor1, len1 * sizeof(int));
+  }
+}
+
+// Mirror of tim_merge_lo: run 2 goes to temp, merging from the back
+void tim_merge_hi(TimState *ts, int base1, int len1, int base2, int len2) {
+  int *arr = ts->arr;
+  int *tmp = ts->temp;
+  int cursor1 = base1 + len1 - 1;
+  int cursor2 = len2 - 1;
+  int dest = base2 + len2 - 1;
+  int min_gallop = ts->min_gallop;
+  int done = FALSE;
+
+  memcpy(tmp, arr + base2, len2 * sizeof(int));
+  arr[dest--] = arr[cursor1--];
+  len1--;
+  if (len1 == 0 || len2 == 1) {
+    done = TRUE;
+  }
+
+  while (!done) {
+    int count1 = 0;
+    int count2 = 0;
+
+    while (TRUE) {
+      (*ts->comps)++;
+      if (tmp[cursor2] < arr[cursor1]) {
+        arr[dest--] = arr[cursor1--];
+        count1++;
+        count2 = 0;
+        if (--len1 == 0) {
+          done = TRUE;
+          break;
+        }
+      } else {
+        arr[dest--] = tmp[cursor2--];
+        count2++;
+        count1 = 0;
+        if (--len2 == 1) {
+          done = TRUE;
+          break;
+        }
+      }
+      if ((count1 | count2) >= min_gallop) {
+        break;
+      }
+    }
+
+    while (!done) {
+      count1 = len1 - gallop_right(tmp[cursor2], arr + base1, len1, len1 - 1,
+                                   ts->comps);
+      if (count1 != 0) {
+        dest -= count1;
+        cursor1 -= count1;
+        len1 -= count1;
+        memmove(arr + dest + 1, arr + cursor1 + 1, count1 * sizeof(int));
+        if (len1 == 0) {
+          done = TRUE;
+          break;
+        }
+      }
+      arr[dest--] = tmp[cursor2--];
+      if (--len2 == 1) {
+        done = TRUE;
+        break;
+      }
+
+      count2 = len2 - gallop_left(arr[cursor1], tmp, len2, len2 - 1,
+                                  ts->comps);
+      if (count2 != 0) {
+        dest -= count2;
+        cursor2 -= count2;
+        len2 -= count2;
+        memcpy(arr + dest + 1, tmp + cursor2 + 1, count2 * sizeof(int));
+        if (len2 <= 1) {
+          done = TRUE;
+          break;
+        }
+      }
+      arr[dest--] = arr[cursor1--];
+      if (--len1 == 0) {
+        done = TRUE;
+        break;
+      }
+
+      min_gallop--;
+      if (count1 < TIM_MIN_GALLOP && count2 < TIM_MIN_GALLOP) {
+        break;
+      }
+    }
+    if (min_gallop < 0) {
+      min_gallop = 0;
+    }
+    min_gallop += 2;
+  }
+  ts->min_gallop = min_gallop < 1 ? 1 : min_gallop;
+
+  if (len2 == 1) {
+    // First element of run 2 is the smallest left; it goes before run 1
+    dest -= len1;
+    cursor1 -= len1;
+    memmove(arr + dest + 1, arr + cursor1 + 1, len1 * sizeof(int));
+    arr[dest] = tmp[cursor2];
+  } else {
+    memcpy(arr + dest - (len2 - 1), tmp, len2 * sizeof(int));
+  }
+}
+
+/*
+ * Leftmost position for key in sorted arr[0, n): probes hint, hint +- 1,
+ * 3, 7, ... and then binary-searches the last gap, so a key landing
+ * near hint costs O(log distance) instead of O(log n).
+ */
+int gallop_left(int key, const int *arr, int n, int hint,
+                unsigned long long *comps) {
+  int last = 0;
+  int ofs = 1;
+
+  (*comps)++;
+  if (key > arr[hint]) {
+    int max_ofs = n - hint;
+    while (ofs < max_ofs && key > arr[hint + ofs]) {
+      (*comps)++;
+      last = ofs;
+      ofs = ofs * 2 + 1;
+      if (ofs <= 0) {
+        ofs = max_ofs;
+      }
+    }
+    if (ofs > max_ofs) {
+      ofs = max_ofs;
+    }
+    last += hint;
+    ofs += hint;
+  } else {
+    int max_ofs = hint + 1;
+    while (ofs < max_ofs && key <= arr[hint - ofs]) {
+      (*comps)++;
+      last = ofs;
+      ofs = ofs * 2 + 1;
+      if (ofs <= 0) {
+        ofs = max_ofs;
+      }
+    }
+    if (ofs > max_ofs) {
+      ofs = max_ofs;
+    }
+    int prev = last;
+    last = hint - ofs;
+    ofs = hint - prev;
+  }
+
+  // Now arr[last] < key <= arr[ofs]
+  last++;
+  while (last < ofs) {
+    int mid = last + (ofs - last) / 2;
+    (*comps)++;
+    if (key > arr[mid]) {
+      last = mid + 1;
+    } else {
+      ofs = mid;
+    }
+  }
+  return ofs;
+}
+
+// Like gallop_left, but returns the position after any equal keys
+int gallop_right(int key, const int *arr, int n, int hint,
+                 unsigned long long *comps) {
+  int last = 0;
+  int ofs = 1;
+
+  (*comps)++;
+  if (key < arr[hint]) {
+    int max_ofs = hint + 1;
+    while (ofs < max_ofs && key < arr[hint - ofs]) {
+      (*comps)++;
+      last = ofs;
+      ofs = ofs * 2 + 1;
+      if (ofs <= 0) {
+        ofs = max_ofs;
+      }
+    }
+    if (ofs > max_ofs) {
+      ofs = max_ofs;
+    }
+    int prev = last;
+    last = hint - ofs;
+    ofs = hint - prev;
+  } else {
+    int max_ofs = n - hint;
+    while (ofs < max_ofs && key >= arr[hint + ofs]) {
+      (*comps)++;
+      last = ofs;
+      ofs = ofs * 2 + 1;
+      if (ofs <= 0) {
+        ofs = max_ofs;
+      }
+    }
+    if (ofs > max_ofs) {
+      ofs = max_ofs;
+    }
+    last += hint;
+    ofs += hint;
+  }
+
+  // Now arr[last] <= key < arr[ofs]
+  last++;
+  while (last < ofs) {
+    int mid = last + (ofs - last) / 2;
+    (*comps)++;
+    if (key < arr[mid]) {
+      ofs = mid;
+    } else {
+      last = mid + 1;
+    }
+  }
+  return ofs;
+}
+
+void reverse_range(int *arr, int low, int high) {
+  high--;
+  while (low < high) {
+    swap(&arr[low++], &arr[high--]);
+  }
+}
+
+void bubble_sort(int *arr, int size, unsigned long long *comps) {
+  for (int i = 0; i < size - 1; i++) {
+    int swapped = FALSE;
+    for (int j = 0; j < size - i - 1; j++) {
+      (*comps)++;
+      if (arr[j] > arr[j + 1]) {
+        swap(&arr[j], &arr[j + 1]);
+        swapped = TRUE;
+      }
+    }
+    if (!swapped) {
+      break;
+    }
+  }
+}
+
+void selection_sort(int *arr, int size, unsigned long long *comps) {
+  for (int i = 0; i < size - 1; i++) {
+    int min_idx = i;
+    for (int j = i + 1; j < size; j++) {
+      (*comps)++;
+      if (arr[j] < arr[min_idx]) {
+        min_idx = j;
+      }
+    }
+    swap(&arr[min_idx], &arr[i]);
+  }
+}
+
+Status bench_bubble(int *arr, int *temp, int size, unsigned long long *comps) {
+  (void)temp;
+  bubble_sort(arr, size, comps);
+  return SUCCESS;
+}
+
+Status bench_selection(int *arr, int *temp, int size,
+                       unsigned long long *comps) {
+  (void)temp;
+  selection_sort(arr, size, comps);
+  return SUCCESS;
+}
+
+Status bench_insertion(int *arr, int *temp, int size,
+                       unsigned long long *comps) {
+  (void)temp;
+  insertion_sort_range(arr, 0, size - 1, comps);
+  return SUCCESS;
+}
+
+Status bench_merge(int *arr, int *temp, int size, unsigned long long *comps) {
+  merge_sort_recursive(arr, 0, size - 1, temp, comps);
+  return SUCCESS;
+}
+
+Status bench_introsort(int *arr, int *temp, int size,
+                       unsigned long long *comps) {
+  (void)temp;
+  introsort(arr, size, comps);
+  return SUCCESS;
+}
+
+Status bench_timsort(int *arr, int *temp, int size,
+                     unsigned long long *comps) {
+  (void)temp;
+  return tim_sort(arr, size, comps);
+}
+
+Status bench_radix(int *arr, int *temp, int size, unsigned long long *comps) {
+  (void)comps;
+  radix_sort(arr, temp, size);
+  return SUCCESS;
+}
+
+Status bench_parallel_merge(int *arr, int *temp, int size,
+                            unsigned long long *comps) {
+  (void)comps;
+  return parallel_merge_sort(arr, temp, size, bench_threads);
+}
+
+Status bench_parallel_radix(int *arr, int *temp, int size,
+                            unsigned long long *comps) {
+  (void)comps;
+  return parallel_radix_sort(arr, temp, size, bench_threads);
+}
+
+Status parse_bench_args(int argc, char *argv[], BenchConfig *config,
+                        char *path) {
+  config->max_size = BENCH_MAX_SIZE;
+  config->warmups = BENCH_WARMUPS;
+  config->repetitions = BENCH_REPETITIONS;
+  config->threads = default_thread_count();
+  config->format = FORMAT_CSV;
+
+  for (int i = 2; i < argc; i++) {
+    if (i + 1 >= argc) {
+      return ERR_INVALID_INPUT;
+    }
+    const char *flag = argv[i];
+    const char *value = argv[++i];
+    char *end = NULL;
+    long number = strtol(value, &end, 10);
+    int numeric = *end == '\0' && number > 0 && number <= INT_MAX;
+
+    if (strcmp(flag, "--format") == 0) {
+      if (strcmp(value, "csv") == 0) {
+        config->format = FORMAT_CSV;
+      } else if (strcmp(value, "json") == 0) {
+        config->format = FORMAT_JSON;
+      } else {
+        return ERR_INVALID_INPUT;
+      }
+    } else if (strcmp(flag, "--output") == 0) {
+      snprintf(path, MAX_PATH_LEN, "%s", value);
+    } else if (strcmp(flag, "--warmups") == 0) {
+      // Zero warmups is valid, so this one skips the positive check
+      if (*end != '\0' || number < 0 || number > BENCH_MAX_REPETITIONS) {
+        return ERR_INVALID_INPUT;
+      }
+      config->warmups = (int)number;
+    } else if (!numeric) {
+      return ERR_INVALID_INPUT;
+    } else if (strcmp(flag, "--reps") == 0 &&
+               number <= BENCH_MAX_REPETITIONS) {
+      config->repetitions = (int)number;
+    } else if (strcmp(flag, "--max-size") == 0 && number >= BENCH_MIN_SIZE) {
+      config->max_size = (int)number;
+    } else if (strcmp(flag, "--threads") == 0 && number <= MAX_THREADS) {
+      config->threads = (int)number;
+    } else {
+      return ERR_INVALID_INPUT;
+    }
+  }
+  return SUCCESS;
+}
+
+/*
+ * Runs every algorithm over sizes BENCH_MIN_SIZE, x10, ... up to
+ * max_size and over every InputPattern. Each (size, pattern) cell
+ * reseeds rand(), so two builds time exactly the same inputs.
+ * Progress goes to stderr so stdout can carry the CSV/JSON itself.
+ */
+Status run_benchmark_suite(FILE *out, const BenchConfig *config,
+                           int *failures) {
+  int *master = (int *)malloc(config->max_size * sizeof(int));
+  int *work = (int *)malloc(config->max_size * sizeof(int));
+  int *temp = (int *)malloc(config->max_size * sizeof(int));
+  Status status = SUCCESS;
+  int first = TRUE;
+
+  if (master == NULL || work == NULL || temp == NULL) {
+    free(master);
+    free(work);
+    free(temp);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  bench_threads = config->threads;
+  *failures = 0;
+
+  if (config->format == FORMAT_JSON) {
+    fprintf(out,
+            "{\n  \"warmups\": %d,\n  \"repetitions\": %d,\n"
+            "  \"threads\": %d,\n  \"simd_kernels\": \"%s\",\n"
+            "  \"results\": [",
+            config->warmups, config->repetitions, config->threads,
+            simd_kernel_name);
+  } else {
+    fprintf(out, "algorithm,pattern,size,repetitions,median_s,p95_s,"
+                 "min_s,comparisons,cycles,instructions,branch_misses,"
+                 "cache_misses,verified\n");
+  }
+
+  for (int size = BENCH_MIN_SIZE;
+       size <= config->max_size && status == SUCCESS; size *= 10) {
+    for (int p = 0; p < PATTERN_COUNT && status == SUCCESS; p++) {
+      srand(BENCH_SEED + (unsigned int)size * PATTERN_COUNT + p);
+      fill_pattern_array(master, size, (InputPattern)p);
+
+      for (int a = 0; a < bench_algorithm_count; a++) {
+        const BenchAlgorithm *algo = &bench_algorithms[a];
+        BenchResult result;
+        if (size > algo->max_size) {
+          continue;
+        }
+
+        fprintf(stderr, "  %-16s %-12s %10d\r", algo->name,
+                pattern_key((InputPattern)p), size);
+        status = benchmark_cell(algo, master, work, temp, size, config,
+                                &result);
+        if (status != SUCCESS) {
+          break;
+        }
+        result.pattern = pattern_key((InputPattern)p);
+        if (!result.verified) {
+          (*failures)++;
+        }
+        write_bench_result(out, config->format, &result, first);
+        first = FALSE;
+      }
+    }
+    if (size > config->max_size / 10) {
+      break;
+    }
+  }
+  fprintf(stderr, "%50s\r", "");
+
+  if (config->format == FORMAT_JSON) {
+    fprintf(out, "\n  ]\n}\n");
+  }
+
+  free(master);
+  free(work);
+  free(temp);
+  return status;
+}
+
+/*
+ * Warmups are timed too but discarded; the copy stays outside the timer.
+ * Comparisons and hardware counters come from the last repetition
+ * (-1 in the output when a counter is not available).
+ */
+Status benchmark_cell(const BenchAlgorithm *algo, const int *master,
+                      int *work, int *temp, int size,
+                      const BenchConfig *config, BenchResult *result) {
+  double *times = (double *)malloc(config->repetitions * sizeof(double));
+  long long expected = array_checksum(master, size);
+
+  if (times == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  result->algorithm = algo->name;
+  result->size = size;
+  result->repetitions = config->repetitions;
+  result->verified = TRUE;
+
+  for (int r = 0; r < config->warmups + config->repetitions; r++) {
+    unsigned long long comps = 0;
+    copy_array(master, work, size);
+
+    HwCounters hw;
+    perf_counters_start();
+    double start = get_time_seconds();
+    Status status = algo->run(work, temp, size, &comps);
+    double elapsed = get_time_seconds() - start;
+    perf_counters_stop(&hw);
+    if (status != SUCCESS) {
+      free(times);
+      return status;
+    }
+
+    if (!is_sorted(work, size) || array_checksum(work, size) != expected) {
+      result->verified = FALSE;
+    }
+    if (r >= config->warmups) {
+      times[r - config->warmups] = elapsed;
+      result->comparisons = comps;
+      result->hw = hw;
+    }
+  }
+
+  sort_doubles(times, config->repetitions);
+  result->min = times[0];
+  result->median = percentile(times, config->repetitions, 0.5);
+  result->p95 = percentile(times, config->repetitions, 0.95);
+
+  free(times);
+  return SUCCESS;
+}
+
+void write_bench_result(FILE *out, BenchFormat format,
+                        const BenchResult *result, int first) {
+  const long long *hw = result->hw.value;
+
+  if (format == FORMAT_JSON) {
+    fprintf(out,
+            "%s\n    {\"algorithm\": \"%s\", \"pattern\": \"%s\", "
+            "\"size\": %d, \"median_s\": %.9f, \"p95_s\": %.9f, "
+            "\"min_s\": %.9f, \"comparisons\": %llu, \"cycles\": %lld, "
+            "\"instructions\": %lld, \"branch_misses\": %lld, "
+            "\"cache_misses\": %lld, \"verified\": %s}",
+            first ? "" : ",", result->algorithm, result->pattern,
+            result->size, result->median, result->p95, result->min,
+            result->comparisons, hw[HW_CYCLES], hw[HW_INSTRUCTIONS],
+            hw[HW_BRANCH_MISSES], hw[HW_CACHE_MISSES],
+            result->verified ? "true" : "false");
+  } else {
+    fprintf(out, "%s,%s,%d,%d,%.9f,%.9f,%.9f,%llu,%lld,%lld,%lld,%lld,%s\n",
+            result->algorithm, result->pattern, result->size,
+            result->repetitions, result->median, result->p95, result->min,
+            result->comparisons, hw[HW_CYCLES], hw[HW_INSTRUCTIONS],
+            hw[HW_BRANCH_MISSES], hw[HW_CACHE_MISSES],
+            result->verified ? "true" : "false");
+  }
+}
+
+// Nearest-rank percentile over an already sorted sample
+double percentile(const double *sorted, int count, double fraction) {
+  int rank = (int)ceil(fraction * count);
+  if (rank < 1) {
+    rank = 1;
+  }
+  return sorted[rank - 1];
+}
+
+void sort_doubles(double *values, int count) {
+  for (int i = 1; i < count; i++) {
+    double key = values[i];
+    int j = i - 1;
+    while (j >= 0 && values[j] > key) {
+      values[j + 1] = values[j];
+      j--;
+    }
+    values[j + 1] = key;
+  }
+}
+
+void run_quick_sort(int *arr, int size, SortStats *stats) {
+  printf("Ejecutando...\n");
+
+  perf_counters_start();
+  double start = get_time_seconds();
+  introsort(arr, size, &stats->comparisons);
+  stats->time_taken = get_time_seconds() - start;
+  perf_counters_stop(&stats->hw);
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  printf("  - Comparaciones: %llu\n", stats->comparisons);
+  printf("  - Complejidad:   O(n log n) garantizado\n");
+  printf("  - Memoria extra: O(log n) (Stack)\n");
+  print_hw_counters(&stats->hw);
+}
+
+void introsort(int *arr, int size, unsigned long long *comps) {
+  if (size < 2) {
+    return;
+  }
+
+  int depth_limit = 0;
+  for (int n = size; n > 1; n >>= 1) {
+    depth_limit += 2;
+  }
+  introsort_loop(arr, 0, size - 1, depth_limit, comps);
+}
+
+/*
+ * Recurses only into the smaller partition and loops on the larger
+ * one, so the stack never grows past O(log n) even when pivots are bad.
+ */
+void introsort_loop(int *arr, int low, int high, int depth_limit,
+                    unsigned long long *comps) {
+  while (high - low + 1 > INSERTION_THRESHOLD) {
+    if (depth_limit == 0) {
+      heap_sort_range(arr, low, high, comps);
+      return;
+    }
+    depth_limit--;
+
+    int p = hoare_partition(arr, low, high, comps);
+    if (p - low < high - p) {
+      introsort_loop(arr, low, p, depth_limit, comps);
+      low = p + 1;
+    } else {
+      introsort_loop(arr, p + 1, high, depth_limit, comps);
+      high = p;
+    }
+  }
+
+  insertion_sort_range(arr, low, high, comps);
+}
+
+// Returns j such that [low, j] <= pivot <= [j + 1, high], with j < high
+int hoare_partition(int *arr, int low, int high, unsigned long long *comps) {
+  swap(&arr[low], &arr[choose_pivot(arr, low, high, comps)]);
+
+  int pivot = arr[low];
+  int i = low - 1;
+  int j = high + 1;
+
+  while (TRUE) {
+    do {
+      j--;
+      (*comps)++;
+    } while (arr[j] > pivot);
+    do {
+      i++;
+      (*comps)++;
+    } while (arr[i] < pivot);
+
+    if (i >= j) {
+      return j;
+    }
+    swap(&arr[i], &arr[j]);
+  }
+}
+
+// Median of three, or Tukey's ninther once the range is large
+int choose_pivot(const int *arr, int low, int high,
+                 unsigned long long *comps) {
+  int mid = low + (high - low) / 2;
+
+  if (high - low + 1 < NINTHER_THRESHOLD) {
+    return median_of_three(arr, low, mid, high, comps);
+  }
+
+  int step = (high - low + 1) / 8;
+  int m1 = median_of_three(arr, low, low + step, low + 2 * step, comps);
+  int m2 = median_of_three(arr, mid - step, mid, mid + step, comps);
+  int m3 = median_of_three(arr, high - 2 * step, high - step, high, comps);
+  return median_of_three(arr, m1, m2, m3, comps);
+}
+
+int median_of_three(const int *arr, int a, int b, int c,
+                    unsigned long long *comps) {
+  *comps += 3;
+  if (arr[a] < arr[b]) {
+    if (arr[b] < arr[c])
+      return b;
+    return arr[a] < arr[c] ? c : a;
+  }
+  if (arr[a] < arr[c])
+    return a;
+  return arr[b] < arr[c] ? c : b;
+}
+
+void insertion_sort_range(int *arr, int low, int high,
+                          unsigned long long *comps) {
+  for (int i = low + 1; i <= high; i++) {
+    int key = arr[i];
+    int j = i - 1;
+
+    while (j >= low) {
+      (*comps)++;
+      if (arr[j] <= key) {
+        break;
+      }
+      arr[j + 1] = arr[j];
+      j--;
+    }
+    arr[j + 1] = key;
+  }
+}
+
+void heap_sort_range(int *arr, int low, int high, unsigned long long *comps) {
+  int *base = arr + low;
+  int size = high - low + 1;
+
+  for (int root = size / 2 - 1; root >= 0; root--) {
+    sift_down(base, root, size, comps);
+  }
+  for (int end = size - 1; end > 0; end--) {
+    swap(&base[0], &base[end]);
+    sift_down(base, 0, end, comps);
+  }
+}
+
+void sift_down(int *arr, int root, int size, unsigned long long *comps) {
+  int value = arr[root];
+
+  while (2 * root + 1 < size) {
+    int child = 2 * root + 1;
+    if (child + 1 < size) {
+      (*comps)++;
+      if (arr[child + 1] > arr[child]) {
+        child++;
+      }
+    }
+    (*comps)++;
+    if (arr[child] <= value) {
+      break;
+    }
+    arr[root] = arr[child];
+    root = child;
+  }
+  arr[root] = value;
+}
+
+void run_radix_sort(int *arr, int size, SortStats *stats) {
+  printf("Ejecutando...\n");
+
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (temp == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  perf_counters_start();
+  double start = get_time_seconds();
+  radix_sort(arr, temp, size);
+  stats->time_taken = get_time_seconds() - start;
+  perf_counters_stop(&stats->hw);
+  free(temp);
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  printf("  - Comparaciones: 0 (reparte por dígitos)\n");
+  printf("  - Complejidad:   O(n * %d)\n", RADIX_PASSES);
+  printf("  - Memoria extra: O(n)\n");
+  print_hw_counters(&stats->hw);
+}
+
+void run_parallel_radix_sort(int *arr, int size, int num_threads,
+                             SortStats *stats) {
+  printf("Ejecutando...\n");
+
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (temp == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  perf_counters_start();
+  double start = get_time_seconds();
+  Status status = parallel_radix_sort(arr, temp, size, num_threads);
+  stats->time_taken = get_time_seconds() - start;
+  perf_counters_stop(&stats->hw);
+  free(temp);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  printf("  - Verificación:  %s\n", is_sorted(arr, size) ? "OK" : "ERROR");
+  printf("  - Histogramas:   uno por hilo y por pasada\n");
+  printf("  - Memoria extra: O(n + hilos * %d)\n", RADIX_BUCKETS);
+  print_hw_counters(&stats->hw);
+}
+
+// Flipping the sign bit orders negative keys before positive ones
+int radix_digit(int value, int shift) {
+  return (int)((((unsigned int)value ^ RADIX_SIGN_BIT) >> shift) &
+               RADIX_MASK);
+}
+
+/*
+ * One read builds the histograms of every digit. A digit whose
+ * histogram has a single bucket holding all n keys cannot reorder
+ * anything, so its pass is skipped.
+ */
+void radix_sort(int *arr, int *temp, int size) {
+  int counts[RADIX_PASSES][RADIX_BUCKETS];
+  int *src = arr;
+  int *dst = temp;
+
+  memset(counts, 0, sizeof(counts));
+  for (int i = 0; i < size; i++) {
+    for (int p = 0; p < RADIX_PASSES; p++) {
+      counts[p][radix_digit(arr[i], p * RADIX_BITS)]++;
+    }
+  }
+
+  for (int p = 0; p < RADIX_PASSES; p++) {
+    int shift = p * RADIX_BITS;
+    int *offsets = counts[p];
+    if (offsets[radix_digit(arr[0], shift)] == size) {
+      continue;
+    }
+
+    int running = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+      int count = offsets[b];
+      offsets[b] = running;
+      running += count;
+    }
+    for (int i = 0; i < size; i++) {
+      dst[offsets[radix_digit(src[i], shift)]++] = src[i];
+    }
+
+    int *swap_buf = src;
+    src = dst;
+    dst = swap_buf;
+  }
+
+  if (src != arr) {
+    memcpy(arr, src, size * sizeof(int));
+  }
+}
+
+Status parallel_radix_sort(int *arr, int *temp, int size, int num_threads) {
+  RadixJob job;
+  RadixTask tasks[MAX_THREADS];
+  TaskPool pool;
+
+  job.counts = malloc(num_threads * sizeof(*job.counts));
+  if (job.counts == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  Status status = task_pool_init(&pool, num_threads);
+  if (status != SUCCESS) {
+    free(job.counts);
+    return status;
+  }
+
+  job.src = arr;
+  job.dst = temp;
+  job.size = size;
+  job.num_threads = num_threads;
+  for (int t = 0; t < num_threads; t++) {
+    tasks[t].base.run = radix_task_run;
+    tasks[t].job = &job;
+    tasks[t].thread = t;
+  }
+
+  for (int p = 0; p < RADIX_PASSES; p++) {
+    job.shift = p * RADIX_BITS;
+    job.phase = RADIX_COUNT;
+    for (int t = 0; t < num_threads; t++) {
+      task_pool_submit(&pool, &tasks[t].base);
+    }
+    task_pool_wait(&pool);
+
+    // Prefix sum over (bucket, thread) turns histograms into offsets
+    int running = 0;
+    int constant = FALSE;
+    for (int b = 0; b < RADIX_BUCKETS && !constant; b++) {
+      int bucket_start = running;
+      for (int t = 0; t < num_threads; t++) {
+        int count = job.counts[t][b];
+        job.counts[t][b] = running;
+        running += count;
+      }
+      constant = running - bucket_start == size;
+    }
+    if (constant) {
+      continue;
+    }
+
+    job.phase = RADIX_SCATTER;
+    for (int t = 0; t < num_threads; t++) {
+      task_pool_submit(&pool, &tasks[t].base);
+    }
+    task_pool_wait(&pool);
+
+    int *next_dst = (int *)job.src;
+    job.src = job.dst;
+    job.dst = next_dst;
+  }
+
+  task_pool_destroy(&pool);
+  free(job.counts);
+
+  if (job.src != arr) {
+    memcpy(arr, job.src, size * sizeof(int));
+  }
+  return SUCCESS;
+}
+
+void radix_task_run(TaskPool *pool, Task *task) {
+  RadixTask *rt = (RadixTask *)task;
+  RadixJob *job = rt->job;
+  int begin = (int)((long long)job->size * rt->thread / job->num_threads);
+  int end = (int)((long long)job->size * (rt->thread + 1) / job->num_threads);
+  int *counts = job->counts[rt->thread];
+  (void)pool;
+
+  if (job->phase == RADIX_COUNT) {
+    memset(counts, 0, RADIX_BUCKETS * sizeof(int));
+    for (int i = begin; i < end; i++) {
+      counts[radix_digit(job->src[i], job->shift)]++;
+    }
+    return;
+  }
+
+  for (int i = begin; i < end; i++) {
+    int value = job->src[i];
+    job->dst[counts[radix_digit(value, job->shift)]++] = value;
+  }
+}
+
+void show_final_comparison(int size, SortStats merge_stats,
+                           SortStats quick_stats, SortStats radix_stats) {
+  double n = (double)size;
+  double log_n = log2(n);
+  double ratio = (n * n) / (n * log_n);
+  double base_time =
+      (quick_stats.time_taken > 0) ? quick_stats.time_taken : 0.000001;
+  double estimated_bubble_time = base_time * ratio * 0.5;
+
+  printf("\n=== Comparación con Bubble Sort (estimado) ===\n\n");
+  printf("  - Bubble Sort tomaría: ~%.4f segundos\n", estimated_bubble_time);
+
+  if (quick_stats.time_taken > 0) {
+    printf("  - Introsort es %.0fx más rápido que Bubble Sort\n",
+           estimated_bubble_time / quick_stats.time_taken);
+  }
+  if (merge_stats.time_taken > 0) {
+    printf("  - Merge Sort es %.0fx más rápido que Bubble Sort\n",
+           estimated_bubble_time / merge_stats.time_taken);
+  }
+  if (radix_stats.time_taken > 0) {
+    printf("  - Radix Sort es %.0fx más rápido que Bubble Sort\n",
+           estimated_bubble_time / radix_stats.time_taken);
+  }
+
+  printf("\n  - Recomendación para arrays grandes (>1000 elementos):\n");
+  printf("    + Introsort: más rápido en promedio, sin peor caso O(n²)\n");
+  printf("    + Merge Sort: estable y predecible\n");
+  printf("    + Radix Sort: el más rápido con claves enteras de 32 bits\n\n");
+}
+
+void fill_pattern_array(int *arr, int size, InputPattern pattern) {
+  for (int i = 0; i < size; i++) {
+    switch (pattern) {
+    case PATTERN_RANDOM:
+      arr[i] = rand();
+      break;
+    case PATTERN_SORTED:
+      arr[i] = i;
+      break;
+    case PATTERN_REVERSED:
+      arr[i] = size - i;
+      break;
+    case PATTERN_FEW_UNIQUE:
+      arr[i] = rand() % FEW_UNIQUE_VALUES;
+      break;
+    case PATTERN_COUNT:
+      break;
+    }
+  }
+}
+
+void fill_presorted_array(int *arr, int size, PresortKind kind) {
+  int swaps = 0;
+
+  for (int i = 0; i < size; i++) {
+    arr[i] = kind == PRESORT_REVERSED ? size - i : i;
+  }
+
+  switch (kind) {
+  case PRESORT_SWAPS_1:
+    swaps = size / 100;
+    break;
+  case PRESORT_SWAPS_10:
+    swaps = size / 10;
+    break;
+  case PRESORT_APPENDED:
+    // A sorted log with 10% new unsorted entries appended at the end
+    for (int i = size - size / 10; i < size; i++) {
+      arr[i] = rand() % size;
+    }
+    break;
+  case PRESORT_RUNS:
+    // 16 interleaved ascending runs, like merged incremental batches
+    for (int i = 0; i < size; i++) {
+      arr[i] = (i % (size / 16 + 1)) * 16 + i / (size / 16 + 1);
+    }
+    break;
+  case PRESORT_RANDOM:
+    fill_pattern_array(arr, size, PATTERN_RANDOM);
+    break;
+  case PRESORT_SORTED:
+  case PRESORT_REVERSED:
+  case PRESORT_COUNT:
+    break;
+  }
+
+  for (int s = 0; s < swaps; s++) {
+    swap(&arr[rand() % size], &arr[rand() % size]);
+  }
+}
+
+const char *presort_name(PresortKind kind) {
+  switch (kind) {
+  case PRESORT_SORTED:
+    return "Ordenado";
+  case PRESORT_REVERSED:
+    return "Invertido";
+  case PRESORT_SWAPS_1:
+    return "1% swaps";
+  case PRESORT_SWAPS_10:
+    return "10% swaps";
+  case PRESORT_APPENDED:
+    return "+10% al final";
+  case PRESORT_RUNS:
+    return "16 runs";
+  case PRESORT_RANDOM:
+    return "Aleatorio";
+  case PRESORT_COUNT:
+    break;
+  }
+  return "?";
+}
+
+const char *pattern_name(InputPattern pattern) {
+  switch (pattern) {
+  case PATTERN_RANDOM:
+    return "Aleatorio";
+  case PATTERN_SORTED:
+    return "Ordenado";
+  case PATTERN_REVERSED:
+    return "Invertido";
+  case PATTERN_FEW_UNIQUE:
+    return "Pocos únicos";
+  case PATTERN_COUNT:
+    break;
+  }
+  return "?";
+}
+
+// ASCII identifiers for CSV/JSON; pattern_name is for the console
+const char *pattern_key(InputPattern pattern) {
+  switch (pattern) {
+  case PATTERN_RANDOM:
+    return "random";
+  case PATTERN_SORTED:
+    return "sorted";
+  case PATTERN_REVERSED:
+    return "reversed";
+  case PATTERN_FEW_UNIQUE:
+    return "few_unique";
+  case PATTERN_COUNT:
+    break;
+  }
+  return "?";
+}
+
+void perf_counters_open(void) {
+#ifdef HAVE_PERF_EVENTS
+  const unsigned long long configs[HW_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = 1;
+    // inherit: sort worker threads started while counting add to the
+    // totals; the descriptors are closed when the process exits
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+}
+
+void perf_counters_start(void) {
+#ifdef HAVE_PERF_EVENTS
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (perf_fds[i] >= 0) {
+      ioctl(perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void perf_counters_stop(HwCounters *hw) {
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    hw->value[i] = -1;
+#ifdef HAVE_PERF_EVENTS
+    unsigned long long data[3];
+    if (perf_fds[i] >= 0 &&
+        ioctl(perf_fds[i], PERF_EVENT_IOC_DISABLE, 0) == 0 &&
+        read(perf_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) &&
+        data[2] != 0) {
+      hw->value[i] = (long long)((double)data[0] * data[1] / data[2]);
+    }
+#endif
+  }
+}
+
+void print_hw_counters(const HwCounters *hw) {
+  const char *labels[HW_COUNTER_COUNT] = {"Ciclos:", "Instrucciones:",
+                                          "Fallos rama:", "Fallos caché: "};
+  int available = FALSE;
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      available = TRUE;
+    }
+  }
+  if (!available) {
+    printf("  - Contadores:   N/D (perf_event_open denegado)\n");
+    return;
+  }
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      printf("  - %-14s %lld\n", labels[i], hw->value[i]);
+    } else {
+      printf("  - %-14s N/A\n", labels[i]);
+    }
+  }
+  if (hw->value[HW_CYCLES] > 0 && hw->value[HW_INSTRUCTIONS] >= 0) {
+    printf("  - %-14s %.2f\n", "IPC:",
+           (double)hw->value[HW_INSTRUCTIONS] / hw->value[HW_CYCLES]);
+  }
+}
+
+int is_sorted(const int *arr, int size) {
+  for (int i = 1; i < size; i++) {
+    if (arr[i - 1] > arr[i]) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+int default_thread_count(void) {
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+  if (online < 1) {
+    return 1;
+  }
+  return online > MAX_THREADS ? MAX_THREADS : (int)online;
+}
+
+// Few distinct values on purpose, so stability is visible in the check
+void generate_students(Student *students, int count) {
+  const char *names[] = {"Ana", "Luis", "María", "Carlos", "Sofía",
+                         "Jorge", "Lucía", "Diego"};
+
+  for (int i = 0; i < count; i++) {
+    Student *s = &students[i];
+    memset(s, 0, sizeof(Student));
+    s->id = i + 1;
+    snprintf(s->nombre, STUDENT_NAME_LEN, "%s", names[rand() % 8]);
+    s->edad = 18 + rand() % 12;
+    s->promedio = (float)(rand() % 101) / 10.0f;
+  }
+}
+
+void generate_employees(Employee *employees, int count) {
+  const char *first[] = {"Alejandra", "Alejandro", "Fernanda", "Fernando",
+                         "Gabriela", "Gabriel", "Valentina", "Valentin"};
+  const char *last[] = {"Garcia", "Gomez", "Gonzalez", "Martinez",
+                        "Martin", "Rodriguez", "Ramirez", "Ramos"};
+  const char *departments[] = {"Ventas", "Finanzas", "Sistemas",
+                               "Marketing", "Logistica", "Legal"};
+
+  for (int i = 0; i < count; i++) {
+    Employee *e = &employees[i];
+    memset(e, 0, sizeof(Employee));
+    e->id = i + 1;
+    snprintf(e->name, MAX_NAME, "%s %s", first[rand() % 8], last[rand() % 8]);
+    snprintf(e->department, MAX_DEPT, "%s", departments[rand() % 6]);
+    e->salary = (float)(20000 + (rand() % 400) * 250);
+  }
+}
+
+// Both record layouts start with the int id
+int record_id(const void *record) {
+  int id;
+  memcpy(&id, record, sizeof(id));
+  return id;
+}
+
+// Ids are generated ascending, so equal keys must keep ascending ids
+const char *check_record_order(const void *base, int count, size_t size,
+                               CompareFn cmp) {
+  const char *records = (const char *)base;
+  int stable = TRUE;
+
+  for (int i = 1; i < count; i++) {
+    const char *prev = records + (i - 1) * size;
+    const char *curr = records + i * size;
+    int order = cmp(prev, curr);
+    if (order > 0) {
+      return "ERROR";
+    }
+    if (order == 0 && record_id(prev) > record_id(curr)) {
+      stable = FALSE;
+    }
+  }
+  return stable ? "OK (estable)" : "OK (inestable)";
+}
+
+long long array_checksum(const int *arr, int size) {
+  long long sum = 0;
+  for (int i = 0; i < size; i++) {
+    sum += arr[i];
+  }
+  return sum;
+}
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
 void print_array_preview(const int *arr, int size) {
@@ -6,24 +6,42 @@
  ===============================================================================
  Features:
  - Graph representation using Adjacency Lists
- - Explicit Stack implementation to visualize LIFO behavior
+ - Explicit edge-iterator Stack: each vertex is pushed exactly once
  - Step-by-step DFS execution log
  - "Demo Mode" to replicate specific tree structures
+ - Iterative DFS engine over CSR graphs with a growable frame stack
+ - Connected components, cycle detection, topological sort, Tarjan SCC
+ - Analytics benchmark on generated million-edge graphs
+ - Analytics on binary CSR graph files loaded through mmap
  - Dynamic memory management with proper cleanup
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #define TRUE 1
 #define FALSE 0
 #define MAX_VERTICES 26
-#define MAX_STACK 100
 #define MIN_OPTION 1
-#define MAX_OPTION 5
+#define MAX_OPTION 8
+#define MAX_PATH_LEN 256
+#define CSR_MAGIC "CSRGRAPH"
+#define CSR_VERSION 1
+#define CSR_FLAG_SYMMETRIC 1u
+#define DEFAULT_CSR_FILE "graph.csr"
+#define INITIAL_FRAMES 1024
+#define DEFAULT_BENCH_VERTICES 1000000
+#define DEFAULT_BENCH_EDGES 4000000
 
 typedef enum {
   SUCCESS,
@@ -32,7 +50,10 @@ typedef enum {
   ERR_FULL,
   ERR_NOT_FOUND,
   ERR_ALREADY_EXISTS,
-  ERR_MEMORY_ALLOCATION
+  ERR_MEMORY_ALLOCATION,
+  ERR_FILE_NOT_FOUND,
+  ERR_FILE_IO,
+  ERR_INVALID_FORMAT
 } Status;
 
 typedef struct AdjNode {
@@ -48,20 +69,97 @@ typedef struct {
 } Graph;
 
 typedef struct {
-  int items[MAX_STACK];
+  int vertex;
+  AdjNode *next_edge;
+} StackFrame;
+
+typedef struct {
+  StackFrame items[MAX_VERTICES];
   int top;
 } Stack;
 
+typedef enum { WHITE, GRAY, BLACK } Color;
+
+typedef enum { GRAPH_DIRECTED, GRAPH_UNDIRECTED, GRAPH_DAG } GraphKind;
+
+typedef struct {
+  int num_vertices;
+  long long num_edges;
+  long long *offsets;
+  int *targets;
+  unsigned int flags;
+  void *mapping;
+  size_t mapping_size;
+} CsrGraph;
+
+/*
+ * On-disk CSR layout shared with 05_graph_bfs.c (which writes it):
+ * [header 32 B][offsets: (V + 1) x int64][targets: E x int32]
+ */
+typedef struct {
+  char magic[8];
+  unsigned int version;
+  unsigned int flags;
+  long long num_vertices;
+  long long num_edges;
+} CsrFileHeader;
+
+typedef struct {
+  int vertex;
+  long long next_edge;
+} DfsFrame;
+
+typedef struct {
+  void (*on_discover)(int v, void *ctx);
+  int (*on_edge)(int u, int v, Color color, void *ctx);
+  void (*on_finish)(int v, int parent, void *ctx);
+} DfsVisitor;
+
+typedef struct {
+  const CsrGraph *csr;
+  unsigned char *color;
+  DfsFrame *frames;
+  int top;
+  int capacity;
+  int stopped;
+} DfsEngine;
+
+typedef struct {
+  int *component;
+  int current;
+} ComponentCtx;
+
+typedef struct {
+  int *order;
+  int count;
+  int cycle_found;
+} TopoCtx;
+
+typedef struct {
+  int *index;
+  int *low;
+  int *stack;
+  unsigned char *on_stack;
+  int *component;
+  int stack_top;
+  int next_index;
+  int count;
+} TarjanCtx;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_load_demo(Graph *g);
 void run_custom_graph(Graph *g);
 void run_show_graph(Graph *g);
 void run_execute_dfs(Graph *g);
+void run_analyze_graph(Graph *g);
+void run_analytics_benchmark(void);
+void run_analyze_graph_file(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_char(char *value);
+Status read_string(char *buffer, int max_len);
 
 void init_graph(Graph *g);
 Status add_vertex(Graph *g, char label);
@@ -70,11 +168,37 @@ int get_vertex_index(Graph *g, char label);
 void reset_visited(Graph *g);
 void clear_graph(Graph *g);
 void init_stack(Stack *s);
-void push(Stack *s, int value);
+void push(Stack *s, int vertex, AdjNode *edges);
 int pop(Stack *s);
+StackFrame *peek(Stack *s);
 int is_empty(Stack *s);
 void print_stack(Stack *s, Graph *g);
 
+double get_time_seconds(void);
+unsigned long long next_random(unsigned long long *state);
+Status build_csr_from_graph(const Graph *g, CsrGraph *csr, int undirected);
+Status generate_random_csr(CsrGraph *csr, int n, long long m, GraphKind kind);
+void free_csr(CsrGraph *csr);
+Status map_csr_file(CsrGraph *csr, const char *path);
+Status validate_csr(const CsrGraph *csr);
+
+Status dfs_engine_init(DfsEngine *e, const CsrGraph *csr);
+Status dfs_engine_run(DfsEngine *e, int root, const DfsVisitor *vis,
+                      void *ctx);
+void dfs_engine_free(DfsEngine *e);
+
+Status connected_components(const CsrGraph *csr, int *component, int *count);
+Status detect_cycle(const CsrGraph *csr, int *has_cycle);
+Status topological_sort(const CsrGraph *csr, int *order, int *is_dag);
+Status tarjan_scc(const CsrGraph *csr, int *component, int *count);
+void component_discover(int v, void *ctx);
+int topo_edge(int u, int v, Color color, void *ctx);
+void topo_finish(int v, int parent, void *ctx);
+void tarjan_discover(int v, void *ctx);
+int tarjan_edge(int u, int v, Color color, void *ctx);
+void tarjan_finish(int v, int parent, void *ctx);
+int largest_group(const int *group, int n, int count);
+
 int main(void) {
   int option = 0;
   Graph g;
@@ -113,6 +237,15 @@ int main(void) {
     case 4:
       run_execute_dfs(&g);
       break;
+    case 5:
+      run_analyze_graph(&g);
+      break;
+    case 6:
+      run_analytics_benchmark();
+      break;
+    case 7:
+      run_analyze_graph_file();
+      break;
     }
   }
 
@@ -122,7 +255,10 @@ int main(void) {
 void show_menu(void) {
   printf("=== Depth-First Search (DFS) Visualizer ===\n\n");
   printf("1. Load Demo Graph (A-F Tree)\n2. Create Custom Graph\n"
-         "3. Show Graph Structure\n4. Run DFS Visualization\n5. Exit\n");
+         "3. Show Graph Structure\n4. Run DFS Visualization\n"
+         "5. Analyze Graph (Components, Cycles, Topo Sort, SCC)\n"
+         "6. Graph Analytics Benchmark\n7. Analyze Graph File (mmap)\n"
+         "8. Exit\n");
   printf("Option: ");
 }
 
@@ -146,6 +282,15 @@ void handle_error(Status status) {
   case ERR_MEMORY_ALLOCATION:
     printf("Error: Memory allocation failed.\n\n");
     break;
+  case ERR_FILE_NOT_FOUND:
+    printf("Error: File not found.\n\n");
+    break;
+  case ERR_FILE_IO:
+    printf("Error: File read/write failed.\n\n");
+    break;
+  case ERR_INVALID_FORMAT:
+    printf("Error: Invalid or corrupted graph file.\n\n");
+    break;
   case SUCCESS:
     break;
   }
@@ -283,29 +428,37 @@ void run_execute_dfs(Graph *g) {
 
   printf("\n=== DFS Execution Log ===\n");
 
-  push(&s, start_idx);
-
   int visit_order[MAX_VERTICES];
   int visit_count = 0;
 
+  g->visited[start_idx] = TRUE;
+  printf("  > Visiting: %c\n", g->labels[start_idx]);
+  visit_order[visit_count++] = start_idx;
+  push(&s, start_idx, g->head[start_idx]);
+
   while (!is_empty(&s)) {
     print_stack(&s, g);
 
-    int current = pop(&s);
-
-    if (!g->visited[current]) {
-      g->visited[current] = TRUE;
-      printf("  > Visiting: %c\n", g->labels[current]);
-      visit_order[visit_count++] = current;
+    // Each frame remembers where it left off in its adjacency list
+    StackFrame *frame = peek(&s);
+    while (frame->next_edge != NULL &&
+           g->visited[frame->next_edge->vertex_idx]) {
+      frame->next_edge = frame->next_edge->next;
+    }
 
-      AdjNode *temp = g->head[current];
-      while (temp != NULL) {
-        if (!g->visited[temp->vertex_idx]) {
-          push(&s, temp->vertex_idx);
-        }
-        temp = temp->next;
-      }
+    if (frame->next_edge == NULL) {
+      printf("  > Backtrack: %c\n", g->labels[frame->vertex]);
+      pop(&s);
+      continue;
     }
+
+    int next = frame->next_edge->vertex_idx;
+    frame->next_edge = frame->next_edge->next;
+
+    g->visited[next] = TRUE;
+    printf("  > Visiting: %c\n", g->labels[next]);
+    visit_order[visit_count++] = next;
+    push(&s, next, g->head[next]);
   }
 
   printf("  > Stack: [] (Empty)\n");
@@ -317,6 +470,261 @@ void run_execute_dfs(Graph *g) {
   printf("\n\n");
 }
 
+void run_analyze_graph(Graph *g) {
+  if (g->num_vertices == 0) {
+    printf("\n  - Graph is empty.\n\n");
+    return;
+  }
+
+  CsrGraph directed, undirected;
+  if (build_csr_from_graph(g, &directed, FALSE) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  if (build_csr_from_graph(g, &undirected, TRUE) != SUCCESS) {
+    free_csr(&directed);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  int n = g->num_vertices;
+  int group[MAX_VERTICES];
+  int order[MAX_VERTICES];
+  int count = 0, has_cycle = FALSE, is_dag = FALSE;
+
+  printf("\n=== Graph Analytics ===\n");
+
+  if (connected_components(&undirected, group, &count) == SUCCESS) {
+    printf("\nConnected Components (ignoring direction): %d\n", count);
+    for (int c = 0; c < count; c++) {
+      printf("  - #%d: {", c + 1);
+      int first = TRUE;
+      for (int i = 0; i < n; i++) {
+        if (group[i] == c) {
+          printf("%s%c", first ? "" : ", ", g->labels[i]);
+          first = FALSE;
+        }
+      }
+      printf("}\n");
+    }
+  }
+
+  if (detect_cycle(&directed, &has_cycle) == SUCCESS) {
+    printf("\nDirected Cycle: %s\n", has_cycle ? "Yes" : "No");
+  }
+
+  if (topological_sort(&directed, order, &is_dag) == SUCCESS) {
+    printf("\nTopological Order: ");
+    if (is_dag) {
+      for (int i = 0; i < n; i++) {
+        printf("%c%s", g->labels[order[i]], (i < n - 1) ? " -> " : "");
+      }
+      printf("\n");
+    } else {
+      printf("(not a DAG)\n");
+    }
+  }
+
+  if (tarjan_scc(&directed, group, &count) == SUCCESS) {
+    printf("\nStrongly Connected Components: %d\n", count);
+    for (int c = 0; c < count; c++) {
+      printf("  - #%d: {", c + 1);
+      int first = TRUE;
+      for (int i = 0; i < n; i++) {
+        if (group[i] == c) {
+          printf("%s%c", first ? "" : ", ", g->labels[i]);
+          first = FALSE;
+        }
+      }
+      printf("}\n");
+    }
+  }
+  printf("\n");
+
+  free_csr(&directed);
+  free_csr(&undirected);
+}
+
+void run_analytics_benchmark(void) {
+  int n = 0, m = 0;
+
+  printf("\n=== Graph Analytics Benchmark ===\n");
+  printf("Vertices (default %d): ", DEFAULT_BENCH_VERTICES);
+  if (read_integer(&n) != SUCCESS || n < 2) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_VERTICES);
+    n = DEFAULT_BENCH_VERTICES;
+  }
+  printf("Edges (default %d): ", DEFAULT_BENCH_EDGES);
+  if (read_integer(&m) != SUCCESS || m < 1) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_EDGES);
+    m = DEFAULT_BENCH_EDGES;
+  }
+
+  CsrGraph directed, undirected, dag;
+  printf("\nGenerating graphs (directed, undirected, DAG)...\n");
+  if (generate_random_csr(&directed, n, m, GRAPH_DIRECTED) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  if (generate_random_csr(&undirected, n, m, GRAPH_UNDIRECTED) != SUCCESS) {
+    free_csr(&directed);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  if (generate_random_csr(&dag, n, m, GRAPH_DAG) != SUCCESS) {
+    free_csr(&directed);
+    free_csr(&undirected);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  int *group = (int *)malloc(n * sizeof(int));
+  int *order = (int *)malloc(n * sizeof(int));
+  if (group == NULL || order == NULL) {
+    free(group);
+    free(order);
+    free_csr(&directed);
+    free_csr(&undirected);
+    free_csr(&dag);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  int count = 0, flag = FALSE;
+  double start, elapsed;
+
+  printf("\n  %-22s %-10s %-10s %s\n", "Algorithm", "Time (s)", "MEdges/s",
+         "Result");
+
+  start = get_time_seconds();
+  if (connected_components(&undirected, group, &count) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+    printf("  %-22s %-10.4f %-10.1f %d components (largest %d)\n",
+           "Connected components", elapsed,
+           elapsed > 0 ? undirected.num_edges / elapsed / 1e6 : 0.0, count,
+           largest_group(group, n, count));
+  }
+
+  start = get_time_seconds();
+  if (detect_cycle(&directed, &flag) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+    printf("  %-22s %-10.4f %-10s %s\n", "Cycle check (random)", elapsed,
+           "-", flag ? "cycle found (early exit)" : "acyclic");
+  }
+
+  start = get_time_seconds();
+  if (detect_cycle(&dag, &flag) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+    printf("  %-22s %-10.4f %-10.1f %s\n", "Cycle check (DAG)", elapsed,
+           elapsed > 0 ? dag.num_edges / elapsed / 1e6 : 0.0,
+           flag ? "cycle found" : "acyclic");
+  }
+
+  start = get_time_seconds();
+  if (topological_sort(&dag, order, &flag) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+
+    // Verify: every edge must go forward in the produced order
+    int valid = flag;
+    for (int i = 0; i < n; i++) {
+      group[order[i]] = i;
+    }
+    for (int u = 0; u < n && valid; u++) {
+      for (long long e = dag.offsets[u]; e < dag.offsets[u + 1]; e++) {
+        if (group[u] > group[dag.targets[e]]) {
+          valid = FALSE;
+          break;
+        }
+      }
+    }
+    printf("  %-22s %-10.4f %-10.1f %s\n", "Topological sort (DAG)",
+           elapsed, elapsed > 0 ? dag.num_edges / elapsed / 1e6 : 0.0,
+           valid ? "valid order" : "INVALID");
+  }
+
+  start = get_time_seconds();
+  if (tarjan_scc(&directed, group, &count) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+    printf("  %-22s %-10.4f %-10.1f %d SCCs (largest %d)\n", "Tarjan SCC",
+           elapsed, elapsed > 0 ? directed.num_edges / elapsed / 1e6 : 0.0,
+           count, largest_group(group, n, count));
+  }
+  printf("\n");
+
+  free(group);
+  free(order);
+  free_csr(&directed);
+  free_csr(&undirected);
+  free_csr(&dag);
+}
+
+void run_analyze_graph_file(void) {
+  char path[MAX_PATH_LEN];
+
+  printf("\n=== Analyze Graph File (mmap) ===\n");
+  printf("CSR file (default %s): ", DEFAULT_CSR_FILE);
+  if (read_string(path, MAX_PATH_LEN) != SUCCESS || path[0] == '\0') {
+    strcpy(path, DEFAULT_CSR_FILE);
+  }
+
+  CsrGraph csr;
+  double start = get_time_seconds();
+  Status st = map_csr_file(&csr, path);
+  if (st != SUCCESS) {
+    handle_error(st);
+    return;
+  }
+  printf("\n  - Mapped %d vertices, %lld edges in %.6f s (%s)\n",
+         csr.num_vertices, csr.num_edges, get_time_seconds() - start,
+         (csr.flags & CSR_FLAG_SYMMETRIC) ? "undirected" : "directed");
+
+  int n = csr.num_vertices;
+  int *group = (int *)malloc(n * sizeof(int));
+  int *order = (int *)malloc(n * sizeof(int));
+  if (group == NULL || order == NULL) {
+    free(group);
+    free(order);
+    free_csr(&csr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  int count = 0, flag = FALSE;
+  double elapsed;
+
+  printf("\n  %-22s %-10s %s\n", "Algorithm", "Time (s)", "Result");
+
+  // Components are only meaningful when every edge is stored both ways
+  if (csr.flags & CSR_FLAG_SYMMETRIC) {
+    start = get_time_seconds();
+    if (connected_components(&csr, group, &count) == SUCCESS) {
+      elapsed = get_time_seconds() - start;
+      printf("  %-22s %-10.4f %d components (largest %d)\n",
+             "Connected components", elapsed, count,
+             largest_group(group, n, count));
+    }
+  } else {
+    start = get_time_seconds();
+    if (topological_sort(&csr, order, &flag) == SUCCESS) {
+      elapsed = get_time_seconds() - start;
+      printf("  %-22s %-10.4f %s\n", "Topological sort", elapsed,
+             flag ? "DAG (order computed)" : "cyclic, no order");
+    }
+  }
+
+  start = get_time_seconds();
+  if (tarjan_scc(&csr, group, &count) == SUCCESS) {
+    elapsed = get_time_seconds() - start;
+    printf("  %-22s %-10.4f %d SCCs (largest %d)\n", "Tarjan SCC", elapsed,
+           count, largest_group(group, n, count));
+  }
+  printf("\n");
+
+  free(group);
+  free(order);
+  free_csr(&csr);
+}
+
 void clear_input_buffer(void) {
   int c;
   while ((c = getchar()) != '\n' && c != EOF) {
@@ -342,6 +750,19 @@ Status read_char(char *value) {
   return SUCCESS;
 }
 
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  } else if (len == (size_t)(max_len - 1)) {
+    clear_input_buffer();
+  }
+  return SUCCESS;
+}
+
 void init_graph(Graph *g) {
   g->num_vertices = 0;
   for (int i = 0; i < MAX_VERTICES; i++) {
@@ -414,19 +835,25 @@ void init_stack(Stack *s) {
   s->top = -1;
 }
 
-void push(Stack *s, int value) {
-  if (s->top < MAX_STACK - 1) {
-    s->items[++s->top] = value;
+void push(Stack *s, int vertex, AdjNode *edges) {
+  if (s->top < MAX_VERTICES - 1) {
+    s->top++;
+    s->items[s->top].vertex = vertex;
+    s->items[s->top].next_edge = edges;
   }
 }
 
 int pop(Stack *s) {
   if (s->top >= 0) {
-    return s->items[s->top--];
+    return s->items[s->top--].vertex;
   }
   return -1;
 }
 
+StackFrame *peek(Stack *s) {
+  return (s->top >= 0) ? &s->items[s->top] : NULL;
+}
+
 int is_empty(Stack *s) {
   return s->top == -1;
 }
@@ -434,7 +861,482 @@ int is_empty(Stack *s) {
 void print_stack(Stack *s, Graph *g) {
   printf("  > Stack: [");
   for (int i = 0; i <= s->top; i++) {
-    printf("%c%s", g->labels[s->items[i]], (i < s->top) ? ", " : "");
+    printf("%c%s", g->labels[s->items[i].vertex], (i < s->top) ? ", " : "");
   }
   printf("]\n");
 }
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+unsigned long long next_random(unsigned long long *state) {
+  // xorshift64*: reproducible, so the CSR can be built in two passes
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+Status build_csr_from_graph(const Graph *g, CsrGraph *csr, int undirected) {
+  int n = g->num_vertices;
+  long long edges = 0;
+
+  for (int u = 0; u < n; u++) {
+    for (AdjNode *t = g->head[u]; t; t = t->next) {
+      edges += undirected ? 2 : 1;
+    }
+  }
+
+  csr->num_vertices = n;
+  csr->num_edges = edges;
+  csr->flags = undirected ? CSR_FLAG_SYMMETRIC : 0;
+  csr->mapping = NULL;
+  csr->mapping_size = 0;
+  csr->offsets = (long long *)calloc(n + 1, sizeof(long long));
+  csr->targets = (int *)malloc((edges > 0 ? edges : 1) * sizeof(int));
+  if (csr->offsets == NULL || csr->targets == NULL) {
+    free_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int u = 0; u < n; u++) {
+    for (AdjNode *t = g->head[u]; t; t = t->next) {
+      csr->offsets[u + 1]++;
+      if (undirected)
+        csr->offsets[t->vertex_idx + 1]++;
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    csr->offsets[i + 1] += csr->offsets[i];
+  }
+
+  long long cursor[MAX_VERTICES];
+  memcpy(cursor, csr->offsets, n * sizeof(long long));
+  for (int u = 0; u < n; u++) {
+    for (AdjNode *t = g->head[u]; t; t = t->next) {
+      csr->targets[cursor[u]++] = t->vertex_idx;
+      if (undirected)
+        csr->targets[cursor[t->vertex_idx]++] = u;
+    }
+  }
+
+  return SUCCESS;
+}
+
+Status generate_random_csr(CsrGraph *csr, int n, long long m, GraphKind kind) {
+  unsigned long long seed = (unsigned long long)time(NULL) * 2 + 1 + kind;
+  unsigned long long state;
+
+  csr->num_vertices = n;
+  csr->flags = (kind == GRAPH_UNDIRECTED) ? CSR_FLAG_SYMMETRIC : 0;
+  csr->mapping = NULL;
+  csr->mapping_size = 0;
+  csr->targets = NULL;
+  csr->offsets = (long long *)calloc(n + 1, sizeof(long long));
+  if (csr->offsets == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Pass 1: count out-degrees; the DAG orients every edge low -> high id
+  state = seed;
+  for (long long e = 0; e < m; e++) {
+    int u = (int)(next_random(&state) % n);
+    int v = (int)(next_random(&state) % n);
+    if (kind == GRAPH_DAG) {
+      if (u == v)
+        continue;
+      if (u > v) {
+        int tmp = u;
+        u = v;
+        v = tmp;
+      }
+    }
+    csr->offsets[u + 1]++;
+    if (kind == GRAPH_UNDIRECTED)
+      csr->offsets[v + 1]++;
+  }
+  for (int i = 0; i < n; i++) {
+    csr->offsets[i + 1] += csr->offsets[i];
+  }
+  csr->num_edges = csr->offsets[n];
+
+  long long *cursor = (long long *)malloc(n * sizeof(long long));
+  csr->targets = (int *)malloc((csr->num_edges + 1) * sizeof(int));
+  if (cursor == NULL || csr->targets == NULL) {
+    free(cursor);
+    free_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  memcpy(cursor, csr->offsets, n * sizeof(long long));
+
+  // Pass 2: replay the same sequence and scatter targets
+  state = seed;
+  for (long long e = 0; e < m; e++) {
+    int u = (int)(next_random(&state) % n);
+    int v = (int)(next_random(&state) % n);
+    if (kind == GRAPH_DAG) {
+      if (u == v)
+        continue;
+      if (u > v) {
+        int tmp = u;
+        u = v;
+        v = tmp;
+      }
+    }
+    csr->targets[cursor[u]++] = v;
+    if (kind == GRAPH_UNDIRECTED)
+      csr->targets[cursor[v]++] = u;
+  }
+
+  free(cursor);
+  return SUCCESS;
+}
+
+void free_csr(CsrGraph *csr) {
+  if (csr->mapping != NULL) {
+    munmap(csr->mapping, csr->mapping_size);
+    csr->mapping = NULL;
+    csr->mapping_size = 0;
+  } else {
+    free(csr->offsets);
+    free(csr->targets);
+  }
+  csr->offsets = NULL;
+  csr->targets = NULL;
+  csr->num_vertices = 0;
+  csr->num_edges = 0;
+}
+
+Status map_csr_file(CsrGraph *csr, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(CsrFileHeader)) {
+    close(fd);
+    return ERR_INVALID_FORMAT;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps its own reference to the file
+  if (map == MAP_FAILED) {
+    return ERR_FILE_IO;
+  }
+
+  const CsrFileHeader *header = (const CsrFileHeader *)map;
+  if (memcmp(header->magic, CSR_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != CSR_VERSION || header->num_vertices < 1 ||
+      header->num_vertices > 0x7fffffffLL || header->num_edges < 0 ||
+      header->num_edges > (long long)size) {
+    munmap(map, size);
+    return ERR_INVALID_FORMAT;
+  }
+
+  size_t expected = sizeof(CsrFileHeader) +
+                    (size_t)(header->num_vertices + 1) * sizeof(long long) +
+                    (size_t)header->num_edges * sizeof(int);
+  if (expected != size) {
+    munmap(map, size);
+    return ERR_INVALID_FORMAT;
+  }
+
+  csr->mapping = map;
+  csr->mapping_size = size;
+  csr->flags = header->flags;
+  csr->num_vertices = (int)header->num_vertices;
+  csr->num_edges = header->num_edges;
+  csr->offsets = (long long *)((char *)map + sizeof(CsrFileHeader));
+  csr->targets = (int *)(csr->offsets + csr->num_vertices + 1);
+
+  if (csr->offsets[csr->num_vertices] != csr->num_edges ||
+      validate_csr(csr) != SUCCESS) {
+    free_csr(csr);
+    return ERR_INVALID_FORMAT;
+  }
+
+  // DFS jumps around the targets array, so ask for read-ahead up front
+  posix_madvise(map, size, POSIX_MADV_WILLNEED);
+  return SUCCESS;
+}
+
+// One O(V + E) pass so a corrupt file cannot send a traversal out of bounds
+Status validate_csr(const CsrGraph *csr) {
+  const long long *offsets = csr->offsets;
+
+  if (offsets[0] != 0) {
+    return ERR_INVALID_FORMAT;
+  }
+  for (int i = 0; i < csr->num_vertices; i++) {
+    if (offsets[i + 1] < offsets[i] || offsets[i + 1] > csr->num_edges) {
+      return ERR_INVALID_FORMAT;
+    }
+  }
+  for (long long e = 0; e < csr->num_edges; e++) {
+    if (csr->targets[e] < 0 || csr->targets[e] >= csr->num_vertices) {
+      return ERR_INVALID_FORMAT;
+    }
+  }
+  return SUCCESS;
+}
+
+Status dfs_engine_init(DfsEngine *e, const CsrGraph *csr) {
+  e->csr = csr;
+  e->top = 0;
+  e->capacity = INITIAL_FRAMES;
+  e->stopped = FALSE;
+  e->color = (unsigned char *)calloc(csr->num_vertices, 1);
+  e->frames = (DfsFrame *)malloc(e->capacity * sizeof(DfsFrame));
+  if (e->color == NULL || e->frames == NULL) {
+    dfs_engine_free(e);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  return SUCCESS;
+}
+
+Status dfs_engine_run(DfsEngine *e, int root, const DfsVisitor *vis,
+                      void *ctx) {
+  const CsrGraph *csr = e->csr;
+
+  if (e->color[root] != WHITE) {
+    return SUCCESS;
+  }
+
+  e->color[root] = GRAY;
+  if (vis->on_discover)
+    vis->on_discover(root, ctx);
+  e->frames[0].vertex = root;
+  e->frames[0].next_edge = csr->offsets[root];
+  e->top = 1;
+
+  while (e->top > 0) {
+    DfsFrame *frame = &e->frames[e->top - 1];
+    int u = frame->vertex;
+
+    if (frame->next_edge == csr->offsets[u + 1]) {
+      // All edges explored: finish u and hand control back to its parent
+      e->color[u] = BLACK;
+      e->top--;
+      if (vis->on_finish)
+        vis->on_finish(u, e->top > 0 ? e->frames[e->top - 1].vertex : -1, ctx);
+      continue;
+    }
+
+    int v = csr->targets[frame->next_edge++];
+    if (vis->on_edge && !vis->on_edge(u, v, (Color)e->color[v], ctx)) {
+      e->stopped = TRUE;
+      e->top = 0;
+      return SUCCESS;
+    }
+    if (e->color[v] != WHITE)
+      continue;
+
+    if (e->top == e->capacity) {
+      int new_cap = e->capacity * 2;
+      DfsFrame *new_frames =
+          (DfsFrame *)realloc(e->frames, new_cap * sizeof(DfsFrame));
+      if (new_frames == NULL) {
+        return ERR_MEMORY_ALLOCATION;
+      }
+      e->frames = new_frames;
+      e->capacity = new_cap;
+    }
+
+    e->color[v] = GRAY;
+    if (vis->on_discover)
+      vis->on_discover(v, ctx);
+    e->frames[e->top].vertex = v;
+    e->frames[e->top].next_edge = csr->offsets[v];
+    e->top++;
+  }
+
+  return SUCCESS;
+}
+
+void dfs_engine_free(DfsEngine *e) {
+  free(e->color);
+  free(e->frames);
+  e->color = NULL;
+  e->frames = NULL;
+  e->top = 0;
+  e->capacity = 0;
+}
+
+Status connected_components(const CsrGraph *csr, int *component, int *count) {
+  DfsEngine e;
+  DfsVisitor vis = {component_discover, NULL, NULL};
+  ComponentCtx ctx = {component, 0};
+  Status st = dfs_engine_init(&e, csr);
+  if (st != SUCCESS) {
+    return st;
+  }
+
+  for (int v = 0; v < csr->num_vertices && st == SUCCESS; v++) {
+    if (e.color[v] == WHITE) {
+      st = dfs_engine_run(&e, v, &vis, &ctx);
+      ctx.current++;
+    }
+  }
+
+  *count = ctx.current;
+  dfs_engine_free(&e);
+  return st;
+}
+
+Status detect_cycle(const CsrGraph *csr, int *has_cycle) {
+  DfsEngine e;
+  DfsVisitor vis = {NULL, topo_edge, NULL};
+  TopoCtx ctx = {NULL, 0, FALSE};
+  Status st = dfs_engine_init(&e, csr);
+  if (st != SUCCESS) {
+    return st;
+  }
+
+  for (int v = 0; v < csr->num_vertices && st == SUCCESS && !e.stopped; v++) {
+    st = dfs_engine_run(&e, v, &vis, &ctx);
+  }
+
+  *has_cycle = ctx.cycle_found;
+  dfs_engine_free(&e);
+  return st;
+}
+
+Status topological_sort(const CsrGraph *csr, int *order, int *is_dag) {
+  DfsEngine e;
+  DfsVisitor vis = {NULL, topo_edge, topo_finish};
+  TopoCtx ctx = {order, 0, FALSE};
+  Status st = dfs_engine_init(&e, csr);
+  if (st != SUCCESS) {
+    return st;
+  }
+
+  for (int v = 0; v < csr->num_vertices && st == SUCCESS && !e.stopped; v++) {
+    st = dfs_engine_run(&e, v, &vis, &ctx);
+  }
+
+  // Finish order reversed is a valid topological order
+  for (int i = 0, j = ctx.count - 1; i < j; i++, j--) {
+    int tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+
+  *is_dag = !ctx.cycle_found;
+  dfs_engine_free(&e);
+  return st;
+}
+
+Status tarjan_scc(const CsrGraph *csr, int *component, int *count) {
+  int n = csr->num_vertices;
+  DfsEngine e;
+  DfsVisitor vis = {tarjan_discover, tarjan_edge, tarjan_finish};
+  TarjanCtx ctx;
+
+  ctx.index = (int *)malloc(n * sizeof(int));
+  ctx.low = (int *)malloc(n * sizeof(int));
+  ctx.stack = (int *)malloc(n * sizeof(int));
+  ctx.on_stack = (unsigned char *)calloc(n, 1);
+  ctx.component = component;
+  ctx.stack_top = 0;
+  ctx.next_index = 0;
+  ctx.count = 0;
+
+  Status st = ERR_MEMORY_ALLOCATION;
+  if (ctx.index && ctx.low && ctx.stack && ctx.on_stack) {
+    st = dfs_engine_init(&e, csr);
+  }
+
+  if (st == SUCCESS) {
+    for (int v = 0; v < n && st == SUCCESS; v++) {
+      st = dfs_engine_run(&e, v, &vis, &ctx);
+    }
+    dfs_engine_free(&e);
+  }
+
+  *count = ctx.count;
+  free(ctx.index);
+  free(ctx.low);
+  free(ctx.stack);
+  free(ctx.on_stack);
+  return st;
+}
+
+void component_discover(int v, void *ctx) {
+  ComponentCtx *c = (ComponentCtx *)ctx;
+  c->component[v] = c->current;
+}
+
+int topo_edge(int u, int v, Color color, void *ctx) {
+  (void)u;
+  (void)v;
+  // A GRAY target is still on the DFS path: back edge, so a cycle
+  if (color == GRAY) {
+    ((TopoCtx *)ctx)->cycle_found = TRUE;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void topo_finish(int v, int parent, void *ctx) {
+  TopoCtx *t = (TopoCtx *)ctx;
+  (void)parent;
+  t->order[t->count++] = v;
+}
+
+void tarjan_discover(int v, void *ctx) {
+  TarjanCtx *t = (TarjanCtx *)ctx;
+  t->index[v] = t->next_index;
+  t->low[v] = t->next_index;
+  t->next_index++;
+  t->stack[t->stack_top++] = v;
+  t->on_stack[v] = TRUE;
+}
+
+int tarjan_edge(int u, int v, Color color, void *ctx) {
+  TarjanCtx *t = (TarjanCtx *)ctx;
+  (void)color;
+  if (t->on_stack[v] && t->index[v] < t->low[u]) {
+    t->low[u] = t->index[v];
+  }
+  return TRUE;
+}
+
+void tarjan_finish(int v, int parent, void *ctx) {
+  TarjanCtx *t = (TarjanCtx *)ctx;
+
+  if (t->low[v] == t->index[v]) {
+    int w;
+    do {
+      w = t->stack[--t->stack_top];
+      t->on_stack[w] = FALSE;
+      t->component[w] = t->count;
+    } while (w != v);
+    t->count++;
+  }
+
+  if (parent != -1 && t->low[v] < t->low[parent]) {
+    t->low[parent] = t->low[v];
+  }
+}
+
+int largest_group(const int *group, int n, int count) {
+  int *sizes = (int *)calloc(count > 0 ? count : 1, sizeof(int));
+  int best = 0;
+  if (sizes == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    sizes[group[i]]++;
+  }
+  for (int c = 0; c < count; c++) {
+    if (sizes[c] > best)
+      best = sizes[c];
+  }
+  free(sizes);
+  return best;
+}
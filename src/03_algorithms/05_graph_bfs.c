@@ -10,20 +10,43 @@
  - Level-by-level BFS execution log
  - Shortest path reconstruction using a parent tracking array
  - Dynamic graph construction
+ - Level-synchronous parallel BFS (pthreads) over a generated CSR graph
+ - Thread scaling benchmark with result validation against serial BFS
+ - Edge-list text importer writing a binary CSR graph file
+ - Zero-parse loading of binary CSR files through mmap
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #define TRUE 1
 #define FALSE 0
 #define MAX_VERTICES 26
 #define MAX_QUEUE 100
 #define MIN_OPTION 1
-#define MAX_OPTION 5
+#define MAX_OPTION 9
+#define MAX_PATH_LEN 256
+#define SCAN_BUFFER_SIZE (1 << 20)
+#define CSR_MAGIC "CSRGRAPH"
+#define CSR_VERSION 1
+#define CSR_FLAG_SYMMETRIC 1u
+#define DEFAULT_CSR_FILE "graph.csr"
+#define DEFAULT_EDGE_FILE "edges.txt"
+#define MAX_THREADS 64
+#define BFS_CHUNK_SIZE 64
+#define DEFAULT_BENCH_VERTICES 1000000
+#define DEFAULT_BENCH_DEGREE 8
 
 typedef enum {
   SUCCESS,
@@ -32,7 +55,11 @@ typedef enum {
   ERR_FULL,
   ERR_NOT_FOUND,
   ERR_ALREADY_EXISTS,
-  ERR_MEMORY_ALLOCATION
+  ERR_MEMORY_ALLOCATION,
+  ERR_THREAD_CREATION,
+  ERR_FILE_NOT_FOUND,
+  ERR_FILE_IO,
+  ERR_INVALID_FORMAT
 } Status;
 
 typedef struct AdjNode {
@@ -53,16 +80,80 @@ typedef struct {
   int size;
 } Queue;
 
+typedef struct {
+  int num_vertices;
+  long long num_edges;
+  long long *offsets;
+  int *targets;
+  unsigned int flags;
+  void *mapping;
+  size_t mapping_size;
+} CsrGraph;
+
+/*
+ * On-disk CSR layout (native endianness, 8-byte aligned sections):
+ * [header 32 B][offsets: (V + 1) x int64][targets: E x int32]
+ */
+typedef struct {
+  char magic[8];
+  unsigned int version;
+  unsigned int flags;
+  long long num_vertices;
+  long long num_edges;
+} CsrFileHeader;
+
+typedef struct {
+  FILE *file;
+  char *buffer;
+  size_t length;
+  size_t pos;
+} TextScanner;
+
+typedef struct {
+  const CsrGraph *csr;
+  int *level;
+  unsigned long long *visited;
+  int *frontier;
+  int *next_frontier;
+  int frontier_size;
+  int next_size;
+  int next_chunk;
+  int current_level;
+  int num_threads;
+  int *local_counts;
+  int *local_offsets;
+  int aborted;
+  Status status;
+  pthread_mutex_t start_lock;
+  pthread_barrier_t barrier;
+} ParallelBfs;
+
+typedef struct {
+  ParallelBfs *bfs;
+  int id;
+  int *local;
+  int local_count;
+  int local_capacity;
+} BfsWorker;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_load_demo(Graph *g);
 void run_custom_graph(Graph *g);
 void run_show_graph(Graph *g);
 void run_execute_bfs(Graph *g);
+void run_parallel_bfs_benchmark(void);
+void run_import_edge_list(void);
+void run_generate_graph_file(void);
+void run_bfs_on_graph_file(void);
+void run_bfs_scaling(const CsrGraph *csr, int max_threads);
+int read_max_threads(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_char(char *value);
+Status read_string(char *buffer, int max_len);
+void read_path(const char *prompt, const char *fallback, char *path);
 
 void init_graph(Graph *g);
 Status add_vertex(Graph *g, char label);
@@ -75,6 +166,26 @@ int dequeue(Queue *q);
 int is_empty(Queue *q);
 void print_queue(Queue *q, Graph *g);
 
+double get_time_seconds(void);
+unsigned long long next_random(unsigned long long *state);
+Status generate_random_csr(CsrGraph *csr, int n, int degree);
+void free_csr(CsrGraph *csr);
+Status serial_bfs_csr(const CsrGraph *csr, int source, int *level,
+                      long long *edges_traversed);
+Status parallel_bfs_csr(const CsrGraph *csr, int source, int num_threads,
+                        int *level);
+void *bfs_worker(void *arg);
+int claim_vertex(unsigned long long *visited, int v);
+Status push_local(BfsWorker *w, int v);
+
+Status save_csr_file(const CsrGraph *csr, const char *path);
+Status map_csr_file(CsrGraph *csr, const char *path);
+Status validate_csr(const CsrGraph *csr);
+Status import_edge_list(const char *text_path, const char *csr_path,
+                        int undirected, CsrFileHeader *info);
+int scanner_peek(TextScanner *sc);
+int scan_edge(TextScanner *sc, long long *u, long long *v);
+
 int main(void) {
   int option = 0;
   Graph g;
@@ -113,6 +224,18 @@ int main(void) {
     case 4:
       run_execute_bfs(&g);
       break;
+    case 5:
+      run_parallel_bfs_benchmark();
+      break;
+    case 6:
+      run_import_edge_list();
+      break;
+    case 7:
+      run_generate_graph_file();
+      break;
+    case 8:
+      run_bfs_on_graph_file();
+      break;
     }
   }
 
@@ -122,7 +245,11 @@ int main(void) {
 void show_menu(void) {
   printf("=== Breadth-First Search (BFS) Visualizer ===\n\n");
   printf("1. Load Demo Graph (A-F Tree)\n2. Create Custom Graph\n"
-         "3. Show Graph Structure\n4. Run BFS Visualization\n5. Exit\n");
+         "3. Show Graph Structure\n4. Run BFS Visualization\n"
+         "5. Parallel BFS Scaling Benchmark\n"
+         "6. Import Edge List (Text -> Binary CSR)\n"
+         "7. Generate Random Graph File (Binary CSR)\n"
+         "8. Run BFS on Graph File (mmap)\n9. Exit\n");
   printf("Option: ");
 }
 
@@ -146,6 +273,18 @@ void handle_error(Status status) {
   case ERR_MEMORY_ALLOCATION:
     printf("Error: Memory allocation failed.\n\n");
     break;
+  case ERR_THREAD_CREATION:
+    printf("Error: Thread creation failed.\n\n");
+    break;
+  case ERR_FILE_NOT_FOUND:
+    printf("Error: File not found.\n\n");
+    break;
+  case ERR_FILE_IO:
+    printf("Error: File read/write failed.\n\n");
+    break;
+  case ERR_INVALID_FORMAT:
+    printf("Error: Invalid or corrupted graph file.\n\n");
+    break;
   case SUCCESS:
     break;
   }
@@ -366,6 +505,199 @@ void run_execute_bfs(Graph *g) {
   printf("\n");
 }
 
+void run_parallel_bfs_benchmark(void) {
+  int n = 0, degree = 0;
+
+  printf("\n=== Parallel BFS Scaling Benchmark ===\n");
+  printf("Vertices (default %d): ", DEFAULT_BENCH_VERTICES);
+  if (read_integer(&n) != SUCCESS || n < 2) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_VERTICES);
+    n = DEFAULT_BENCH_VERTICES;
+  }
+
+  printf("Average degree (default %d): ", DEFAULT_BENCH_DEGREE);
+  if (read_integer(&degree) != SUCCESS || degree < 1 ||
+      (long long)n * degree > 0x7fffffffLL) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_DEGREE);
+    degree = DEFAULT_BENCH_DEGREE;
+  }
+
+  int max_threads = read_max_threads();
+
+  CsrGraph csr;
+  printf("\nGenerating random graph (%d vertices, ~%lld edges)...\n", n,
+         (long long)n * degree);
+  double start = get_time_seconds();
+  if (generate_random_csr(&csr, n, degree) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  printf("  - Built CSR in %.3f s\n", get_time_seconds() - start);
+
+  run_bfs_scaling(&csr, max_threads);
+  free_csr(&csr);
+}
+
+void run_import_edge_list(void) {
+  char text_path[MAX_PATH_LEN], csr_path[MAX_PATH_LEN];
+  char answer = 'n';
+  CsrFileHeader info;
+
+  printf("\n=== Import Edge List ===\n");
+  printf("Format: one \"src dst\" pair of non-negative ids per line;\n"
+         "lines starting with '#' or '%%' are comments.\n\n");
+  read_path("Edge list file", DEFAULT_EDGE_FILE, text_path);
+  read_path("Output CSR file", DEFAULT_CSR_FILE, csr_path);
+  printf("Treat edges as undirected? (y/n): ");
+  if (read_char(&answer) != SUCCESS) {
+    answer = 'n';
+  }
+
+  double start = get_time_seconds();
+  Status st = import_edge_list(text_path, csr_path,
+                               tolower(answer) == 'y', &info);
+  if (st != SUCCESS) {
+    handle_error(st);
+    return;
+  }
+
+  printf("\n  - Imported %lld vertices, %lld edges in %.3f s\n",
+         info.num_vertices, info.num_edges, get_time_seconds() - start);
+  printf("  - Written: %s\n\n", csr_path);
+}
+
+void run_generate_graph_file(void) {
+  int n = 0, degree = 0;
+  char path[MAX_PATH_LEN];
+
+  printf("\n=== Generate Random Graph File ===\n");
+  printf("Vertices (default %d): ", DEFAULT_BENCH_VERTICES);
+  if (read_integer(&n) != SUCCESS || n < 2) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_VERTICES);
+    n = DEFAULT_BENCH_VERTICES;
+  }
+  printf("Average degree (default %d): ", DEFAULT_BENCH_DEGREE);
+  if (read_integer(&degree) != SUCCESS || degree < 1 ||
+      (long long)n * degree > 0x7fffffffLL) {
+    printf("  - Using default (%d).\n", DEFAULT_BENCH_DEGREE);
+    degree = DEFAULT_BENCH_DEGREE;
+  }
+  read_path("Output CSR file", DEFAULT_CSR_FILE, path);
+
+  CsrGraph csr;
+  if (generate_random_csr(&csr, n, degree) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  double start = get_time_seconds();
+  Status st = save_csr_file(&csr, path);
+  if (st != SUCCESS) {
+    handle_error(st);
+  } else {
+    printf("\n  - Saved %d vertices, %lld edges to %s in %.3f s\n\n",
+           csr.num_vertices, csr.num_edges, path, get_time_seconds() - start);
+  }
+  free_csr(&csr);
+}
+
+void run_bfs_on_graph_file(void) {
+  char path[MAX_PATH_LEN];
+
+  printf("\n=== BFS on Graph File (mmap) ===\n");
+  read_path("CSR file", DEFAULT_CSR_FILE, path);
+  int max_threads = read_max_threads();
+
+  CsrGraph csr;
+  double start = get_time_seconds();
+  Status st = map_csr_file(&csr, path);
+  if (st != SUCCESS) {
+    handle_error(st);
+    return;
+  }
+  printf("\n  - Mapped %d vertices, %lld edges (%.1f MB) in %.6f s\n",
+         csr.num_vertices, csr.num_edges, csr.mapping_size / 1048576.0,
+         get_time_seconds() - start);
+  printf("  - Pages are faulted in on first touch by the traversal.\n");
+
+  run_bfs_scaling(&csr, max_threads);
+  free_csr(&csr);
+}
+
+void run_bfs_scaling(const CsrGraph *csr, int max_threads) {
+  int n = csr->num_vertices;
+  int *serial_level = (int *)malloc(n * sizeof(int));
+  int *level = (int *)malloc(n * sizeof(int));
+  if (serial_level == NULL || level == NULL) {
+    free(serial_level);
+    free(level);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  long long edges_traversed = 0;
+  double start = get_time_seconds();
+  Status st = serial_bfs_csr(csr, 0, serial_level, &edges_traversed);
+  double serial_time = get_time_seconds() - start;
+  if (st != SUCCESS) {
+    handle_error(st);
+    free(serial_level);
+    free(level);
+    return;
+  }
+
+  int reached = 0, depth = 0;
+  for (int i = 0; i < n; i++) {
+    if (serial_level[i] != -1) {
+      reached++;
+      if (serial_level[i] > depth)
+        depth = serial_level[i];
+    }
+  }
+
+  printf("  - Serial BFS: %.4f s (%d reached, depth %d)\n\n", serial_time,
+         reached, depth);
+  printf("  %-8s %-12s %-10s %-9s %s\n", "Threads", "Time (s)", "MTEPS",
+         "Speedup", "Check");
+
+  for (int threads = 1; threads <= max_threads;) {
+    start = get_time_seconds();
+    st = parallel_bfs_csr(csr, 0, threads, level);
+    double elapsed = get_time_seconds() - start;
+    if (st != SUCCESS) {
+      handle_error(st);
+      break;
+    }
+
+    int ok = memcmp(level, serial_level, n * sizeof(int)) == 0;
+    printf("  %-8d %-12.4f %-10.1f %-9.2f %s\n", threads, elapsed,
+           elapsed > 0 ? edges_traversed / elapsed / 1e6 : 0.0,
+           elapsed > 0 ? serial_time / elapsed : 0.0, ok ? "OK" : "MISMATCH");
+
+    if (threads == max_threads)
+      break;
+    threads = (threads * 2 > max_threads) ? max_threads : threads * 2;
+  }
+  printf("\n");
+
+  free(serial_level);
+  free(level);
+}
+
+int read_max_threads(void) {
+  int max_threads = 0;
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+  printf("Max threads (default %ld): ", online > 0 ? online : 1);
+  if (read_integer(&max_threads) != SUCCESS || max_threads < 1) {
+    max_threads = online > 0 ? (int)online : 1;
+  }
+  if (max_threads > MAX_THREADS) {
+    max_threads = MAX_THREADS;
+  }
+  return max_threads;
+}
+
 void clear_input_buffer(void) {
   int c;
   while ((c = getchar()) != '\n' && c != EOF) {
@@ -391,6 +723,26 @@ Status read_char(char *value) {
   return SUCCESS;
 }
 
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  } else if (len == (size_t)(max_len - 1)) {
+    clear_input_buffer();
+  }
+  return SUCCESS;
+}
+
+void read_path(const char *prompt, const char *fallback, char *path) {
+  printf("%s (default %s): ", prompt, fallback);
+  if (read_string(path, MAX_PATH_LEN) != SUCCESS || path[0] == '\0') {
+    strcpy(path, fallback);
+  }
+}
+
 void init_graph(Graph *g) {
   g->num_vertices = 0;
   for (int i = 0; i < MAX_VERTICES; i++) {
@@ -494,3 +846,600 @@ void print_queue(Queue *q, Graph *g) {
   }
   printf("]\n");
 }
+
+double get_time_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+unsigned long long next_random(unsigned long long *state) {
+  // xorshift64*: reproducible, so the CSR can be built in two passes
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+Status generate_random_csr(CsrGraph *csr, int n, int degree) {
+  long long pairs = (long long)n * degree / 2;
+  unsigned long long seed = (unsigned long long)time(NULL) | 1;
+  unsigned long long state;
+
+  csr->num_vertices = n;
+  csr->num_edges = pairs * 2;
+  csr->flags = CSR_FLAG_SYMMETRIC;
+  csr->mapping = NULL;
+  csr->mapping_size = 0;
+  csr->offsets = (long long *)calloc(n + 1, sizeof(long long));
+  csr->targets = (int *)malloc(csr->num_edges * sizeof(int));
+  if (csr->offsets == NULL || csr->targets == NULL) {
+    free_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Pass 1: count degrees (undirected, so both endpoints)
+  state = seed;
+  for (long long e = 0; e < pairs; e++) {
+    int u = (int)(next_random(&state) % n);
+    int v = (int)(next_random(&state) % n);
+    csr->offsets[u + 1]++;
+    csr->offsets[v + 1]++;
+  }
+  for (int i = 0; i < n; i++) {
+    csr->offsets[i + 1] += csr->offsets[i];
+  }
+
+  long long *cursor = (long long *)malloc(n * sizeof(long long));
+  if (cursor == NULL) {
+    free_csr(csr);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  memcpy(cursor, csr->offsets, n * sizeof(long long));
+
+  // Pass 2: replay the same sequence and scatter targets
+  state = seed;
+  for (long long e = 0; e < pairs; e++) {
+    int u = (int)(next_random(&state) % n);
+    int v = (int)(next_random(&state) % n);
+    csr->targets[cursor[u]++] = v;
+    csr->targets[cursor[v]++] = u;
+  }
+
+  free(cursor);
+  return SUCCESS;
+}
+
+void free_csr(CsrGraph *csr) {
+  if (csr->mapping != NULL) {
+    munmap(csr->mapping, csr->mapping_size);
+    csr->mapping = NULL;
+    csr->mapping_size = 0;
+  } else {
+    free(csr->offsets);
+    free(csr->targets);
+  }
+  csr->offsets = NULL;
+  csr->targets = NULL;
+  csr->num_vertices = 0;
+  csr->num_edges = 0;
+}
+
+Status serial_bfs_csr(const CsrGraph *csr, int source, int *level,
+                      long long *edges_traversed) {
+  int *queue = (int *)malloc(csr->num_vertices * sizeof(int));
+  if (queue == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < csr->num_vertices; i++) {
+    level[i] = -1;
+  }
+
+  int head = 0, tail = 0;
+  long long edges = 0;
+  level[source] = 0;
+  queue[tail++] = source;
+
+  while (head < tail) {
+    int u = queue[head++];
+    for (long long e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+      int v = csr->targets[e];
+      if (level[v] == -1) {
+        level[v] = level[u] + 1;
+        queue[tail++] = v;
+      }
+    }
+    edges += csr->offsets[u + 1] - csr->offsets[u];
+  }
+
+  *edges_traversed = edges;
+  free(queue);
+  return SUCCESS;
+}
+
+Status parallel_bfs_csr(const CsrGraph *csr, int source, int num_threads,
+                        int *level) {
+  int n = csr->num_vertices;
+  pthread_t threads[MAX_THREADS];
+  BfsWorker workers[MAX_THREADS];
+  ParallelBfs bfs;
+
+  bfs.csr = csr;
+  bfs.level = level;
+  bfs.num_threads = num_threads;
+  bfs.visited = (unsigned long long *)calloc((n + 63) / 64,
+                                             sizeof(unsigned long long));
+  bfs.frontier = (int *)malloc(n * sizeof(int));
+  bfs.next_frontier = (int *)malloc(n * sizeof(int));
+  bfs.local_counts = (int *)calloc(num_threads, sizeof(int));
+  bfs.local_offsets = (int *)calloc(num_threads, sizeof(int));
+
+  if (bfs.visited == NULL || bfs.frontier == NULL ||
+      bfs.next_frontier == NULL || bfs.local_counts == NULL ||
+      bfs.local_offsets == NULL) {
+    free(bfs.visited);
+    free(bfs.frontier);
+    free(bfs.next_frontier);
+    free(bfs.local_counts);
+    free(bfs.local_offsets);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  for (int i = 0; i < n; i++) {
+    level[i] = -1;
+  }
+  level[source] = 0;
+  claim_vertex(bfs.visited, source);
+  bfs.frontier[0] = source;
+  bfs.frontier_size = 1;
+  bfs.next_size = 0;
+  bfs.next_chunk = 0;
+  bfs.current_level = 0;
+  bfs.aborted = FALSE;
+  bfs.status = SUCCESS;
+
+  // Workers block on start_lock until every thread exists, so a failed
+  // pthread_create never leaves the others stuck on the barrier.
+  pthread_mutex_init(&bfs.start_lock, NULL);
+  pthread_mutex_lock(&bfs.start_lock);
+
+  int created = 0;
+  for (; created < num_threads; created++) {
+    workers[created].bfs = &bfs;
+    workers[created].id = created;
+    workers[created].local = NULL;
+    workers[created].local_count = 0;
+    workers[created].local_capacity = 0;
+    if (pthread_create(&threads[created], NULL, bfs_worker,
+                       &workers[created]) != 0) {
+      bfs.aborted = TRUE;
+      bfs.status = ERR_THREAD_CREATION;
+      break;
+    }
+  }
+
+  if (!bfs.aborted) {
+    pthread_barrier_init(&bfs.barrier, NULL, num_threads);
+  }
+  pthread_mutex_unlock(&bfs.start_lock);
+
+  for (int t = 0; t < created; t++) {
+    pthread_join(threads[t], NULL);
+    free(workers[t].local);
+  }
+
+  if (!bfs.aborted) {
+    pthread_barrier_destroy(&bfs.barrier);
+  }
+  pthread_mutex_destroy(&bfs.start_lock);
+
+  free(bfs.visited);
+  free(bfs.frontier);
+  free(bfs.next_frontier);
+  free(bfs.local_counts);
+  free(bfs.local_offsets);
+  return bfs.status;
+}
+
+void *bfs_worker(void *arg) {
+  BfsWorker *w = (BfsWorker *)arg;
+  ParallelBfs *bfs = w->bfs;
+  const CsrGraph *csr = bfs->csr;
+
+  pthread_mutex_lock(&bfs->start_lock);
+  pthread_mutex_unlock(&bfs->start_lock);
+  if (bfs->aborted) {
+    return NULL;
+  }
+
+  while (bfs->frontier_size > 0) {
+    int next_level = bfs->current_level + 1;
+    w->local_count = 0;
+
+    // Expand: grab frontier chunks until the level is exhausted
+    while (TRUE) {
+      int start = __atomic_fetch_add(&bfs->next_chunk, BFS_CHUNK_SIZE,
+                                     __ATOMIC_RELAXED);
+      if (start >= bfs->frontier_size)
+        break;
+      int end = start + BFS_CHUNK_SIZE;
+      if (end > bfs->frontier_size)
+        end = bfs->frontier_size;
+
+      for (int i = start; i < end; i++) {
+        int u = bfs->frontier[i];
+        for (long long e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+          int v = csr->targets[e];
+          if (claim_vertex(bfs->visited, v)) {
+            bfs->level[v] = next_level;
+            if (push_local(w, v) != SUCCESS) {
+              __atomic_store_n(&bfs->status, ERR_MEMORY_ALLOCATION,
+                               __ATOMIC_RELAXED);
+            }
+          }
+        }
+      }
+    }
+    bfs->local_counts[w->id] = w->local_count;
+
+    // Merge: one thread computes offsets, then all copy in parallel
+    if (pthread_barrier_wait(&bfs->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+      int total = 0;
+      for (int t = 0; t < bfs->num_threads; t++) {
+        bfs->local_offsets[t] = total;
+        total += bfs->local_counts[t];
+      }
+      bfs->next_size = total;
+    }
+    pthread_barrier_wait(&bfs->barrier);
+
+    memcpy(bfs->next_frontier + bfs->local_offsets[w->id], w->local,
+           w->local_count * sizeof(int));
+
+    if (pthread_barrier_wait(&bfs->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+      int *tmp = bfs->frontier;
+      bfs->frontier = bfs->next_frontier;
+      bfs->next_frontier = tmp;
+      bfs->frontier_size = bfs->next_size;
+      bfs->next_chunk = 0;
+      bfs->current_level++;
+    }
+    pthread_barrier_wait(&bfs->barrier);
+  }
+
+  return NULL;
+}
+
+int claim_vertex(unsigned long long *visited, int v) {
+  unsigned long long mask = 1ULL << (v & 63);
+  unsigned long long *word = &visited[v >> 6];
+
+  // Cheap read first; only contend on the cache line when unvisited
+  if (__atomic_load_n(word, __ATOMIC_RELAXED) & mask) {
+    return FALSE;
+  }
+  return !(__atomic_fetch_or(word, mask, __ATOMIC_RELAXED) & mask);
+}
+
+Status push_local(BfsWorker *w, int v) {
+  if (w->local_count == w->local_capacity) {
+    int new_cap = w->local_capacity ? w->local_capacity * 2 : 1024;
+    int *new_local = (int *)realloc(w->local, new_cap * sizeof(int));
+    if (new_local == NULL) {
+      return ERR_MEMORY_ALLOCATION;
+    }
+    w->local = new_local;
+    w->local_capacity = new_cap;
+  }
+  w->local[w->local_count++] = v;
+  return SUCCESS;
+}
+
+Status save_csr_file(const CsrGraph *csr, const char *path) {
+  CsrFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CSR_MAGIC, sizeof(header.magic));
+  header.version = CSR_VERSION;
+  header.flags = csr->flags;
+  header.num_vertices = csr->num_vertices;
+  header.num_edges = csr->num_edges;
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return ERR_FILE_IO;
+  }
+  setvbuf(file, NULL, _IOFBF, SCAN_BUFFER_SIZE);
+
+  size_t n_offsets = (size_t)csr->num_vertices + 1;
+  size_t n_targets = (size_t)csr->num_edges;
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(csr->offsets, sizeof(long long), n_offsets, file) ==
+               n_offsets &&
+           fwrite(csr->targets, sizeof(int), n_targets, file) == n_targets;
+
+  if (fclose(file) != 0 || !ok) {
+    return ERR_FILE_IO;
+  }
+  return SUCCESS;
+}
+
+Status map_csr_file(CsrGraph *csr, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(CsrFileHeader)) {
+    close(fd);
+    return ERR_INVALID_FORMAT;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps its own reference to the file
+  if (map == MAP_FAILED) {
+    return ERR_FILE_IO;
+  }
+
+  const CsrFileHeader *header = (const CsrFileHeader *)map;
+  if (memcmp(header->magic, CSR_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != CSR_VERSION || header->num_vertices < 1 ||
+      header->num_vertices > 0x7fffffffLL || header->num_edges < 0 ||
+      header->num_edges > (long long)size) {
+    munmap(map, size);
+    return ERR_INVALID_FORMAT;
+  }
+
+  size_t expected = sizeof(CsrFileHeader) +
+                    (size_t)(header->num_vertices + 1) * sizeof(long long) +
+                    (size_t)header->num_edges * sizeof(int);
+  if (expected != size) {
+    munmap(map, size);
+    return ERR_INVALID_FORMAT;
+  }
+
+  // Point straight into the mapping: no parsing, no per-edge allocation
+  csr->mapping = map;
+  csr->mapping_size = size;
+  csr->flags = header->flags;
+  csr->num_vertices = (int)header->num_vertices;
+  csr->num_edges = header->num_edges;
+  csr->offsets = (long long *)((char *)map + sizeof(CsrFileHeader));
+  csr->targets = (int *)(csr->offsets + csr->num_vertices + 1);
+
+  if (csr->offsets[csr->num_vertices] != csr->num_edges ||
+      validate_csr(csr) != SUCCESS) {
+    free_csr(csr);
+    return ERR_INVALID_FORMAT;
+  }
+
+  posix_madvise(map, size, POSIX_MADV_WILLNEED);
+  return SUCCESS;
+}
+
+// One O(V + E) pass so a corrupt file cannot send a traversal out of bounds
+Status validate_csr(const CsrGraph *csr) {
+  const long long *offsets = csr->offsets;
+
+  if (offsets[0] != 0) {
+    return ERR_INVALID_FORMAT;
+  }
+  for (int i = 0; i < csr->num_vertices; i++) {
+    if (offsets[i + 1] < offsets[i] || offsets[i + 1] > csr->num_edges) {
+      return ERR_INVALID_FORMAT;
+    }
+  }
+  for (long long e = 0; e < csr->num_edges; e++) {
+    if (csr->targets[e] < 0 || csr->targets[e] >= csr->num_vertices) {
+      return ERR_INVALID_FORMAT;
+    }
+  }
+  return SUCCESS;
+}
+
+Status import_edge_list(const char *text_path, const char *csr_path,
+                        int undirected, CsrFileHeader *info) {
+  TextScanner sc;
+  long long u, v;
+  long long num_vertices = 0, num_edges = 0, degree_cap = 0;
+  long long *degree = NULL;
+  Status status = SUCCESS;
+
+  sc.file = fopen(text_path, "r");
+  if (sc.file == NULL) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  sc.buffer = (char *)malloc(SCAN_BUFFER_SIZE);
+  if (sc.buffer == NULL) {
+    fclose(sc.file);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  sc.length = 0;
+  sc.pos = 0;
+
+  // Pass 1: count degrees (index shifted by one for the prefix sum)
+  while (status == SUCCESS && scan_edge(&sc, &u, &v)) {
+    long long top = (u > v ? u : v) + 1;
+    if (u < 0 || v < 0 || top > 0x7fffffffLL) {
+      status = ERR_INVALID_FORMAT;
+      break;
+    }
+    if (top + 1 > degree_cap) {
+      long long new_cap = degree_cap ? degree_cap : 1024;
+      while (new_cap < top + 1)
+        new_cap *= 2;
+      long long *grown =
+          (long long *)realloc(degree, new_cap * sizeof(long long));
+      if (grown == NULL) {
+        status = ERR_MEMORY_ALLOCATION;
+        break;
+      }
+      memset(grown + degree_cap, 0,
+             (new_cap - degree_cap) * sizeof(long long));
+      degree = grown;
+      degree_cap = new_cap;
+    }
+    if (top > num_vertices)
+      num_vertices = top;
+
+    degree[u + 1]++;
+    num_edges++;
+    if (undirected) {
+      degree[v + 1]++;
+      num_edges++;
+    }
+  }
+
+  if (status == SUCCESS && num_vertices == 0) {
+    status = ERR_INVALID_FORMAT;
+  }
+  if (status != SUCCESS) {
+    free(degree);
+    free(sc.buffer);
+    fclose(sc.file);
+    return status;
+  }
+
+  // Size the output file up front and fill it through a shared mapping,
+  // so the targets array never has to live on the heap.
+  size_t offsets_bytes = (size_t)(num_vertices + 1) * sizeof(long long);
+  size_t size = sizeof(CsrFileHeader) + offsets_bytes +
+                (size_t)num_edges * sizeof(int);
+
+  int fd = open(csr_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1 || ftruncate(fd, (off_t)size) == -1) {
+    if (fd != -1)
+      close(fd);
+    free(degree);
+    free(sc.buffer);
+    fclose(sc.file);
+    return ERR_FILE_IO;
+  }
+
+  void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    free(degree);
+    free(sc.buffer);
+    fclose(sc.file);
+    return ERR_FILE_IO;
+  }
+
+  CsrFileHeader *header = (CsrFileHeader *)map;
+  long long *offsets = (long long *)((char *)map + sizeof(CsrFileHeader));
+  int *targets = (int *)(offsets + num_vertices + 1);
+
+  memset(header, 0, sizeof(CsrFileHeader));
+  memcpy(header->magic, CSR_MAGIC, sizeof(header->magic));
+  header->version = CSR_VERSION;
+  header->flags = undirected ? CSR_FLAG_SYMMETRIC : 0;
+  header->num_vertices = num_vertices;
+  header->num_edges = num_edges;
+
+  offsets[0] = 0;
+  for (long long i = 0; i < num_vertices; i++) {
+    offsets[i + 1] = offsets[i] + degree[i + 1];
+    degree[i] = offsets[i]; // reuse as the scatter cursor
+  }
+
+  // Pass 2: rescan the text and scatter targets into place
+  rewind(sc.file);
+  sc.length = 0;
+  sc.pos = 0;
+  while (scan_edge(&sc, &u, &v)) {
+    targets[degree[u]++] = (int)v;
+    if (undirected)
+      targets[degree[v]++] = (int)u;
+  }
+
+  *info = *header;
+  if (munmap(map, size) == -1) {
+    status = ERR_FILE_IO;
+  }
+  free(degree);
+  free(sc.buffer);
+  fclose(sc.file);
+  return status;
+}
+
+int scanner_peek(TextScanner *sc) {
+  if (sc->pos == sc->length) {
+    sc->length = fread(sc->buffer, 1, SCAN_BUFFER_SIZE, sc->file);
+    sc->pos = 0;
+    if (sc->length == 0)
+      return EOF;
+  }
+  return (unsigned char)sc->buffer[sc->pos];
+}
+
+/*
+ * Returns the first two numbers of the next line that has two. A line
+ * whose vertex ids are signed or larger than INT_MAX comes back as
+ * (-1, -1) so the caller can reject the file.
+ */
+int scan_edge(TextScanner *sc, long long *u, long long *v) {
+  int c;
+
+  while ((c = scanner_peek(sc)) != EOF) {
+    long long ids[2];
+    int count = 0;
+    int malformed = FALSE;
+
+    // Parse up to two numbers from the current line; ignore the rest
+    while (c != EOF && c != '\n') {
+      if (c == '#' || c == '%') {
+        break;
+      }
+      if ((c == '-' || c == '+') && count < 2) {
+        sc->pos++;
+        c = scanner_peek(sc);
+        if (c != EOF && isdigit(c)) {
+          malformed = TRUE;
+          break;
+        }
+        continue;
+      }
+      if (isdigit(c) && count < 2) {
+        long long value = 0;
+        while (c != EOF && isdigit(c) && value <= 0x7fffffffLL) {
+          value = value * 10 + (c - '0');
+          sc->pos++;
+          c = scanner_peek(sc);
+        }
+        if (value > 0x7fffffffLL) {
+          malformed = TRUE;
+          break;
+        }
+        ids[count++] = value;
+        continue;
+      }
+      if (count == 2)
+        break;
+      sc->pos++;
+      c = scanner_peek(sc);
+    }
+
+    // Skip to the end of the line (comments, weights, trailing text)
+    while (c != EOF && c != '\n') {
+      sc->pos++;
+      c = scanner_peek(sc);
+    }
+    if (c == '\n')
+      sc->pos++;
+
+    if (malformed) {
+      *u = -1;
+      *v = -1;
+      return TRUE;
+    }
+    if (count == 2) {
+      *u = ids[0];
+      *v = ids[1];
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
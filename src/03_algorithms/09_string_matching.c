@@ -9,15 +9,27 @@
  - KMP (Knuth-Morris-Pratt) optimal search O(n+m)
  - LPS (Longest Proper Prefix which is also Suffix) array construction
  - Comparison counting and execution time tracking
+ - Hardware counters (cycles, instructions, branch and cache misses)
+   via perf_event_open when the kernel allows it
  - Interactive menu for repeated searches
  ===============================================================================
 */
 
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#if defined(__linux__) && !defined(NO_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENTS 1
+#endif
+
 #define MAX_TEXT 1000
 #define MAX_PATTERN 100
 #define MIN_OPTION 1
@@ -32,10 +44,24 @@ typedef enum {
   ERR_MEMORY_ALLOCATION
 } Status;
 
+typedef enum {
+  HW_CYCLES,
+  HW_INSTRUCTIONS,
+  HW_BRANCH_MISSES,
+  HW_CACHE_MISSES,
+  HW_COUNTER_COUNT
+} HwCounterId;
+
+// Hardware counters for one measured call; -1 when not available
+typedef struct {
+  long long value[HW_COUNTER_COUNT];
+} HwCounters;
+
 typedef struct {
   int found_index;
   int comparisons;
   double time_taken;
+  HwCounters hw;
 } MatchStats;
 
 void show_menu(void);
@@ -53,9 +79,16 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats);
 void compute_lps_array(const char *pattern, int M, int *lps);
 void print_lps_array(int *lps, int M);
 void show_comparison(MatchStats bf_stats, MatchStats kmp_stats);
+void perf_counters_open(void);
+void perf_counters_start(void);
+void perf_counters_stop(HwCounters *hw);
+void print_hw_counters(const HwCounters *hw);
+
+int perf_fds[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
 
 int main(void) {
   int option = 0;
+  perf_counters_open();
 
   while (TRUE) {
     show_menu();
@@ -124,8 +157,8 @@ void run_demo_search(void) {
   printf("Text:    \"%s\"\n", text);
   printf("Pattern: \"%s\"\n", pattern);
 
-  MatchStats bf_stats = {-1, 0, 0.0};
-  MatchStats kmp_stats = {-1, 0, 0.0};
+  MatchStats bf_stats = {-1, 0, 0.0, {{0}}};
+  MatchStats kmp_stats = {-1, 0, 0.0, {{0}}};
 
   run_brute_force(text, pattern, &bf_stats);
   run_kmp(text, pattern, &kmp_stats);
@@ -153,8 +186,8 @@ void run_custom_search(void) {
   printf("Text:    \"%s\"\n", text);
   printf("Pattern: \"%s\"\n", pattern);
 
-  MatchStats bf_stats = {-1, 0, 0.0};
-  MatchStats kmp_stats = {-1, 0, 0.0};
+  MatchStats bf_stats = {-1, 0, 0.0, {{0}}};
+  MatchStats kmp_stats = {-1, 0, 0.0, {{0}}};
 
   run_brute_force(text, pattern, &bf_stats);
   run_kmp(text, pattern, &kmp_stats);
@@ -206,6 +239,7 @@ void run_brute_force(const char *text, const char *pattern, MatchStats *stats) {
   int N = strlen(text);
   int M = strlen(pattern);
 
+  perf_counters_start();
   clock_t start = clock();
 
   for (int i = 0; i <= N - M; i++) {
@@ -223,6 +257,7 @@ void run_brute_force(const char *text, const char *pattern, MatchStats *stats) {
   }
 
   clock_t end = clock();
+  perf_counters_stop(&stats->hw);
   stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
   if (stats->time_taken <= 0.0)
     stats->time_taken = 0.000001;
@@ -234,6 +269,7 @@ void run_brute_force(const char *text, const char *pattern, MatchStats *stats) {
   }
   printf("  - Comparisons: %d\n", stats->comparisons);
   printf("  - Time:        %.6f seconds\n", stats->time_taken);
+  print_hw_counters(&stats->hw);
   printf("  - Complexity:  O(n*m)\n");
 }
 
@@ -252,6 +288,7 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
   compute_lps_array(pattern, M, lps);
   print_lps_array(lps, M);
 
+  perf_counters_start();
   clock_t start = clock();
 
   int i = 0;
@@ -277,6 +314,7 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
   }
 
   clock_t end = clock();
+  perf_counters_stop(&stats->hw);
   stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
   if (stats->time_taken <= 0.0)
     stats->time_taken = 0.000001;
@@ -290,6 +328,7 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
   }
   printf("  - Comparisons: %d\n", stats->comparisons);
   printf("  - Time:        %.6f seconds\n", stats->time_taken);
+  print_hw_counters(&stats->hw);
   printf("  - Complexity:  O(n+m)\n");
 }
 
@@ -322,6 +361,83 @@ void print_lps_array(int *lps, int M) {
   printf("]\n");
 }
 
+// A counter the kernel refuses (paranoid level, VM) stays at -1
+void perf_counters_open(void) {
+#ifdef HAVE_PERF_EVENTS
+  const unsigned long long configs[HW_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+}
+
+void perf_counters_start(void) {
+#ifdef HAVE_PERF_EVENTS
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (perf_fds[i] >= 0) {
+      ioctl(perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void perf_counters_stop(HwCounters *hw) {
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    hw->value[i] = -1;
+#ifdef HAVE_PERF_EVENTS
+    unsigned long long data[3];
+    if (perf_fds[i] >= 0 &&
+        ioctl(perf_fds[i], PERF_EVENT_IOC_DISABLE, 0) == 0 &&
+        read(perf_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) &&
+        data[2] != 0) {
+      hw->value[i] = (long long)((double)data[0] * data[1] / data[2]);
+    }
+#endif
+  }
+}
+
+void print_hw_counters(const HwCounters *hw) {
+  const char *labels[HW_COUNTER_COUNT] = {"Cycles:", "Instructions:",
+                                          "Branch misses:", "Cache misses:"};
+  int available = FALSE;
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      available = TRUE;
+    }
+  }
+  if (!available) {
+    printf("  - HW counters:  N/A (perf_event_open denied)\n");
+    return;
+  }
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (hw->value[i] >= 0) {
+      printf("  - %-14s %lld\n", labels[i], hw->value[i]);
+    } else {
+      printf("  - %-14s N/A\n", labels[i]);
+    }
+  }
+  if (hw->value[HW_CYCLES] > 0 && hw->value[HW_INSTRUCTIONS] >= 0) {
+    printf("  - %-14s %.2f\n", "IPC:",
+           (double)hw->value[HW_INSTRUCTIONS] / hw->value[HW_CYCLES]);
+  }
+}
+
 void show_comparison(MatchStats bf_stats, MatchStats kmp_stats) {
   printf("\n=== Comparison ===\n");
 
@@ -7,21 +7,39 @@
  Features:
  - Operation counting and timing for multiple algorithms
  - Bubble Sort O(n²) vs Binary Search O(log n) demonstration
+ - Same O(log n), different constants: branchy vs branchless binary
+   search vs Eytzinger layout, timed over random lookups
  - ASCII bar chart for visual complexity representation
+ - Hardware counters (cycles, instructions, branch and cache misses)
+   via perf_event_open when the kernel allows it
  - Configurable array sizes for benchmarking
  - Interactive menu for repeated analysis
  ===============================================================================
 */
 
+#define _DEFAULT_SOURCE
+
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(__linux__) && !defined(NO_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENTS 1
+#endif
+
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
 #define MAX_OPTION 4
+#define LOOKUP_COUNT 200000
+#define EYTZINGER_PREFETCH 16
+#define CACHE_LINE 64
 
 typedef enum {
   SUCCESS,
@@ -30,10 +48,24 @@ typedef enum {
   ERR_MEMORY_ALLOCATION
 } Status;
 
+typedef enum {
+  HW_CYCLES,
+  HW_INSTRUCTIONS,
+  HW_BRANCH_MISSES,
+  HW_CACHE_MISSES,
+  HW_COUNTER_COUNT
+} HwCounterId;
+
+// Hardware counters for one measured call; -1 when not available
+typedef struct {
+  long long value[HW_COUNTER_COUNT];
+} HwCounters;
+
 typedef struct {
   int size;
   double time_ms;
   long long operations;
+  HwCounters hw;
 } TestResult;
 
 void show_menu(void);
@@ -47,12 +79,24 @@ Status read_integer(int *value);
 
 long long algo_bubble_sort(int *arr, int n);
 long long algo_binary_search(int *arr, int n, int target);
+long long algo_branchless_search(const int *arr, int n, int target);
+long long algo_eytzinger_search(const int *eyt, int n, int target);
+int eytzinger_fill(const int *arr, int *eyt, int n, int next, long long node);
+void print_layout_table(const int *sizes, int count);
+double get_time_ms(void);
 void print_graph(TestResult *results, int count, const char *label);
 void print_operations(long long ops);
+void print_hw_table(const TestResult *results, int count, int repeats);
+void perf_counters_open(void);
+void perf_counters_start(void);
+void perf_counters_stop(HwCounters *hw);
+
+int perf_fds[HW_COUNTER_COUNT] = {-1, -1, -1, -1};
 
 int main(void) {
   int option = 0;
   srand(time(NULL));
+  perf_counters_open();
 
   while (TRUE) {
     show_menu();
@@ -135,9 +179,11 @@ void run_bubble_sort_analysis(void) {
       arr[j] = n - j;
     }
 
+    perf_counters_start();
     clock_t start = clock();
     long long ops = algo_bubble_sort(arr, n);
     clock_t end = clock();
+    perf_counters_stop(&results[i].hw);
 
     double time_ms = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
     if (time_ms <= 0.0)
@@ -155,6 +201,7 @@ void run_bubble_sort_analysis(void) {
   }
 
   print_graph(results, num_tests, "n²");
+  print_hw_table(results, num_tests, 1);
 
   printf("\n  - Complexity Detected: O(n²)\n");
   printf("  - Growth Rate: Doubling n → 4x more operations.\n\n");
@@ -188,6 +235,15 @@ void run_binary_search_analysis(void) {
     long long ops = algo_binary_search(arr, n, target);
     clock_t end = clock();
 
+    // One search is a few dozen instructions, less than the counter
+    // syscalls themselves, so count LOOKUP_COUNT repeats instead
+    volatile long long sink = 0;
+    perf_counters_start();
+    for (int q = 0; q < LOOKUP_COUNT; q++) {
+      sink += algo_binary_search(arr, n, target);
+    }
+    perf_counters_stop(&results[i].hw);
+
     double time_ms = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
     if (time_ms <= 0.0)
       time_ms = 0.001;
@@ -201,8 +257,13 @@ void run_binary_search_analysis(void) {
     free(arr);
   }
 
+  print_hw_table(results, num_tests, LOOKUP_COUNT);
+  print_layout_table(sizes, num_tests);
+
   printf("\n  - Complexity Detected: O(log n)\n");
-  printf("  - Growth Rate: Multiplying n×10 → only ~3 more operations.\n\n");
+  printf("  - Growth Rate: Multiplying n×10 → only ~3 more operations.\n");
+  printf("  - Constants: same operation count, but mispredicted branches\n"
+         "    and cache misses make the classic loop the slowest.\n\n");
 }
 
 void run_complexity_info(void) {
@@ -215,7 +276,9 @@ void run_complexity_info(void) {
   printf("  O(n log n) | Log-Linear    | Merge Sort, Quick Sort\n");
   printf("  O(n²)      | Quadratic     | Bubble Sort\n");
   printf("  O(2ⁿ)      | Exponential   | N-Queens (brute force)\n\n");
-  printf("  Rule: For n=1000, prefer O(n log n) or better.\n\n");
+  printf("  Rule: For n=1000, prefer O(n log n) or better.\n");
+  printf("  Note: Big O hides constants; memory layout and branch\n"
+         "        prediction can change the speed of the same O(log n).\n\n");
 }
 
 void clear_input_buffer(void) {
@@ -265,6 +328,171 @@ long long algo_binary_search(int *arr, int n, int target) {
   return operations;
 }
 
+// Opened once at startup; the descriptors close when the process exits
+void perf_counters_open(void) {
+#ifdef HAVE_PERF_EVENTS
+  const unsigned long long configs[HW_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+}
+
+void perf_counters_start(void) {
+#ifdef HAVE_PERF_EVENTS
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    if (perf_fds[i] >= 0) {
+      ioctl(perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void perf_counters_stop(HwCounters *hw) {
+  for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+    hw->value[i] = -1;
+#ifdef HAVE_PERF_EVENTS
+    unsigned long long data[3];
+    if (perf_fds[i] >= 0 &&
+        ioctl(perf_fds[i], PERF_EVENT_IOC_DISABLE, 0) == 0 &&
+        read(perf_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) &&
+        data[2] != 0) {
+      hw->value[i] = (long long)((double)data[0] * data[1] / data[2]);
+    }
+#endif
+  }
+}
+
+// Halves with a conditional move instead of a branch: always ~log2(n) steps
+long long algo_branchless_search(const int *arr, int n, int target) {
+  long long operations = 0;
+  const int *base = arr;
+
+  while (n > 1) {
+    operations++;
+    int half = n / 2;
+    __builtin_prefetch(base + half / 2);
+    __builtin_prefetch(base + half + half / 2);
+    base = (base[half] < target) ? base + half : base;
+    n -= half;
+  }
+  return operations;
+}
+
+// eyt is the array in BFS order (1-indexed, children of k at 2k, 2k+1)
+long long algo_eytzinger_search(const int *eyt, int n, int target) {
+  long long operations = 0;
+  long long k = 1;
+
+  while (k <= n) {
+    operations++;
+    __builtin_prefetch(eyt + k * EYTZINGER_PREFETCH);
+    k = 2 * k + (eyt[k] < target);
+  }
+  return operations;
+}
+
+int eytzinger_fill(const int *arr, int *eyt, int n, int next, long long node) {
+  if (node <= n) {
+    next = eytzinger_fill(arr, eyt, n, next, 2 * node);
+    eyt[node] = arr[next++];
+    next = eytzinger_fill(arr, eyt, n, next, 2 * node + 1);
+  }
+  return next;
+}
+
+/*
+ * One lookup is too fast for the timer, so each variant runs the same
+ * LOOKUP_COUNT random targets and reports the average per lookup.
+ */
+void print_layout_table(const int *sizes, int count) {
+  int *targets = (int *)malloc(LOOKUP_COUNT * sizeof(int));
+  if (targets == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\nLayout Comparison (ns per lookup, %d random lookups):\n",
+         LOOKUP_COUNT);
+  printf("  %-8s | %-10s | %-10s | %s\n", "Size", "Branchy", "Branchless",
+         "Eytzinger");
+
+  for (int i = 0; i < count; i++) {
+    int n = sizes[i];
+    int *arr = (int *)malloc(n * sizeof(int));
+    // Line-aligned, so each 16-node prefetch touches a single line
+    void *block = NULL;
+    int *eyt = posix_memalign(&block, CACHE_LINE, (n + 1) * sizeof(int)) == 0
+                   ? (int *)block
+                   : NULL;
+    if (arr == NULL || eyt == NULL) {
+      free(arr);
+      free(eyt);
+      free(targets);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+
+    for (int j = 0; j < n; j++) {
+      arr[j] = j * 2;
+    }
+    eyt[0] = 0;
+    eytzinger_fill(arr, eyt, n, 0, 1);
+    for (int q = 0; q < LOOKUP_COUNT; q++) {
+      targets[q] = rand() % (2 * n);
+    }
+
+    // volatile sink keeps the compiler from dropping the unused searches
+    volatile long long sink = 0;
+    double start = get_time_ms();
+    for (int q = 0; q < LOOKUP_COUNT; q++) {
+      sink += algo_binary_search(arr, n, targets[q]);
+    }
+    double branchy = get_time_ms() - start;
+
+    start = get_time_ms();
+    for (int q = 0; q < LOOKUP_COUNT; q++) {
+      sink += algo_branchless_search(arr, n, targets[q]);
+    }
+    double branchless = get_time_ms() - start;
+
+    start = get_time_ms();
+    for (int q = 0; q < LOOKUP_COUNT; q++) {
+      sink += algo_eytzinger_search(eyt, n, targets[q]);
+    }
+    double eytzinger = get_time_ms() - start;
+
+    printf("  %-8d | %-10.1f | %-10.1f | %.1f\n", n,
+           branchy * 1e6 / LOOKUP_COUNT, branchless * 1e6 / LOOKUP_COUNT,
+           eytzinger * 1e6 / LOOKUP_COUNT);
+
+    free(arr);
+    free(eyt);
+  }
+
+  free(targets);
+}
+
+double get_time_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
 void print_graph(TestResult *results, int count, const char *label) {
   long long base = results[0].operations;
   int scale = (base > 0) ? (int)(base / 4) : 1;
@@ -293,3 +521,36 @@ void print_operations(long long ops) {
     printf("%lld", ops);
   }
 }
+
+/*
+ * Per-size counters, so growth in cache misses shows next to operations.
+ * Counts taken over `repeats` runs are shown per run.
+ */
+void print_hw_table(const TestResult *results, int count, int repeats) {
+  if (results[0].hw.value[HW_CYCLES] < 0 &&
+      results[0].hw.value[HW_INSTRUCTIONS] < 0) {
+    printf("\nHardware counters: N/A (perf_event_open denied)\n");
+    return;
+  }
+
+  if (repeats > 1) {
+    printf("\nHardware Counters (per run, average of %d):\n", repeats);
+  } else {
+    printf("\nHardware Counters:\n");
+  }
+  printf("  %-8s | %-12s | %-12s | %-5s | %-10s | %s\n", "Size", "Cycles",
+         "Instructions", "IPC", "Br. misses", "Cache misses");
+  for (int i = 0; i < count; i++) {
+    long long v[HW_COUNTER_COUNT];
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+      long long raw = results[i].hw.value[c];
+      v[c] = raw < 0 ? raw : raw / repeats;
+    }
+    double ipc = v[HW_CYCLES] > 0 && v[HW_INSTRUCTIONS] >= 0
+                     ? (double)v[HW_INSTRUCTIONS] / v[HW_CYCLES]
+                     : 0.0;
+    printf("  %-8d | %-12lld | %-12lld | %-5.2f | %-10lld | %lld\n",
+           results[i].size, v[HW_CYCLES], v[HW_INSTRUCTIONS], ipc,
+           v[HW_BRANCH_MISSES], v[HW_CACHE_MISSES]);
+  }
+}